@@ -144,8 +144,15 @@ bool_t Ds1307::init(Bus *busHandler_p)
         return false;
     }
 
-    // Update data members
-    this->_busHandler = busHandler_p;
+    // Update data members; the control register is only changed by us
+    if(!this->_registerCache.init(busHandler_p) ||
+            !this->_registerCache.setPolicy((uint8_t)(Register::CONTROL), RegisterCache::Policy::CACHED)) {
+        // Returns error
+        this->_lastError = this->_registerCache.getLastError();
+        debugMessage(this->_lastError, DEBUG_DS1307);
+        return false;
+    }
+    this->_busHandler = &this->_registerCache;
 
     // Try to checks if DS1307 is present
     // FIXME: Implmement this...
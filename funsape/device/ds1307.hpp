@@ -43,6 +43,13 @@
 #   error "Version mismatch between header file and library dependency (bus.hpp)!"
 #endif
 
+#include "../util/registerCache.hpp"
+#if !defined(__REGISTER_CACHE_HPP)
+#   error "Header file (registerCache.hpp) is corrupted!"
+#elif __REGISTER_CACHE_HPP != __DS1307_HPP
+#   error "Version mismatch between header file and library dependency (registerCache.hpp)!"
+#endif
+
 #include "../util/dateTime.hpp"
 #if !defined(__DATETIME_HPP)
 #   error "Header file (dateTime.hpp) is corrupted!"
@@ -401,6 +408,7 @@ public:
 private:
     //     ////////////////    PERIPHERAL BUS HANDLER     ////////////////     //
     Bus             *_busHandler;
+    RegisterCache   _registerCache;
 
     //     /////////////////     CONTROL AND STATUS     /////////////////     //
     bool_t          _countingHalted         : 1;
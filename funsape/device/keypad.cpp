@@ -70,6 +70,9 @@ Keypad::Keypad(void)
     this->_isInitialized                = false;
     this->_debounceTime                 = constDefaultDebounceTime;
     this->_keyValue                     = nullptr;
+    this->_scanSample                   = 0xFF;
+    this->_scanKey                      = 0xFF;
+    this->_scanTime                     = 0;
 
     // Returns successfully
     this->_lastError = Error::NONE;
@@ -317,6 +320,58 @@ bool_t Keypad::readKeyPressed(uint8_t *keyPressedValue_p)
     return true;
 }
 
+bool_t Keypad::scanKeyPressed(uint8_t *keyPressedValue_p, uint8_t *keyHeldValue_p)
+{
+    // Local variables
+    uint8_t auxKey = 0xFF;
+    uint8_t auxPressed = 0xFF;
+
+    // Checks for errors
+    if(!this->_isInitialized) {
+        this->_lastError = Error::NOT_INITIALIZED;
+        debugMessage(Error::NOT_INITIALIZED, DEBUG_KEYPAD);
+        return false;
+    }
+    if(!isPointerValid(keyPressedValue_p)) {
+        this->_lastError = Error::ARGUMENT_POINTER_NULL;
+        debugMessage(Error::ARGUMENT_POINTER_NULL, DEBUG_KEYPAD);
+        return false;
+    }
+
+    for(uint8_t i = 0; i <= this->_columnsMax; i++) {                   // For each column
+        clrBit(*(this->_columnsPort), (i + this->_columnsFirst));       // Clear one column
+        __builtin_avr_delay_cycles(5);                                  // Wait for syncronization
+        uint8_t aux8 = *(this->_linesPin) >> this->_linesFirst;
+        for(uint8_t j = 0; j <= this->_linesMax; j++) {                         // For each line
+            if(isBitClr(aux8, j) && (auxKey == 0xFF)) {                 // Tests if the key is pressed
+                auxKey = this->_keyValue[((this->_linesMax + 1) * j) + i];      // Decodes the key using the table
+            }
+        }
+        setBit(*(this->_columnsPort), (i + this->_columnsFirst));       // Restore column value
+    }
+
+    // Debounce - the sample must hold for the debounce time
+    if(auxKey != this->_scanSample) {
+        this->_scanSample = auxKey;
+        this->_scanTime = systemTick.getMilliseconds();
+    } else if((auxKey != this->_scanKey) &&
+                    (systemTick.getElapsedMilliseconds(this->_scanTime) >= this->_debounceTime)) {
+        this->_scanKey = auxKey;
+        auxPressed = auxKey;                                            // Reported on the press only
+    }
+
+    // Update function arguments
+    *keyPressedValue_p = auxPressed;
+    if(isPointerValid(keyHeldValue_p)) {
+        *keyHeldValue_p = this->_scanKey;
+    }
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_KEYPAD);
+    return true;
+}
+
 // =============================================================================
 // Class private methods
 // =============================================================================
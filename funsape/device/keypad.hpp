@@ -37,6 +37,13 @@
 #   error "Version mismatch between header file and library dependency (debug.hpp)!"
 #endif
 
+#include "../util/systemTick.hpp"
+#if !defined(__SYSTEM_TICK_HPP)
+#   error "Header file (systemTick.hpp) is corrupted!"
+#elif __SYSTEM_TICK_HPP != __KEYPAD_HPP
+#   error "Version mismatch between header file and library dependency (systemTick.hpp)!"
+#endif
+
 //     ///////////////////     STANDARD C LIBRARY     ///////////////////     //
 #include <stdarg.h>
 #include <stdlib.h>
@@ -175,6 +182,23 @@ public:
             uint8_t *keyPressedValue_p
     );
 
+    //!
+    //! \brief      Scans the keypad without waiting
+    //! \details    This function samples the keypad once and returns at
+    //!                 once, so it can be called from the main loop on every
+    //!                 pass. A key must read the same for the debounce time,
+    //!                 measured on the system timebase, to be accepted; the
+    //!                 key is then reported once, on the press. The system
+    //!                 timebase must be running.
+    //! \param      keyPressedValue_p   Pointer to store the key just pressed (0xFF if none)
+    //! \param      keyHeldValue_p      Pointer to store the key held down (0xFF if none), or nullptr
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t scanKeyPressed(
+            uint8_t *keyPressedValue_p,
+            uint8_t *keyHeldValue_p = nullptr
+    );
+
     // -------------------------------------------------------------------------
     // Properties --------------------------------------------------------------
 private:
@@ -191,8 +215,11 @@ private:
     bool_t                              _isPortsSet     : 1;
     bool_t                              _isKeyValuesSet : 1;
     bool_t                              _isInitialized  : 1;
-    bool_t                              _debounceTime   : 7;
+    uint8_t                             _debounceTime   : 7;
     uint8_t                             *_keyValue;
+    uint8_t                             _scanSample;
+    uint8_t                             _scanKey;
+    uint32_t                            _scanTime;
     Error                               _lastError;
 }; // class Keypad
 
@@ -0,0 +1,423 @@
+//!
+//! \file           mpu9250.cpp
+//! \brief          MPU-9250 module interface for the FunSAPE AVR8 Library
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        MPU-9250 inertial measurement unit interface
+//!
+
+// =============================================================================
+// System file dependencies
+// =============================================================================
+
+#include "mpu9250.hpp"
+#if !defined(__MPU9250_HPP)
+#    error "Header file is corrupted!"
+#elif __MPU9250_HPP != 2304
+#    error "Version mismatch between source and header files!"
+#endif
+
+// =============================================================================
+// File exclusive - Constants
+// =============================================================================
+
+#define DEBUG_MPU9250                   0x25FF
+
+cuint8_t mpu9250DeviceAddress           = 0x68;     //!< Device address (AD0 low)
+cuint8_t mpu9250AlternateAddress        = 0x69;     //!< Device address (AD0 high)
+cuint8_t mpu9250WhoAmI                  = 0x71;     //!< MPU-9250 identification
+cuint8_t mpu9255WhoAmI                  = 0x73;     //!< MPU-9255 identification
+cuint8_t mpu9250ClockAutoSelect         = 0x01;     //!< PWR_MGMT_1: awake, best clock source
+
+// =============================================================================
+// File exclusive - New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// File exclusive - Global variables
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// File exclusive - Macro-functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Class constructors
+// =============================================================================
+
+Mpu9250::Mpu9250(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("Mpu9250::Mpu9250(void)", DEBUG_MPU9250);
+
+    // Resets data members
+    this->_clearData();
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MPU9250);
+    return;
+}
+
+Mpu9250::~Mpu9250(void)
+{
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_MPU9250);
+    return;
+}
+
+// =============================================================================
+// Class public methods
+// =============================================================================
+
+bool_t Mpu9250::init(Bus *busHandler_p, cbool_t alternateAddress_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("Mpu9250::init(Bus *, cbool_t)", DEBUG_MPU9250);
+
+    // Local variables
+    uint8_t auxBuffer;
+
+    // Resets data members
+    this->_clearData();
+
+    // Check function arguments for errors
+    if(!isPointerValid(busHandler_p)) {
+        // Returns error
+        this->_lastError = Error::BUS_HANDLER_POINTER_NULL;
+        debugMessage(Error::BUS_HANDLER_POINTER_NULL, DEBUG_MPU9250);
+        return false;
+    } else if(busHandler_p->getBusType() != Bus::BusType::TWI) {
+        // Returns error
+        this->_lastError = Error::BUS_HANDLER_NOT_SUPPORTED;
+        debugMessage(Error::BUS_HANDLER_NOT_SUPPORTED, DEBUG_MPU9250);
+        return false;
+    }
+
+    // Update data members; configuration registers are only changed by us
+    if(!this->_registerCache.init(busHandler_p) ||
+            !this->_registerCache.setPolicy((uint8_t)(Register::WHO_AM_I), RegisterCache::Policy::CACHED) ||
+            !this->_registerCache.setPolicy((uint8_t)(Register::PWR_MGMT_1), RegisterCache::Policy::CACHED) ||
+            !this->_registerCache.setPolicy((uint8_t)(Register::ACCEL_CONFIG), RegisterCache::Policy::CACHED) ||
+            !this->_registerCache.setPolicy((uint8_t)(Register::GYRO_CONFIG), RegisterCache::Policy::CACHED)) {
+        // Returns error
+        this->_lastError = this->_registerCache.getLastError();
+        debugMessage(this->_lastError, DEBUG_MPU9250);
+        return false;
+    }
+    this->_busHandler = &this->_registerCache;
+    this->_deviceAddress = (alternateAddress_p) ? mpu9250AlternateAddress : mpu9250DeviceAddress;
+
+    // Checks device identification
+    if(!this->_busHandler->setDevice(this->_deviceAddress)) {
+        // Returns error
+        this->_lastError = this->_busHandler->getLastError();
+        debugMessage(this->_lastError, DEBUG_MPU9250);
+        return false;
+    }
+    if(!this->_busHandler->readReg((uint8_t)(Register::WHO_AM_I), &auxBuffer, 1)) {
+        // Returns error
+        this->_lastError = this->_busHandler->getLastError();
+        debugMessage(this->_lastError, DEBUG_MPU9250);
+        return false;
+    }
+    if((auxBuffer != mpu9250WhoAmI) && (auxBuffer != mpu9255WhoAmI)) {
+        // Returns error
+        this->_lastError = Error::DEVICE_ID_MATCH_FAILED;
+        debugMessage(Error::DEVICE_ID_MATCH_FAILED, DEBUG_MPU9250);
+        return false;
+    }
+
+    // Wakes the device up
+    if(!this->_writeRegister(Register::PWR_MGMT_1, mpu9250ClockAutoSelect)) {
+        // Returns error
+        debugMessage(this->_lastError, DEBUG_MPU9250);
+        return false;
+    }
+
+    // Mark device as initialized
+    this->_initialized = true;
+
+    // Configures full scale ranges
+    if(!this->setAccelRange(AccelRange::RANGE_2_G)) {
+        // Returns error
+        this->_initialized = false;
+        debugMessage(this->_lastError, DEBUG_MPU9250);
+        return false;
+    }
+    if(!this->setGyroRange(GyroRange::RANGE_250_DPS)) {
+        // Returns error
+        this->_initialized = false;
+        debugMessage(this->_lastError, DEBUG_MPU9250);
+        return false;
+    }
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MPU9250);
+    return true;
+}
+
+bool_t Mpu9250::setAccelRange(const AccelRange range_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("Mpu9250::setAccelRange(const AccelRange)", DEBUG_MPU9250);
+
+    // Checks initialization
+    if(!this->_isInitialized()) {
+        // Returns error
+        debugMessage(this->_lastError, DEBUG_MPU9250);
+        return false;
+    }
+
+    // Sends data to device
+    if(!this->_writeRegister(Register::ACCEL_CONFIG, ((uint8_t)range_p) << 3)) {
+        // Returns error
+        debugMessage(this->_lastError, DEBUG_MPU9250);
+        return false;
+    }
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MPU9250);
+    return true;
+}
+
+bool_t Mpu9250::setGyroRange(const GyroRange range_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("Mpu9250::setGyroRange(const GyroRange)", DEBUG_MPU9250);
+
+    // Checks initialization
+    if(!this->_isInitialized()) {
+        // Returns error
+        debugMessage(this->_lastError, DEBUG_MPU9250);
+        return false;
+    }
+
+    // Sends data to device
+    if(!this->_writeRegister(Register::GYRO_CONFIG, ((uint8_t)range_p) << 3)) {
+        // Returns error
+        debugMessage(this->_lastError, DEBUG_MPU9250);
+        return false;
+    }
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MPU9250);
+    return true;
+}
+
+Error Mpu9250::getLastError(void)
+{
+    // Returns last error
+    return this->_lastError;
+}
+
+bool_t Mpu9250::startRead(cbool_t readGyro_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("Mpu9250::startRead(cbool_t)", DEBUG_MPU9250);
+
+    // Checks initialization
+    if(!this->_isInitialized()) {
+        // Returns error
+        debugMessage(this->_lastError, DEBUG_MPU9250);
+        return false;
+    }
+    if(this->_isReading) {
+        // Returns error
+        this->_lastError = Error::BUSY;
+        debugMessage(Error::BUSY, DEBUG_MPU9250);
+        return false;
+    }
+
+    // Starts burst read
+    if(!this->_busHandler->setDevice(this->_deviceAddress)) {
+        // Returns error
+        this->_lastError = this->_busHandler->getLastError();
+        debugMessage(this->_lastError, DEBUG_MPU9250);
+        return false;
+    }
+    if(!this->_busHandler->readRegAsync((uint8_t)(Register::ACCEL_XOUT_H), this->_rawData, (readGyro_p) ? 14 : 6)) {
+        // Returns error
+        this->_lastError = this->_busHandler->getLastError();
+        debugMessage(this->_lastError, DEBUG_MPU9250);
+        return false;
+    }
+    this->_readGyro = readGyro_p;
+    this->_isReading = true;
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MPU9250);
+    return true;
+}
+
+bool_t Mpu9250::process(void)
+{
+    // Checks if a read is over
+    if(!this->_isReading || this->_busHandler->isBusy()) {
+        return false;
+    }
+    this->_isReading = false;
+    if(this->_busHandler->getLastError() != Error::NONE) {
+        // Returns error
+        this->_lastError = this->_busHandler->getLastError();
+        debugMessage(this->_lastError, DEBUG_MPU9250);
+        return false;
+    }
+
+    // Decodes samples (big-endian)
+    for(uint8_t i = 0; i < 3; i++) {
+        this->_accel[i] = (int16_t)(((uint16_t)this->_rawData[2 * i] << 8) | this->_rawData[2 * i + 1]);
+    }
+    if(this->_readGyro) {
+        this->_temperature = (int16_t)(((uint16_t)this->_rawData[6] << 8) | this->_rawData[7]);
+        for(uint8_t i = 0; i < 3; i++) {
+            this->_gyro[i] = (int16_t)(((uint16_t)this->_rawData[2 * i + 8] << 8) | this->_rawData[2 * i + 9]);
+        }
+    }
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    return true;
+}
+
+void Mpu9250::getAccel(int16_t *x_p, int16_t *y_p, int16_t *z_p)
+{
+    // Returns values
+    if(isPointerValid(x_p)) {
+        *x_p = this->_accel[0];
+    }
+    if(isPointerValid(y_p)) {
+        *y_p = this->_accel[1];
+    }
+    if(isPointerValid(z_p)) {
+        *z_p = this->_accel[2];
+    }
+    return;
+}
+
+void Mpu9250::getGyro(int16_t *x_p, int16_t *y_p, int16_t *z_p)
+{
+    // Returns values
+    if(isPointerValid(x_p)) {
+        *x_p = this->_gyro[0];
+    }
+    if(isPointerValid(y_p)) {
+        *y_p = this->_gyro[1];
+    }
+    if(isPointerValid(z_p)) {
+        *z_p = this->_gyro[2];
+    }
+    return;
+}
+
+int16_t Mpu9250::getTemperature(void)
+{
+    // Returns value
+    return this->_temperature;
+}
+
+// =============================================================================
+// Class private methods
+// =============================================================================
+
+void Mpu9250::_clearData(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("Mpu9250::_clearData(void)", DEBUG_MPU9250);
+
+    //     ////////////////    PERIPHERAL BUS HANDLER     ////////////////     //
+    this->_busHandler                   = nullptr;
+    this->_deviceAddress                = mpu9250DeviceAddress;
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+    this->_initialized                  = false;
+    this->_isReading                    = false;
+    this->_readGyro                     = false;
+    //     ///////////////////     DATA ACQUISITION     /////////////////     //
+    for(uint8_t i = 0; i < 3; i++) {
+        this->_accel[i]                 = 0;
+        this->_gyro[i]                  = 0;
+    }
+    this->_temperature                  = 0;
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MPU9250);
+    return;
+}
+
+bool_t Mpu9250::_isInitialized(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("Mpu9250::_isInitialized(void)", DEBUG_MPU9250);
+
+    // CHECK FOR ERROR - peripheral not initialized
+    if(!this->_initialized) {
+        // Returns error
+        this->_lastError = Error::NOT_INITIALIZED;
+        debugMessage(Error::NOT_INITIALIZED, DEBUG_MPU9250);
+        return false;
+    }
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MPU9250);
+    return true;
+}
+
+bool_t Mpu9250::_writeRegister(const Register register_p, cuint8_t value_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("Mpu9250::_writeRegister(const Register, cuint8_t)", DEBUG_MPU9250);
+
+    // Sends data to device
+    if(!this->_busHandler->setDevice(this->_deviceAddress)) {
+        // Returns error
+        this->_lastError = this->_busHandler->getLastError();
+        debugMessage(this->_lastError, DEBUG_MPU9250);
+        return false;
+    }
+    if(!this->_busHandler->writeReg((uint8_t)register_p, &value_p, 1)) {
+        // Returns error
+        this->_lastError = this->_busHandler->getLastError();
+        debugMessage(this->_lastError, DEBUG_MPU9250);
+        return false;
+    }
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MPU9250);
+    return true;
+}
+
+// =============================================================================
+// Class protected methods
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// General public functions definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
@@ -0,0 +1,361 @@
+//!
+//! \file           mpu9250.hpp
+//! \brief          MPU-9250 module interface for the FunSAPE AVR8 Library
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        MPU-9250 inertial measurement unit interface. The
+//!                     accelerometer (and optionally the temperature sensor
+//!                     and the gyroscope) are read in a single burst, in
+//!                     background, and delivered as full 16-bit samples.
+//!
+
+// =============================================================================
+// Include guard (START)
+// =============================================================================
+
+#ifndef __MPU9250_HPP
+#define __MPU9250_HPP                           2304
+
+// =============================================================================
+// Dependencies
+// =============================================================================
+
+//     /////////////////     GLOBAL DEFINITIONS FILE    /////////////////     //
+#include "../globalDefines.hpp"
+#if !defined(__GLOBAL_DEFINES_HPP)
+#   error "Global definitions file is corrupted!"
+#elif __GLOBAL_DEFINES_HPP != __MPU9250_HPP
+#   error "Version mismatch between file header and global definitions file!"
+#endif
+
+//     //////////////////     LIBRARY DEPENDENCIES     //////////////////     //
+#include "../util/debug.hpp"
+#if !defined(__DEBUG_HPP)
+#   error "Header file (debug.hpp) is corrupted!"
+#elif __DEBUG_HPP != __MPU9250_HPP
+#   error "Version mismatch between header file and library dependency (debug.hpp)!"
+#endif
+
+#include "../util/bus.hpp"
+#if !defined(__BUS_HPP)
+#   error "Header file (bus.hpp) is corrupted!"
+#elif __BUS_HPP != __MPU9250_HPP
+#   error "Version mismatch between header file and library dependency (bus.hpp)!"
+#endif
+
+#include "../util/registerCache.hpp"
+#if !defined(__REGISTER_CACHE_HPP)
+#   error "Header file (registerCache.hpp) is corrupted!"
+#elif __REGISTER_CACHE_HPP != __MPU9250_HPP
+#   error "Version mismatch between header file and library dependency (registerCache.hpp)!"
+#endif
+
+//     ///////////////////     STANDARD C LIBRARY     ///////////////////     //
+// NONE
+
+//     ////////////////////    AVR LIBRARY FILES     ////////////////////     //
+// NONE
+
+// =============================================================================
+// Undefining previous definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Constant definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Public functions declarations
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Mpu9250 Class
+// =============================================================================
+
+//!
+//! \brief          Mpu9250 class
+//! \details        The bus handler must support asynchronous reads. A read is
+//!                     started by startRead() and completed by process(),
+//!                     which must be called periodically from the main loop;
+//!                     the main loop never waits for the sensor.
+//!
+class Mpu9250
+{
+    // -------------------------------------------------------------------------
+    // New data types ----------------------------------------------------------
+public:
+
+    //     ////////////////     ACCELEROMETER RANGE     /////////////////     //
+    //!
+    //! \brief      Accelerometer full scale range
+    //! \details    Accelerometer full scale range.
+    //!
+    enum class AccelRange {
+        RANGE_2_G                       = 0,    //!< +-2 g (16384 LSB/g)
+        RANGE_4_G                       = 1,    //!< +-4 g (8192 LSB/g)
+        RANGE_8_G                       = 2,    //!< +-8 g (4096 LSB/g)
+        RANGE_16_G                      = 3     //!< +-16 g (2048 LSB/g)
+    };
+
+    //     //////////////////     GYROSCOPE RANGE     ///////////////////     //
+    //!
+    //! \brief      Gyroscope full scale range
+    //! \details    Gyroscope full scale range.
+    //!
+    enum class GyroRange {
+        RANGE_250_DPS                   = 0,    //!< +-250 degrees/s (131 LSB/(degrees/s))
+        RANGE_500_DPS                   = 1,    //!< +-500 degrees/s (65.5 LSB/(degrees/s))
+        RANGE_1000_DPS                  = 2,    //!< +-1000 degrees/s (32.8 LSB/(degrees/s))
+        RANGE_2000_DPS                  = 3     //!< +-2000 degrees/s (16.4 LSB/(degrees/s))
+    };
+
+private:
+    //!
+    //! \brief      Device registers
+    //! \details    Device registers.
+    //!
+    enum class Register {
+        GYRO_CONFIG                     = 0x1B,
+        ACCEL_CONFIG                    = 0x1C,
+        ACCEL_XOUT_H                    = 0x3B,
+        PWR_MGMT_1                      = 0x6B,
+        WHO_AM_I                        = 0x75,
+    };
+
+    // -------------------------------------------------------------------------
+    // Constructors ------------------------------------------------------------
+public:
+
+    //!
+    //! \brief      Mpu9250 class constructor
+    //! \details    Creates a Mpu9250 object.
+    //!
+    Mpu9250(
+            void
+    );
+
+    //!
+    //! \brief      Mpu9250 class destructor
+    //! \details    Destroys a Mpu9250 object.
+    //!
+    ~Mpu9250(
+            void
+    );
+
+    // -------------------------------------------------------------------------
+    // Methods - Inherited methods ---------------------------------------------
+
+public:
+    // NONE
+
+private:
+    // NONE
+
+protected:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Methods - Class own methods ---------------------------------------------
+
+public:
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+    //!
+    //! \brief      Initializes the device.
+    //! \details    Checks the device identification, wakes the device up and
+    //!                 configures the full scale ranges. This function blocks
+    //!                 until the configuration is done.
+    //! \param[in]  busHandler_p        pointer to the \ref{Bus} handler object
+    //! \param[in]  alternateAddress_p  use the alternate device address (AD0
+    //!                                     pin tied high)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t init(
+            Bus *busHandler_p,
+            cbool_t alternateAddress_p = false
+    );
+
+    //!
+    //! \brief      Sets the accelerometer full scale range.
+    //! \details    Sets the accelerometer full scale range. This function
+    //!                 blocks until the configuration is done.
+    //! \param[in]  range_p             full scale range
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t setAccelRange(
+            const AccelRange range_p
+    );
+
+    //!
+    //! \brief      Sets the gyroscope full scale range.
+    //! \details    Sets the gyroscope full scale range. This function blocks
+    //!                 until the configuration is done.
+    //! \param[in]  range_p             full scale range
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t setGyroRange(
+            const GyroRange range_p
+    );
+
+    //!
+    //! \brief      Returns the last error.
+    //! \details    Returns the last error.
+    //! \return     Error               Error status of the last operation
+    //!
+    Error getLastError(
+            void
+    );
+
+    //     ///////////////////     DATA ACQUISITION     /////////////////     //
+    //!
+    //! \brief      Starts reading a sample.
+    //! \details    Starts a burst read of the accelerometer registers (6
+    //!                 bytes), or of the accelerometer, temperature and
+    //!                 gyroscope registers (14 bytes), and returns
+    //!                 immediately.
+    //! \param[in]  readGyro_p          also read temperature and gyroscope
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t startRead(
+            cbool_t readGyro_p = false
+    );
+
+    //!
+    //! \brief      Completes the sample read.
+    //! \details    Checks if the read started by \ref{startRead} is over and,
+    //!                 if so, updates the samples.
+    //! \return     bool_t              True if new samples are available /
+    //!                                     False otherwise
+    //!
+    bool_t process(
+            void
+    );
+
+    //!
+    //! \brief      Checks if a read is in progress.
+    //! \details    Checks if a read is in progress.
+    //! \return     bool_t              True if busy / False otherwise
+    //!
+    bool_t inlined isBusy(
+            void
+    );
+
+    //!
+    //! \brief      Returns the last accelerometer sample.
+    //! \details    Returns the last accelerometer sample, in LSB.
+    //! \param[out] x_p                 pointer to the X axis value
+    //! \param[out] y_p                 pointer to the Y axis value
+    //! \param[out] z_p                 pointer to the Z axis value
+    //!
+    void getAccel(
+            int16_t *x_p,
+            int16_t *y_p,
+            int16_t *z_p
+    );
+
+    //!
+    //! \brief      Returns the last gyroscope sample.
+    //! \details    Returns the last gyroscope sample, in LSB.
+    //! \param[out] x_p                 pointer to the X axis value
+    //! \param[out] y_p                 pointer to the Y axis value
+    //! \param[out] z_p                 pointer to the Z axis value
+    //!
+    void getGyro(
+            int16_t *x_p,
+            int16_t *y_p,
+            int16_t *z_p
+    );
+
+    //!
+    //! \brief      Returns the last temperature sample.
+    //! \details    Returns the last temperature sample, in LSB. The
+    //!                 temperature, in Celsius degrees, is
+    //!                 (value / 333.87) + 21.
+    //! \return     int16_t             Temperature
+    //!
+    int16_t getTemperature(
+            void
+    );
+
+private:
+    void _clearData(
+            void
+    );
+    bool_t _isInitialized(
+            void
+    );
+    bool_t _writeRegister(
+            const Register register_p,
+            cuint8_t value_p
+    );
+
+    // -------------------------------------------------------------------------
+    // Properties --------------------------------------------------------------
+public:
+    // NONE
+
+private:
+    //     ////////////////    PERIPHERAL BUS HANDLER     ////////////////     //
+    Bus             *_busHandler;
+    RegisterCache   _registerCache;
+    uint8_t         _deviceAddress;
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+    bool_t          _initialized            : 1;
+    bool_t          _isReading              : 1;
+    bool_t          _readGyro               : 1;
+    Error           _lastError;
+
+    //     ///////////////////     DATA ACQUISITION     /////////////////     //
+    uint8_t         _rawData[14];
+    int16_t         _accel[3];
+    int16_t         _temperature;
+    int16_t         _gyro[3];
+
+protected:
+    // NONE
+
+}; // class Mpu9250
+
+// =============================================================================
+// Inlined class functions
+// =============================================================================
+
+bool_t inlined Mpu9250::isBusy(void)
+{
+    return this->_isReading;
+}
+
+// =============================================================================
+// External global variables
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Include guard (END)
+// =============================================================================
+
+#endif  // __MPU9250_HPP
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
@@ -214,14 +214,14 @@ enum class Error : cuint16_t {
     NOT_IMPLEMENTED                                     = 0x0002,   // Not implemented yet
     UNDER_DEVELOPMENT                                   = 0x0003,   // This part of the code is still under development
     NOT_INITIALIZED                                     = 0x0004,   // Not initialized
-    // BUSY                                                = 0x0005,   // TODO: Describe parameter
+    BUSY                                                = 0x0005,   // Resource is busy with a previous operation
     // DEVICE_NOT_SUPPORTED                                = 0x0006,   // Device is not currently supported
     FEATURE_NOT_SUPPORTED                               = 0x0007,   // Unsupported feature or configuration
-    // FUNCTION_POINTER_NULL                               = 0x0008,   // TODO: Describe parameter
+    FUNCTION_POINTER_NULL                               = 0x0008,   // NULL function pointer was passed as an argument to function
     // INSTANCE_INVALID                                    = 0x0009,   // Invalid instance
     // LOCKED                                              = 0x000A,   // Accessed a locked device
     MEMORY_ALLOCATION                                   = 0x000B,   // Memory allocation failed
-    // MODE_NOT_SUPPORTED                                  = 0x000C,   // Mode is not currently supported
+    MODE_NOT_SUPPORTED                                  = 0x000C,   // Mode is not currently supported
     // NOT_READY                                           = 0x000D,   // TODO: Describe parameter
     // READ_PROTECTED                                      = 0x000E,   // Tried to read a read protected device
     // WRITE_PROTECTED                                     = 0x000F,   // Tried to write a write protected device
@@ -245,10 +245,10 @@ enum class Error : cuint16_t {
     // ARGUMENT_GENERIC_ERROR                              = 0x001F,   // Generic error (use only on temporary basis)
 
     // Buffer related error codes
-    // BUFFER_EMPTY                                        = 0x0020,   // Buffer is empty
+    BUFFER_EMPTY                                        = 0x0020,   // Buffer is empty
     // BUFFER_FULL                                         = 0x0021,   // Buffer is full
     // BUFFER_NOT_ENOUGH_ELEMENTS                          = 0x0022,   // Not enough space in buffer to perform operation
-    // BUFFER_NOT_ENOUGH_SPACE                             = 0x0023,   // Not enough space in buffer to perform operation
+    BUFFER_NOT_ENOUGH_SPACE                             = 0x0023,   // Not enough space in buffer to perform operation
     // BUFFER_POINTER_NULL                                 = 0x0024,   // Buffer size was set to zero
     BUFFER_SIZE_TOO_LARGE                               = 0x0025,   // Buffer size was set to a large value
     BUFFER_SIZE_TOO_SMALL                               = 0x0026,   // Buffer size was set to a very small value
@@ -517,11 +517,11 @@ enum class Error : cuint16_t {
     // Uncategorized error codes
     // LCD_OUT_OF_BOUNDARIES                               = 0xFFF1,   // TODO: Describe parameter
     // CONTROLLER_NOT_SUPPORTED                            = 0xFFF2,   // Unsupported controller
-    // DEVICE_ID_MATCH_FAILED                              = 0xFFF3,   // Device ID doesn't match
+    DEVICE_ID_MATCH_FAILED                              = 0xFFF3,   // Device ID doesn't match
     // DMA_NOT_SUPPORTED                                   = 0xFFF4,   // DMA interface mode is not supported for this module
     // DMA_TRANSFER_ERROR                                  = 0xFFF5,   // DMA transfer error
     // MESSAGE_TOO_LONG                                    = 0xFFF6,   // Message is to long to be stored inside buffer
-    // VALID_DATA_NOT_AVAILABLE                            = 0xFFF7,   // Valid data was unavailable
+    VALID_DATA_NOT_AVAILABLE                            = 0xFFF7,   // Valid data was unavailable
     // PERIPHERAL_NOT_READY                                = 0xFFF8,   // TODO: Describe parameter
     // STOPWATCH_NOT_STARTED                               = 0xFFF9,   // TODO: Describe parameter
     // UNCATEGORIZED_GENERIC_ERROR_10                      = 0xFFFA,   // Generic error (use only on temporary basis)
@@ -804,11 +804,15 @@ void inlined systemHalt(void (*function_p)(void))
 #define delayMs(time_p)                 _delay_ms(time_p)
 #define delayUs(time_p)                 _delay_us(time_p)
 
-weakened uint32_t getTick(void)
-{
-    // TODO
-    return 0;
-}
+//!
+//! \brief          Returns the system tick
+//! \details        Returns the milliseconds elapsed since the system tick was
+//!                     started (see systemTick.hpp). The value wraps around
+//!                     every 49.7 days. It is a weak function that can be
+//!                     overwritten by the user.
+//! \return         uint32_t                Milliseconds
+//!
+uint32_t getTick(void);
 
 // =============================================================================
 // Includes Low Level Abstraction Layer
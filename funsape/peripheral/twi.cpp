@@ -28,9 +28,10 @@
 #define DEBUG_TWI                       0x1F1F
 #define TWI_MAX_BIT_RATE                400000UL
 #define TWI_MIN_BIT_RATE                1000UL
-#define TWI_MIN_BUFFER_SIZE             10
-#define TWI_MAX_BUFFER_SIZE             100
 #define TWI_DEFAULT_TIME_OUT            20
+#define TWI_RECOVERY_CLOCKS             9
+#define TWI_RECOVERY_HALF_PERIOD        5       // SCL half period, in us
+#define TWI_POLL_LIMIT                  50000
 
 // =============================================================================
 // File exclusive - New data types
@@ -48,7 +49,7 @@ Twi twi;
 // File exclusive - Macro-functions
 // =============================================================================
 
-// NONE
+#define countEvent(counter)             do { if((counter) != 0xFFFF) { (counter)++; } } while(0)
 
 // =============================================================================
 // Class constructors
@@ -57,10 +58,22 @@ Twi twi;
 Twi::Twi(void)
 {
     // Reset data members
-    this->_bufferData = nullptr;
-    this->_bufferIndex = 0;
-    this->_bufferLength = 0;
-    this->_bufferMaxSize = 0;
+    this->_asyncTransaction.callback = nullptr;
+    this->_asyncTransaction.status = Status::IDLE;
+    this->_queueHead = 0;
+    this->_queueTail = 0;
+    this->_current = nullptr;
+    this->_dataIndex = 0;
+    this->_readPhase = false;
+    this->_slaveRegisters = nullptr;
+    this->_slaveSize = 0;
+    this->_listenControl = 0;
+    this->_slaveActive = false;
+    this->_slaveMark = 0;
+    this->_recoveryCount = 0;
+    for(uint8_t i = 0; i < TWI_STATISTICS_SIZE; i++) {
+        this->_statistics[i].address = 0;
+    }
     this->_initialized = false;
     this->_lastTransOk = false;
     this->_timeout = TWI_DEFAULT_TIME_OUT;
@@ -122,6 +135,43 @@ bool_t Twi::writeReg(cuint8_t reg_p, cuint8_t *buffData_p, cuint16_t buffSize_p)
     return true;
 }
 
+bool_t Twi::readRegAsync(cuint8_t reg_p, uint8_t *buffData_p, cuint16_t buffSize_p)
+{
+    // Check for errors - NOT Initialized
+    if(!this->_initialized) {
+        this->_lastError = Error::NOT_INITIALIZED;
+        return false;
+    }
+    if(!this->_devAddressSet) {
+        // Error - Device address not set
+        this->_lastError = Error::COMMUNICATION_NO_DEVICE_SELECTED;
+        return false;
+    }
+    // Check for errors - Message pointer and size
+    if(buffData_p == NULL) {
+        this->_lastError = Error::ARGUMENT_POINTER_NULL;
+        return false;
+    }
+    if(buffSize_p == 0) {
+        this->_lastError = Error::ARGUMENT_CANNOT_BE_ZERO;
+        return false;
+    }
+    // Check for errors - Previous read in progress
+    if((this->_asyncTransaction.status == Status::QUEUED) || (this->_asyncTransaction.status == Status::BUSY)) {
+        this->_lastError = Error::BUSY;
+        return false;
+    }
+
+    // Queue the read; other transactions may run before it
+    // FIXME - implement support to 10-bit address
+    this->_asyncTransaction.address = (uint8_t)this->_devAddress;
+    this->_asyncTransaction.operation = Operation::READ;
+    this->_asyncTransaction.reg = reg_p;
+    this->_asyncTransaction.data = buffData_p;
+    this->_asyncTransaction.size = buffSize_p;
+    return this->enqueue(&this->_asyncTransaction);
+}
+
 bool_t Twi::setDevice(cuint16_t address_p, cbool_t useLongAddress_p)
 {
     // Update data members
@@ -134,53 +184,28 @@ bool_t Twi::setDevice(cuint16_t address_p, cbool_t useLongAddress_p)
     return true;
 }
 
-bool_t Twi::sendData(uint8_t devAddress_p, Operation readWrite_p, uint8_t reg_p, uint8_t *msg_p, uint8_t msgSize_p)
+bool_t Twi::sendData(uint8_t devAddress_p, Operation readWrite_p, uint8_t reg_p, uint8_t *msg_p, uint16_t msgSize_p)
 {
-    // Check for errors - NOT Initialized
-    if(!this->_initialized) {
-        this->_lastError = Error::NOT_INITIALIZED;
+    // Local variables
+    Transaction transaction = {devAddress_p, readWrite_p, reg_p, msg_p, msgSize_p, nullptr, Status::IDLE};
+
+    // Wait last transmission ends
+    if(!this->_waitWhileIsBusy()) {
         return false;
     }
-    // Check for errors - Message pointer
-    if((msgSize_p > 0) && (msg_p == NULL)) {
-        this->_lastError = Error::ARGUMENT_POINTER_NULL;
+
+    // Run the transaction directly on the caller buffer
+    if(!this->enqueue(&transaction)) {
         return false;
     }
-
-    // Wait last transmission ends
     if(!this->_waitWhileIsBusy()) {
+        // Abort, so the interrupt no longer refers to the descriptor
+        this->_cancelTransaction(&transaction);
         return false;
     }
-
-    // Prepare to send data
-    if(readWrite_p == Operation::WRITE) {       // Write operation
-        this->_bufferData[0] = (devAddress_p << 1) | (uint8_t)(Operation::WRITE);
-        this->_bufferData[1] = reg_p;
-        for(uint8_t i = 0; i < msgSize_p; i++) {
-            this->_bufferData[i + 2] = msg_p[i];
-        }
-        this->_bufferLength = msgSize_p + 2;
-        this->_startTrasmission();
-    } else {                            // Read operation
-        // Set pointer first
-        this->_bufferData[0] = (devAddress_p << 1) | (uint8_t)(Operation::WRITE);
-        this->_bufferData[1] = reg_p;
-        this->_bufferLength = 2;
-        this->_startTrasmission();
-        // Wait last transmission ends
-        if(!this->_waitWhileIsBusy()) {
-            return false;
-        }
-        // Read data
-        this->_bufferData[0] = (devAddress_p << 1) | (uint8_t)(Operation::READ);
-        this->_bufferLength = msgSize_p + 1;
-        this->_startTrasmission();
-        if(!this->_waitWhileIsBusy()) {
-            return false;
-        }
-        if(!this->_readFromBuffer(msg_p, msgSize_p)) {
-            return false;
-        }
+    if(transaction.status != Status::DONE) {
+        this->_lastError = Error::COMMUNICATION_FAILED;
+        return false;
     }
 
     this->_lastError = Error::NONE;
@@ -193,11 +218,50 @@ Bus::BusType Twi::getBusType(void)
     return Bus::BusType::TWI;
 }
 
+bool_t Twi::isBusy(void)
+{
+    // Local variables
+    bool_t isStuck = false;
+    uint32_t stopwatch;
+
+    // Recover the bus if a transfer takes too long: the transaction in
+    // progress, the asynchronous read that never left the queue, or a slave
+    // transfer abandoned by the host (unsigned differences, so the stopwatch
+    // wrap around is harmless)
+    if(this->_timeout != 0) {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            stopwatch = systemStatus.readStopwatch();
+            if((this->_current != nullptr) && ((stopwatch - this->_startMark) > this->_timeout)) {
+                isStuck = true;
+            }
+            if((this->_asyncTransaction.status == Status::QUEUED) &&
+                    ((stopwatch - this->_asyncTransaction.queuedMark) > this->_timeout)) {
+                isStuck = true;
+            }
+            if(this->_slaveActive && ((stopwatch - this->_slaveMark) > this->_timeout)) {
+                isStuck = true;
+            }
+        }
+        if(isStuck) {
+            this->_recoverFromTimeout();
+        }
+    }
+
+    // Check if the asynchronous read is in progress
+    if((this->_asyncTransaction.status == Status::QUEUED) || (this->_asyncTransaction.status == Status::BUSY)) {
+        return true;
+    }
+
+    // Update last error with the result of the asynchronous read
+    this->_lastError = (this->_asyncTransaction.status == Status::FAILED) ? Error::COMMUNICATION_FAILED : Error::NONE;
+    return false;
+}
+
 // =============================================================================
 // Class public methods - Own methods
 // =============================================================================
 
-bool_t Twi::init(cuint32_t clockSpeed_p, cuint8_t bufferSize_p)
+bool_t Twi::init(cuint32_t clockSpeed_p)
 {
     // Local variables
     uint32_t aux32 = 0;
@@ -220,28 +284,12 @@ bool_t Twi::init(cuint32_t clockSpeed_p, cuint8_t bufferSize_p)
         this->_lastError = Error::CLOCK_SPEED_TOO_HIGH;
         return false;
     }
-    // Check for errors - Buffer size
-    if(bufferSize_p < TWI_MIN_BUFFER_SIZE) {
-        this->_lastError = Error::BUFFER_SIZE_TOO_SMALL;
-        return false;
-    } else if(bufferSize_p > TWI_MAX_BUFFER_SIZE) {
-        this->_lastError = Error::BUFFER_SIZE_TOO_LARGE;
-        return false;
-    }
-
-    // Allocate memory (Free first if already allocated)
-    if(this->_bufferData != nullptr) {
-        free(this->_bufferData);
-        this->_bufferData = nullptr;
-    }
-    this->_bufferData = (uint8_t *)calloc((bufferSize_p + 2), sizeof(uint8_t));
-    if(this->_bufferData == nullptr) {
-        this->_lastError = Error::MEMORY_ALLOCATION;
-        return false;
-    }
-    this->_bufferMaxSize = bufferSize_p + 2;
-    this->_bufferIndex = 0;
-    this->_bufferLength = 0;
+    // Drop any queued transaction and leave the slave mode
+    this->_queueHead = 0;
+    this->_queueTail = 0;
+    this->_current = nullptr;
+    this->_listenControl = 0;
+    this->_slaveActive = false;
 
     // Evaluate BIT RATE and PRESCALER
     aux32 = systemStatus.getCpuClock();
@@ -265,6 +313,7 @@ bool_t Twi::init(cuint32_t clockSpeed_p, cuint8_t bufferSize_p)
     // Update TWI registers
     TWBR = aux8;
     TWDR = 0xFF;                       // Release SDA
+    this->_releaseStuckBus();          // A device may still hold SDA after a reset
     setBit(TWCR, TWEN);  // Activate TWI interface
 
     this->_initialized = true;
@@ -279,6 +328,308 @@ bool_t Twi::setTimeout(cuint16_t timeout_p)
     return true;
 }
 
+bool_t Twi::enqueue(Transaction *transaction_p)
+{
+    // Local variables
+    uint8_t nextHead;
+
+    // Check for errors - NOT Initialized
+    if(!this->_initialized) {
+        this->_lastError = Error::NOT_INITIALIZED;
+        return false;
+    }
+    // Check for errors - Descriptor
+    if(transaction_p == nullptr) {
+        this->_lastError = Error::ARGUMENT_POINTER_NULL;
+        return false;
+    }
+    if((transaction_p->status == Status::QUEUED) || (transaction_p->status == Status::BUSY)) {
+        this->_lastError = Error::BUSY;
+        return false;
+    }
+    if((transaction_p->size == 0) && (transaction_p->operation == Operation::READ)) {
+        this->_lastError = Error::ARGUMENT_CANNOT_BE_ZERO;
+        return false;
+    }
+    if((transaction_p->size > 0) && (transaction_p->data == nullptr)) {
+        this->_lastError = Error::ARGUMENT_POINTER_NULL;
+        return false;
+    }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        // Check for errors - Queue full
+        nextHead = (this->_queueHead + 1) & (TWI_QUEUE_SIZE - 1);
+        if(nextHead == this->_queueTail) {
+            this->_lastError = Error::BUFFER_NOT_ENOUGH_SPACE;
+            return false;
+        }
+
+        // Append transaction
+        transaction_p->status = Status::QUEUED;
+        transaction_p->queuedMark = systemStatus.readStopwatch();
+        this->_queue[this->_queueHead] = transaction_p;
+        this->_queueHead = nextHead;
+
+        // Start it now if the bus is idle (a pending slave event starts it
+        // when the slave is released)
+        if((this->_current == nullptr) && !this->_slaveActive && !isBitSet(TWCR, TWINT)) {
+            this->_popTransaction();
+            this->_startTrasmission();
+        }
+    }
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    return true;
+}
+
+uint8_t Twi::getQueuedCount(void)
+{
+    // Local variables
+    uint8_t aux8;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        aux8 = (this->_queueHead - this->_queueTail) & (TWI_QUEUE_SIZE - 1);
+    }
+
+    // Returns value
+    return aux8;
+}
+
+bool_t Twi::enableSlave(cuint8_t address_p, uint8_t *registers_p, cuint8_t size_p, cuint8_t writableFrom_p,
+        cbool_t generalCall_p)
+{
+    // Check for errors - NOT Initialized
+    if(!this->_initialized) {
+        this->_lastError = Error::NOT_INITIALIZED;
+        return false;
+    }
+    // Check for errors - Register map
+    if(registers_p == nullptr) {
+        this->_lastError = Error::ARGUMENT_POINTER_NULL;
+        return false;
+    }
+    if(size_p == 0) {
+        this->_lastError = Error::ARGUMENT_CANNOT_BE_ZERO;
+        return false;
+    }
+    // Check for errors - Reserved addresses
+    if((address_p < 0x08) || (address_p > 0x77)) {
+        this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+        return false;
+    }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        // Update data members
+        this->_slaveRegisters = registers_p;
+        this->_slaveSize = size_p;
+        this->_slaveWritableFrom = writableFrom_p;
+        this->_slavePointer = 0;
+        this->_listenControl = (1 << TWIE) | (1 << TWEA);
+
+        // Set own address and start listening if the bus is idle
+        TWAR = (address_p << 1) | ((generalCall_p) ? (1 << TWGCE) : 0);
+        if((this->_current == nullptr) && !this->_slaveActive && !isBitSet(TWCR, TWINT)) {
+            TWCR = (1 << TWEN) | this->_listenControl;
+        }
+    }
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    return true;
+}
+
+void Twi::disableSlave(void)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        // Stop answering; a transfer in progress ends normally
+        TWAR = 0;
+        this->_listenControl = 0;
+        if((this->_current == nullptr) && !this->_slaveActive && !isBitSet(TWCR, TWINT)) {
+            TWCR = (1 << TWEN);
+        }
+    }
+
+    return;
+}
+
+bool_t Twi::isSlaveAddressed(void)
+{
+    // Local variables
+    bool_t auxBool;
+
+    // A transfer idle for longer than the timeout was abandoned by the host
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        auxBool = this->_slaveActive && ((this->_timeout == 0) ||
+                        ((systemStatus.readStopwatch() - this->_slaveMark) <= this->_timeout));
+    }
+
+    // Returns status
+    return auxBool;
+}
+
+bool_t Twi::getStatistics(cuint8_t address_p, DeviceStatistics *statistics_p)
+{
+    // Check for errors
+    if(statistics_p == nullptr) {
+        this->_lastError = Error::ARGUMENT_POINTER_NULL;
+        return false;
+    }
+
+    // Copy the device entry
+    for(uint8_t i = 0; i < TWI_STATISTICS_SIZE; i++) {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            if((address_p != 0) && (this->_statistics[i].address == address_p)) {
+                *statistics_p = this->_statistics[i];
+                statistics_p->latencyAverage = (statistics_p->transactions == 0) ? 0 :
+                        (uint16_t)(this->_latencyTotal[i] / statistics_p->transactions);
+                if(statistics_p->transactions == 0) {
+                    statistics_p->latencyMin = 0;
+                }
+                this->_lastError = Error::NONE;
+                return true;
+            }
+        }
+    }
+
+    // Device not found
+    this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+    return false;
+}
+
+void Twi::clearStatistics(void)
+{
+    // Release all entries
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        for(uint8_t i = 0; i < TWI_STATISTICS_SIZE; i++) {
+            this->_statistics[i].address = 0;
+        }
+        this->_recoveryCount = 0;
+    }
+
+    return;
+}
+
+uint16_t Twi::getRecoveryCount(void)
+{
+    // Returns value
+    return this->_recoveryCount;
+}
+
+bool_t Twi::recoverBus(void)
+{
+    // Local variables
+    bool_t auxBool;
+
+    // Check for errors - NOT Initialized
+    if(!this->_initialized) {
+        this->_lastError = Error::NOT_INITIALIZED;
+        return false;
+    }
+
+    // Abort the transaction in progress and take the pins from the TWI; the
+    // next queued transaction waits for the end of the recovery
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        TWCR = 0;
+        this->_slaveActive = false;
+        if(this->_current != nullptr) {
+            this->_finishTransaction(false);
+            TWCR = 0;
+        }
+    }
+    auxBool = this->_releaseStuckBus();
+    countEvent(this->_recoveryCount);
+
+    // Give the pins back to the TWI and go on with the queue
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        TWCR = (1 << TWEN) | this->_listenControl;
+        if((this->_current == nullptr) && (this->_queueTail != this->_queueHead)) {
+            this->_popTransaction();
+        }
+        if(this->_current != nullptr) {
+            this->_startTrasmission();
+        }
+    }
+
+    if(!auxBool) {
+        this->_lastError = Error::COMMUNICATION_FAILED;
+        return false;
+    }
+    this->_lastError = Error::NONE;
+    return true;
+}
+
+bool_t Twi::scan(uint8_t *addresses_p, cuint8_t maxSize_p, uint8_t *found_p)
+{
+    // Local variables
+    uint8_t found = 0;
+    Error error = Error::NONE;
+
+    // Check for errors - NOT Initialized
+    if(!this->_initialized) {
+        this->_lastError = Error::NOT_INITIALIZED;
+        return false;
+    }
+    // Check for errors - Pointers
+    if((found_p == nullptr) || ((maxSize_p > 0) && (addresses_p == nullptr))) {
+        this->_lastError = Error::ARGUMENT_POINTER_NULL;
+        return false;
+    }
+
+    // Wait for the queued transactions
+    if(!this->_waitWhileIsBusy()) {
+        return false;
+    }
+
+    // Poll the TWI with the interrupt disabled; the slave mode is paused
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if(this->_slaveActive || (this->_current != nullptr) || isBitSet(TWCR, TWINT)) {
+            this->_lastError = Error::BUSY;
+            return false;
+        }
+        TWCR = (1 << TWEN);
+    }
+
+    // Probe each address with SLA+W
+    for(uint8_t address = 0x08; address <= 0x77; address++) {
+        TWCR = (1 << TWEN) | (1 << TWINT) | (1 << TWSTA);
+        if(!this->_pollInterruptFlag()) {
+            error = Error::COMMUNICATION_TIMEOUT;
+            break;
+        }
+        if((Twi::State)(TWSR & 0xFC) != Twi::State::START) {
+            error = Error::COMMUNICATION_FAILED;    // Bus taken by another master
+            break;
+        }
+        TWDR = address << 1;
+        TWCR = (1 << TWEN) | (1 << TWINT);
+        if(!this->_pollInterruptFlag()) {
+            error = Error::COMMUNICATION_TIMEOUT;
+            break;
+        }
+        if((Twi::State)(TWSR & 0xFC) == Twi::State::MTX_ADR_ACK) {
+            if(found < maxSize_p) {
+                addresses_p[found] = address;
+            }
+            found++;
+        }
+        TWCR = (1 << TWEN) | (1 << TWINT) | (1 << TWSTO);
+        for(uint16_t i = 0; (i < TWI_POLL_LIMIT) && isBitSet(TWCR, TWSTO); i++) {
+            // Wait for the STOP condition
+        }
+    }
+    *found_p = found;
+
+    // Give the TWI back to the interrupt
+    TWCR = (1 << TWEN) | (1 << TWINT) | this->_listenControl;
+    if(error == Error::COMMUNICATION_TIMEOUT) {     // The bus is stuck
+        this->recoverBus();
+    }
+
+    this->_lastError = error;
+    return (error == Error::NONE);
+}
+
 Error Twi::getLastError(void)
 {
     // Returns last error
@@ -292,24 +643,17 @@ Error Twi::getLastError(void)
 bool_t Twi::_waitWhileIsBusy(void)
 {
     // Local variables
-    uint32_t stopwatchMark;
-    uint32_t stopwatchDeadline;
+    uint32_t stopwatchMark = systemStatus.readStopwatch();
 
-    // Evaluates stopwatch deadline
-    if(this->_timeout == 0) {
-        stopwatchDeadline = 0xFFFFFFFF;
-    } else {
-        stopwatchDeadline = systemStatus.readStopwatch() + this->_timeout;
-    }
-
-    // Wait until TWI is ready for next transmission
+    // Wait until TWI is ready for next transmission (unsigned difference, so
+    // the stopwatch wrap around is harmless)
     do {
-        stopwatchMark = systemStatus.readStopwatch();
-        if(stopwatchMark > stopwatchDeadline) {
+        if((this->_timeout != 0) && ((systemStatus.readStopwatch() - stopwatchMark) > this->_timeout)) {
+            this->_recoverFromTimeout();
             this->_lastError = Error::COMMUNICATION_TIMEOUT;
             return false;
         }
-    } while(isBitSet(TWCR, TWIE));
+    } while((this->_current != nullptr) || (this->_queueTail != this->_queueHead));
 
     this->_lastError = Error::NONE;
     return true;
@@ -322,24 +666,210 @@ bool_t Twi::_startTrasmission(void)
     TWCR = (1 << TWEN) |
             (1 << TWIE) |
             (1 << TWINT) |
-            (1 << TWSTA);
+            (1 << TWSTA) |
+            this->_listenControl;
 
     this->_lastError = Error::NONE;
     return true;
 }
 
-bool_t Twi::_readFromBuffer(uint8_t *msg_p, cuint8_t msgSize_p)
+void Twi::_popTransaction(void)
 {
-    // Check for errors
-    if(!this->_lastTransOk) {
-        this->_lastError = Error::COMMUNICATION_FAILED;
-        return false;
+    // Take the oldest queued transaction
+    this->_current = this->_queue[this->_queueTail];
+    this->_queueTail = (this->_queueTail + 1) & (TWI_QUEUE_SIZE - 1);
+    this->_current->status = Status::BUSY;
+    this->_dataIndex = 0;
+    this->_readPhase = false;
+    this->_startTick = systemTick.getMicroseconds();
+    this->_startMark = systemStatus.readStopwatch();
+}
+
+void Twi::_finishTransaction(cbool_t success_p)
+{
+    // Local variables
+    Transaction *done = this->_current;
+    DeviceStatistics *statistics;
+    uint32_t latency;
+
+    // Update the device statistics
+    if(success_p && (done != nullptr)) {
+        statistics = this->_findStatistics(done->address);
+        if((statistics != nullptr) && (statistics->transactions != 0xFFFF)) {
+            latency = systemTick.getElapsedMicroseconds(this->_startTick);
+            if(latency > 0xFFFF) {
+                latency = 0xFFFF;
+            }
+            statistics->transactions++;
+            this->_latencyTotal[statistics - this->_statistics] += latency;
+            if(latency < statistics->latencyMin) {
+                statistics->latencyMin = (uint16_t)latency;
+            }
+            if(latency > statistics->latencyMax) {
+                statistics->latencyMax = (uint16_t)latency;
+            }
+        }
     }
-    for(uint8_t i = 0; i < msgSize_p; i++) {
-        msg_p[i] = this->_bufferData[i + 1];
+
+    // Signal the transaction that ended
+    this->_lastTransOk = success_p;
+    this->_current = nullptr;
+    if(done != nullptr) {
+        done->status = (success_p) ? Status::DONE : Status::FAILED;
+        if(done->callback != nullptr) {
+            done->callback(done);
+        }
+    }
+
+    // Start the next queued transaction, or release the bus
+    if(this->_queueTail != this->_queueHead) {
+        this->_popTransaction();
+        this->_state = State::NO_STATE;
+        TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWINT) | (1 << TWSTO) | (1 << TWSTA) | this->_listenControl;
+    } else {
+        TWCR = (1 << TWEN) | (1 << TWINT) | (1 << TWSTO) | this->_listenControl;
+    }
+}
+
+void Twi::_cancelTransaction(Transaction *transaction_p)
+{
+    // Local variables
+    uint8_t index;
+    uint8_t next;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        // In progress - abort it on the bus
+        if(this->_current == transaction_p) {
+            this->_finishTransaction(false);
+            return;
+        }
+
+        // Still queued - remove it, keeping the order of the others
+        if(transaction_p->status != Status::QUEUED) {
+            return;
+        }
+        for(index = this->_queueTail; index != this->_queueHead; index = next) {
+            next = (index + 1) & (TWI_QUEUE_SIZE - 1);
+            if(this->_queue[index] == transaction_p) {
+                for(; next != this->_queueHead; index = next, next = (next + 1) & (TWI_QUEUE_SIZE - 1)) {
+                    this->_queue[index] = this->_queue[next];
+                }
+                this->_queueHead = index;
+                transaction_p->status = Status::FAILED;
+                break;
+            }
+        }
+    }
+
+    return;
+}
+
+Twi::DeviceStatistics *Twi::_findStatistics(cuint8_t address_p)
+{
+    // Local variables
+    DeviceStatistics *freeEntry = nullptr;
+
+    // Look for the device entry
+    for(uint8_t i = 0; i < TWI_STATISTICS_SIZE; i++) {
+        if(this->_statistics[i].address == address_p) {
+            return &this->_statistics[i];
+        }
+        if((freeEntry == nullptr) && (this->_statistics[i].address == 0)) {
+            freeEntry = &this->_statistics[i];
+        }
+    }
+
+    // Take a free entry for a new device
+    if(freeEntry != nullptr) {
+        freeEntry->address = address_p;
+        freeEntry->transactions = 0;
+        freeEntry->nacks = 0;
+        freeEntry->arbitrationLosses = 0;
+        freeEntry->busErrors = 0;
+        freeEntry->timeouts = 0;
+        freeEntry->latencyMin = 0xFFFF;
+        freeEntry->latencyAverage = 0;
+        freeEntry->latencyMax = 0;
+        this->_latencyTotal[freeEntry - this->_statistics] = 0;
+    }
+
+    return freeEntry;
+}
+
+void Twi::_recoverFromTimeout(void)
+{
+    // Local variables
+    DeviceStatistics *statistics;
+
+    // Blame the device of the transaction in progress
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if(this->_current != nullptr) {
+            statistics = this->_findStatistics(this->_current->address);
+            if(statistics != nullptr) {
+                countEvent(statistics->timeouts);
+            }
+        }
+    }
+
+    this->recoverBus();
+}
+
+bool_t Twi::_releaseStuckBus(void)
+{
+    // Drive the lines as open drain: output low to pull, input to release
+    clrBit(PORTC, PORTC4);
+    clrBit(PORTC, PORTC5);
+    clrBit(DDRC, DDC4);
+    clrBit(DDRC, DDC5);
+    delayUs(TWI_RECOVERY_HALF_PERIOD);
+
+    // Clock SCL until the device holding SDA releases it
+    for(uint8_t i = 0; (i < TWI_RECOVERY_CLOCKS) && !isBitSet(PINC, PINC4); i++) {
+        setBit(DDRC, DDC5);
+        delayUs(TWI_RECOVERY_HALF_PERIOD);
+        clrBit(DDRC, DDC5);
+        delayUs(TWI_RECOVERY_HALF_PERIOD);
+    }
+
+    // Send a STOP condition: SDA rises while SCL is high
+    setBit(DDRC, DDC5);
+    delayUs(TWI_RECOVERY_HALF_PERIOD);
+    setBit(DDRC, DDC4);
+    delayUs(TWI_RECOVERY_HALF_PERIOD);
+    clrBit(DDRC, DDC5);
+    delayUs(TWI_RECOVERY_HALF_PERIOD);
+    clrBit(DDRC, DDC4);
+    delayUs(TWI_RECOVERY_HALF_PERIOD);
+
+    // Check both lines
+    return (isBitSet(PINC, PINC4) && isBitSet(PINC, PINC5));
+}
+
+bool_t Twi::_pollInterruptFlag(void)
+{
+    // Wait for the end of the bus operation
+    for(uint16_t i = 0; i < TWI_POLL_LIMIT; i++) {
+        if(isBitSet(TWCR, TWINT)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void Twi::_releaseSlave(void)
+{
+    // Go on with the master transactions held by the slave transfer
+    this->_slaveActive = false;
+    if((this->_current == nullptr) && (this->_queueTail != this->_queueHead)) {
+        this->_popTransaction();
+    }
+    if(this->_current != nullptr) {
+        this->_state = State::NO_STATE;
+        TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWINT) | (1 << TWSTA) | this->_listenControl;
+    } else {
+        TWCR = (1 << TWEN) | (1 << TWINT) | this->_listenControl;
     }
-    this->_lastError = Error::NONE;
-    return true;
 }
 
 // =============================================================================
@@ -360,48 +890,163 @@ bool_t Twi::_readFromBuffer(uint8_t *msg_p, cuint8_t msgSize_p)
 
 void Twi::interruptHandler(void)
 {
-    static uint8_t twiBufferPointer;
-
+    // Local variables
     State twiState = (Twi::State)(TWSR & 0xFC);
+    Transaction *transaction = this->_current;
+    DeviceStatistics *statistics = nullptr;
+    uint8_t aux8;
+
+    // Device of the transaction in progress, to count its failures
+    switch(twiState) {
+    case Twi::State::ARB_LOST:
+    case Twi::State::MTX_ADR_NACK:
+    case Twi::State::MRX_ADR_NACK:
+    case Twi::State::MTX_DATA_NACK:
+    case Twi::State::BUS_ERROR:
+    case Twi::State::SRX_ADR_ACK_M_ARB_LOST:
+    case Twi::State::SRX_GEN_ACK_M_ARB_LOST:
+    case Twi::State::STX_ADR_ACK_M_ARB_LOST:
+        if(transaction != nullptr) {
+            statistics = this->_findStatistics(transaction->address);
+        }
+        break;
+    default:
+        break;
+    }
+
+    // Slave states
+    switch(twiState) {
+    case Twi::State::SRX_ADR_ACK_M_ARB_LOST:    // Arbitration lost; own SLA+W received
+    case Twi::State::SRX_GEN_ACK_M_ARB_LOST:    // Arbitration lost; general call received
+        if(statistics != nullptr) {
+            countEvent(statistics->arbitrationLosses);
+        }
+        this->_dataIndex = 0;           // Master transaction restarts afterwards
+        this->_readPhase = false;
+    case Twi::State::SRX_ADR_ACK:       // Own SLA+W has been received
+    case Twi::State::SRX_GEN_ACK:       // General call address has been received
+        this->_slaveActive = true;
+        this->_slaveMark = systemStatus.readStopwatch();
+        this->_slaveFirstByte = true;   // First byte is the register pointer
+        this->_slaveWriteCount = 0;
+        TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWINT) | (1 << TWEA);
+        return;
+    case Twi::State::SRX_ADR_DATA_ACK:  // Data byte has been received and ACK returned
+    case Twi::State::SRX_GEN_DATA_ACK:
+        this->_slaveMark = systemStatus.readStopwatch();
+        aux8 = TWDR;
+        if(this->_slaveFirstByte) {
+            this->_slaveFirstByte = false;
+            this->_slavePointer = (aux8 < this->_slaveSize) ? aux8 : this->_slaveSize;
+        } else if(this->_slavePointer < this->_slaveSize) {
+            if(this->_slavePointer >= this->_slaveWritableFrom) {
+                if(this->_slaveWriteCount == 0) {
+                    this->_slaveWriteStart = this->_slavePointer;
+                }
+                this->_slaveRegisters[this->_slavePointer] = aux8;
+                this->_slaveWriteCount++;
+            }
+            this->_slavePointer++;
+        }
+        TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWINT) | (1 << TWEA);
+        return;
+    case Twi::State::SRX_STOP_RESTART:  // STOP or repeated START received while addressed
+        if(this->_slaveWriteCount != 0) {
+            twiSlaveReceptionCallback(this->_slaveWriteStart, this->_slaveWriteCount);
+        }
+    case Twi::State::SRX_ADR_DATA_NACK: // Data byte has been received and NACK returned
+    case Twi::State::SRX_GEN_DATA_NACK:
+    case Twi::State::STX_DATA_NACK:     // Master does not want more data
+    case Twi::State::STX_DATA_ACK_LAST_BYTE:    // Last data byte has been transmitted
+        this->_releaseSlave();
+        return;
+    case Twi::State::STX_ADR_ACK_M_ARB_LOST:    // Arbitration lost; own SLA+R received
+        if(statistics != nullptr) {
+            countEvent(statistics->arbitrationLosses);
+        }
+        this->_dataIndex = 0;           // Master transaction restarts afterwards
+        this->_readPhase = false;
+    case Twi::State::STX_ADR_ACK:       // Own SLA+R has been received
+        this->_slaveActive = true;
+    case Twi::State::STX_DATA_ACK:      // Data byte has been transmitted and ACK received
+        this->_slaveMark = systemStatus.readStopwatch();
+        if(this->_slavePointer < this->_slaveSize) {
+            TWDR = this->_slaveRegisters[this->_slavePointer++];
+        } else {
+            TWDR = 0xFF;
+        }
+        TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWINT) | (1 << TWEA);
+        return;
+    default:
+        break;
+    }
+
+    // Nothing to do without a transaction (bus error while idle)
+    if(transaction == nullptr) {
+        this->_slaveActive = false;
+        this->_finishTransaction(false);
+        return;
+    }
 
     switch(twiState) {
     case Twi::State::START:             // START has been transmitted
     case Twi::State::REP_START:         // Repeated START has been transmitted
-        twiBufferPointer = 0;   // Set buffer pointer to the TWI Address location
+        TWDR = (transaction->address << 1) | (uint8_t)((this->_readPhase) ? Operation::READ : Operation::WRITE);
+        TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWINT) | this->_listenControl;
+        break;
     case Twi::State::MTX_ADR_ACK:       // SLA+W has been transmitted and ACK received
+        TWDR = transaction->reg;        // Register address segment
+        TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWINT);
+        break;
     case Twi::State::MTX_DATA_ACK:      // Data byte has been transmitted and ACK received
-        if(twiBufferPointer < this->_bufferLength) {
-            TWDR = this->_bufferData[twiBufferPointer++];
+        if(transaction->operation == Operation::READ) {     // Pointer set, repeated START to read
+            this->_readPhase = true;
+            TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWINT) | (1 << TWSTA);
+        } else if(this->_dataIndex < transaction->size) {   // Payload segment, in place
+            TWDR = transaction->data[this->_dataIndex++];
             TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWINT);
-        } else {            // Send STOP after last byte
-            this->_lastTransOk = true;  // Set status bits to completed successfully
-            TWCR = (1 << TWEN) | (1 << TWINT) | (1 << TWSTO);
+        } else {            // Send STOP after last byte, or start the next transaction
+            this->_finishTransaction(true);
         }
         break;
     case Twi::State::MRX_DATA_ACK:      // Data byte has been received and ACK transmitted
-        this->_bufferData[twiBufferPointer++] = TWDR;
+        transaction->data[this->_dataIndex++] = TWDR;
     case Twi::State::MRX_ADR_ACK:       // SLA+R has been transmitted and ACK received
-        if(twiBufferPointer < (this->_bufferLength - 1)) {  // Detect the last byte to NACK it
+        if((this->_dataIndex + 1) < transaction->size) {    // Detect the last byte to NACK it
             TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWINT) | (1 << TWEA);
         } else {                // Send NACK after next reception
             TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWINT);
         }
         break;
     case Twi::State::MRX_DATA_NACK:     // Data byte has been received and NACK transmitted
-        this->_bufferData[twiBufferPointer] = TWDR;
-        this->_lastTransOk = true;  // Set status bits to completed successfully
-        TWCR = (1 << TWEN) | (1 << TWINT) | (1 << TWSTO);
+        transaction->data[this->_dataIndex++] = TWDR;
+        this->_finishTransaction(true);
         break;
     case Twi::State::ARB_LOST:          // Arbitration lost
-        TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWINT) | (1 << TWSTA);
+        if(statistics != nullptr) {
+            countEvent(statistics->arbitrationLosses);
+        }
+        this->_dataIndex = 0;           // Restart the whole transaction
+        this->_readPhase = false;
+        TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWINT) | (1 << TWSTA) | this->_listenControl;
         break;
     case Twi::State::MTX_ADR_NACK:      // SLA+W has been transmitted and NACK received
     case Twi::State::MRX_ADR_NACK:      // SLA+R has been transmitted and NACK received
     case Twi::State::MTX_DATA_NACK:     // Data byte has been transmitted and NACK received
+        if(statistics != nullptr) {
+            countEvent(statistics->nacks);
+        }
+        this->_twiError = TWSR;
+        this->_finishTransaction(false);    // Release the bus, then go on with the queue
+        break;
     case Twi::State::BUS_ERROR:         // Bus error due to an illegal START or STOP condition
+        if(statistics != nullptr) {
+            countEvent(statistics->busErrors);
+        }
     default:
         this->_twiError = TWSR;        // Store TWSR and automatically sets clears noErrors bit
-        TWCR = (1 << TWEN);     // Reset TWI Interface
+        this->_slaveActive = false;
+        this->_finishTransaction(false);    // Release the bus, then go on with the queue
         break;
     }
 }
@@ -410,6 +1055,11 @@ void Twi::interruptHandler(void)
 // Interrupt handlers
 // =============================================================================
 
+weakened void twiSlaveReceptionCallback(cuint8_t reg_p, cuint8_t size_p)
+{
+    return;
+}
+
 ISR(TWI_vect)
 {
     twi.interruptHandler();
@@ -49,6 +49,13 @@
 #   error "Version mismatch between header file and library dependency (systemStatus.hpp)!"
 #endif
 
+#include "../util/systemTick.hpp"
+#if !defined(__SYSTEM_TICK_HPP)
+#   error "Header file (systemTick.hpp) is corrupted!"
+#elif __SYSTEM_TICK_HPP != __TWI_HPP
+#   error "Version mismatch between header file and library dependency (systemTick.hpp)!"
+#endif
+
 // =============================================================================
 // Undefining previous definitions
 // =============================================================================
@@ -59,7 +66,28 @@
 // Constant definitions
 // =============================================================================
 
-// NONE
+#ifndef TWI_QUEUE_SIZE
+//!
+//! \brief          Number of entries of the transaction queue
+//! \details        Must be a power of two. One entry is kept free, so the
+//!                     queue holds up to TWI_QUEUE_SIZE - 1 transactions
+//!                     besides the one in progress.
+//!
+#   define TWI_QUEUE_SIZE               8
+#endif
+
+#if (TWI_QUEUE_SIZE & (TWI_QUEUE_SIZE - 1)) != 0
+#   error "TWI_QUEUE_SIZE must be a power of two!"
+#endif
+
+#ifndef TWI_STATISTICS_SIZE
+//!
+//! \brief          Number of devices with bus health statistics
+//! \details        The entries are taken by the first devices addressed;
+//!                     the transactions with other devices are not counted.
+//!
+#   define TWI_STATISTICS_SIZE          4
+#endif
 
 // =============================================================================
 // New data types
@@ -73,6 +101,21 @@
 
 void twiInterruptCallback();
 
+//!
+//! \brief          Slave reception callback function
+//! \details        This function is called from the TWI interrupt when a
+//!                     master ends a write to the slave register map (STOP or
+//!                     repeated START), with the range of registers written.
+//!                     It is a weak function that can be overwritten by the
+//!                     user.
+//! \param          reg_p               First register written
+//! \param          size_p              Number of registers written
+//!
+void twiSlaveReceptionCallback(
+        cuint8_t reg_p,
+        cuint8_t size_p
+);
+
 // =============================================================================
 // Twi Class
 // =============================================================================
@@ -99,6 +142,63 @@ public:
         READ        = true
     };
 
+    //     ////////////////     Transaction status     /////////////////     //
+    //!
+    //! \brief      Transaction status enumeration
+    //! \details    Status of a queued transaction.
+    //!
+    enum class Status : uint8_t {
+        IDLE                            = 0,    //!< Never queued
+        QUEUED                          = 1,    //!< Waiting in the queue
+        BUSY                            = 2,    //!< In progress on the bus
+        DONE                            = 3,    //!< Completed successfully
+        FAILED                          = 4     //!< Aborted by a NACK or bus error
+    };
+
+    //     //////////////////     Transaction     ///////////////////     //
+    //!
+    //! \brief      Transaction descriptor
+    //! \details    Register read or write handed to \ref{enqueue}. The
+    //!                 interrupt sends the register address segment and then
+    //!                 reads or writes the payload segment in place, so the
+    //!                 descriptor and its data vector are owned by the
+    //!                 caller and must stay valid until the status leaves
+    //!                 QUEUED and BUSY. The callback, if any, is called from
+    //!                 the TWI interrupt when the transaction ends, and may
+    //!                 enqueue another transaction.
+    //!
+    typedef struct Transaction {
+        uint8_t             address;            //!< 7-bit device address
+        Operation           operation;          //!< Register read or write
+        uint8_t             reg;                //!< Register address
+        uint8_t             *data;              //!< Data vector
+        uint16_t            size;               //!< Number of data bytes
+        void (*callback)(struct Transaction *transaction_p);    //!< Completion callback, or nullptr
+        volatile Status     status;             //!< Updated by the interrupt
+        uint32_t            queuedMark;         //!< Stopwatch when queued, set by \ref{enqueue}
+    } Transaction;
+
+    //     ///////////////////     Bus health     ////////////////////     //
+    //!
+    //! \brief      Device statistics
+    //! \details    Bus health counters of a device. The counters saturate at
+    //!                 0xFFFF. The latency is measured from the start of the
+    //!                 transaction to its end, in microseconds (saturated at
+    //!                 65535), and accounts only for the completed
+    //!                 transactions; it needs the system tick running.
+    //!
+    typedef struct DeviceStatistics {
+        uint8_t             address;            //!< 7-bit device address
+        uint16_t            transactions;       //!< Completed transactions
+        uint16_t            nacks;              //!< Transactions refused by the device
+        uint16_t            arbitrationLosses;  //!< Arbitration losses
+        uint16_t            busErrors;          //!< Illegal START or STOP conditions
+        uint16_t            timeouts;           //!< Transactions aborted by a timeout
+        uint16_t            latencyMin;         //!< Shortest transaction
+        uint16_t            latencyAverage;     //!< Average transaction
+        uint16_t            latencyMax;         //!< Longest transaction
+    } DeviceStatistics;
+
 private:
     //     ///////////////////     TWI operation     ////////////////////     //
     //!
@@ -164,6 +264,9 @@ public:
     Bus::BusType getBusType(
             void
     );
+    bool_t isBusy(
+            void
+    );
 
     //     ////////////////////    DATA TRANSFER     ////////////////////     //
     bool_t readReg(
@@ -176,6 +279,11 @@ public:
             cuint8_t *buffData_p,
             cuint16_t buffSize_p = 1
     );
+    bool_t readRegAsync(
+            cuint8_t reg_p,
+            uint8_t *buffData_p,
+            cuint16_t buffSize_p
+    );
 
     //     //////////////////    PROTOCOL SPECIFIC     //////////////////     //
     bool_t setDevice(
@@ -193,12 +301,10 @@ public:
     //! \brief      Initializes the TWI module
     //! \details    Initializes the TWI module.
     //! \param      clockSpeed_p        Clock speed
-    //! \param      bufferSize_p        Circular buffer size
     //! \return     bool_t              True on success / False on failure
     //!
     bool_t init(
-            cuint32_t clockSpeed_p      = 10'000,
-            cuint8_t bufferSize_p       = 20
+            cuint32_t clockSpeed_p      = 10'000
     );
 
     bool_t sendData(
@@ -206,13 +312,172 @@ public:
             Operation readWrite_p,
             uint8_t reg_p,
             uint8_t *msg_p,
-            uint8_t msgSize_p
+            uint16_t msgSize_p
     );
 
+    //!
+    //! \brief      Sets the timeout
+    //! \details    Sets the timeout of the blocking transfers, counted by
+    //!                 the stopwatch (milliseconds when the system tick is
+    //!                 running). A zero timeout waits forever.
+    //! \param      timeout_p           Timeout, in milliseconds
+    //! \return     bool_t              True on success / False on failure
+    //!
     bool_t setTimeout(
             cuint16_t timeout_p
     );
 
+    //!
+    //! \brief      Queues a transaction
+    //! \details    Appends the transaction to the queue and returns
+    //!                 immediately. The queued transactions run back to back
+    //!                 from the TWI interrupt; completion is signalled by the
+    //!                 descriptor status and callback. Blocking transfers
+    //!                 wait until the queue is empty. Must be called from the
+    //!                 main loop or from a completion callback.
+    //! \param      transaction_p       Pointer to the transaction descriptor
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t enqueue(
+            Transaction *transaction_p
+    );
+
+    //!
+    //! \brief      Returns the number of queued transactions
+    //! \details    Returns the number of transactions waiting in the
+    //!                 queue, not counting the one in progress.
+    //! \return     uint8_t             Queued transactions
+    //!
+    uint8_t getQueuedCount(
+            void
+    );
+
+    //     //////////////////////    SLAVE MODE    /////////////////////     //
+    //!
+    //! \brief      Enables the slave mode
+    //! \details    Answers to the own address with a register map, like a
+    //!                 memory device: the first byte written by a master sets
+    //!                 the register pointer, the next ones are stored from it
+    //!                 on, and reads return the registers from the pointer
+    //!                 on. The pointer is auto-incremented and stops at the
+    //!                 end of the map; registers beyond it read as 0xFF and
+    //!                 ignore writes. Only the registers from writableFrom_p
+    //!                 on can be written by the master. The map is owned by
+    //!                 the caller and is accessed from the TWI interrupt.
+    //!                 Master transactions keep working: the ones queued
+    //!                 while the slave is addressed start when it is
+    //!                 released, and the ones that lose arbitration to a
+    //!                 master addressing this device are restarted after it.
+    //! \param      address_p           Own 7-bit address
+    //! \param      registers_p         Pointer to the register map
+    //! \param      size_p              Number of registers (1 to 255)
+    //! \param      writableFrom_p      First register writable by the master
+    //! \param      generalCall_p       True to also answer to the general
+    //!                                     call address / False otherwise
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t enableSlave(
+            cuint8_t address_p,
+            uint8_t *registers_p,
+            cuint8_t size_p,
+            cuint8_t writableFrom_p     = 0,
+            cbool_t generalCall_p       = false
+    );
+
+    //!
+    //! \brief      Disables the slave mode
+    //! \details    Stops answering to the own address. A slave transfer in
+    //!                 progress is completed.
+    //!
+    void disableSlave(
+            void
+    );
+
+    //!
+    //! \brief      Checks if the slave is addressed
+    //! \details    Checks if a host is reading or writing the register map.
+    //!                 Registers changed while it reads may reach the host
+    //!                 partly old and partly new, so the owner of the map
+    //!                 should check it, with interrupts disabled, before
+    //!                 changing a multi-byte value. A transfer with no
+    //!                 activity for longer than the timeout was abandoned
+    //!                 by the host and is not reported; isBusy() then
+    //!                 recovers the bus.
+    //! \return     bool_t              True if addressed / False otherwise
+    //!
+    bool_t isSlaveAddressed(
+            void
+    );
+
+    //     //////////////////////    BUS HEALTH    /////////////////////     //
+    //!
+    //! \brief      Returns the statistics of a device
+    //! \details    Copies the bus health counters of a device.
+    //! \param      address_p           7-bit device address
+    //! \param      statistics_p        Pointer to the statistics struct
+    //! \return     bool_t              True on success / False if the
+    //!                                     device has no statistics
+    //!
+    bool_t getStatistics(
+            cuint8_t address_p,
+            DeviceStatistics *statistics_p
+    );
+
+    //!
+    //! \brief      Clears the statistics
+    //! \details    Clears the counters of all devices and releases their
+    //!                 entries.
+    //!
+    void clearStatistics(
+            void
+    );
+
+    //!
+    //! \brief      Returns the number of bus recoveries
+    //! \details    Returns the number of times recoverBus() was run. The
+    //!                 counter saturates at 0xFFFF.
+    //! \return     uint16_t            Bus recoveries
+    //!
+    uint16_t getRecoveryCount(
+            void
+    );
+
+    //!
+    //! \brief      Recovers a stuck bus
+    //! \details    Aborts the transaction in progress, then takes the pins
+    //!                 from the TWI and clocks SCL (up to 9 pulses) until a
+    //!                 device holding SDA low releases it, and ends with a
+    //!                 STOP condition. The queued transactions go on
+    //!                 afterwards. It is run whenever a transaction times
+    //!                 out, and init() releases the lines the same way.
+    //!                 isBusy() also runs it when the asynchronous read
+    //!                 stays queued, or a slave transfer stays idle, for
+    //!                 longer than the timeout.
+    //! \return     bool_t              True if both lines are released /
+    //!                                     False otherwise
+    //!
+    bool_t recoverBus(
+            void
+    );
+
+    //!
+    //! \brief      Scans the bus for devices
+    //! \details    Sends the address of each device (0x08 to 0x77) and
+    //!                 lists the ones that acknowledge it. The scan is
+    //!                 blocking and runs with the slave mode paused.
+    //! \param      addresses_p         Pointer to the address vector
+    //! \param      maxSize_p           Size of the address vector
+    //! \param      found_p             Pointer to store the number of
+    //!                                     devices found (it may be larger
+    //!                                     than maxSize_p)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t scan(
+            uint8_t *addresses_p,
+            cuint8_t maxSize_p,
+            uint8_t *found_p
+    );
+
     Error getLastError(
             void
     );
@@ -231,9 +496,38 @@ private:
             void
     );
 
-    bool_t _readFromBuffer(
-            uint8_t *msg_p,
-            cuint8_t msgSize_p
+    void _popTransaction(
+            void
+    );
+
+    void _finishTransaction(
+            cbool_t success_p
+    );
+
+    void _cancelTransaction(
+            Transaction *transaction_p
+    );
+
+    //     //////////////////////    SLAVE MODE    /////////////////////     //
+    void _releaseSlave(
+            void
+    );
+
+    //     //////////////////////    BUS HEALTH    /////////////////////     //
+    DeviceStatistics *_findStatistics(
+            cuint8_t address_p
+    );
+
+    void _recoverFromTimeout(
+            void
+    );
+
+    bool_t _releaseStuckBus(
+            void
+    );
+
+    bool_t _pollInterruptFlag(
+            void
     );
 
 protected:
@@ -255,12 +549,30 @@ private:
     bool_t               _useLongAddress                : 1;
     Error                _lastError;
     State                _state;
-    uint8_t              _bufferIndex                   : 7;
-    uint8_t              _bufferLength                  : 7;
-    uint8_t              _bufferMaxSize                 : 7;
     uint16_t             _devAddress                 : 10;
     uint16_t             _timeout;
-    uint8_t              *_bufferData;
+    uint16_t             _dataIndex;
+    bool_t               _readPhase                     : 1;
+    Transaction          _asyncTransaction;
+    Transaction          *_queue[TWI_QUEUE_SIZE];
+    vuint8_t             _queueHead;
+    vuint8_t             _queueTail;
+    Transaction          *volatile _current;
+    uint8_t              *_slaveRegisters;
+    uint8_t              _slaveSize;
+    uint8_t              _slaveWritableFrom;
+    uint8_t              _slavePointer;
+    uint8_t              _slaveWriteStart;
+    uint8_t              _slaveWriteCount;
+    uint8_t              _listenControl;
+    bool_t               _slaveFirstByte                : 1;
+    volatile bool_t      _slaveActive;
+    uint32_t             _startTick;
+    uint32_t             _startMark;
+    volatile uint32_t    _slaveMark;
+    DeviceStatistics     _statistics[TWI_STATISTICS_SIZE];
+    uint32_t             _latencyTotal[TWI_STATISTICS_SIZE];
+    uint16_t             _recoveryCount;
 
 }; // class Twi
 
@@ -7,23 +7,29 @@ Usart0 usart0;
 FILE usartStream;
 
 int usartTransmitStdWrapper(char data, FILE *stream);
+int usartReceiveStdWrapper(FILE *stream);
 
-Usart0::Usart0(BaudRate baudRate_p, Mode mode_p, FrameFormat format_p)
+Usart0::Usart0(void)
 {
-    if(!this->setBaudRate(baudRate_p)) {
-        // Returns error
-        return;
-    }
-    if(!this->setMode(mode_p)) {
-        // Returns error
-        return;
-    }
-    if(!this->setFrameFormat(format_p)) {
-        // Returns error
-        return;
-    }
-
-    fdev_setup_stream(&usartStream, usartTransmitStdWrapper, NULL, _FDEV_SETUP_WRITE);
+    // Default configuration, resolved at compile time
+    this->setBaudRate<BaudRate::BAUD_RATE_9600, Mode::ASYNCHRONOUS>();
+    this->setFrameFormat(FrameFormat::FRAME_FORMAT_8_N_1);
+
+    // Buffered mode starts disabled
+    this->_isBuffered = false;
+    this->_txHead = 0;
+    this->_txTail = 0;
+    this->_rxHead = 0;
+    this->_rxTail = 0;
+    this->_txOverrunCount = 0;
+    this->_rxOverrunCount = 0;
+
+    // Multiprocessor mode starts disabled
+    this->_isMultiprocessor = false;
+    this->_nodeAddress = 0;
+
+    usartDefaultHandler = this;
+    fdev_setup_stream(&usartStream, usartTransmitStdWrapper, usartReceiveStdWrapper, _FDEV_SETUP_RW);
 
     this->_isInitialized = true;
     
@@ -44,12 +50,18 @@ bool_t Usart0::init(void)
     uint8_t ucsr0a = UCSR0A;
     uint8_t ucsr0b = UCSR0B;
     uint8_t ucsr0c = UCSR0C;
-    uint64_t ubrr0 = (uint64_t)UBRR0;
-    uint8_t auxPrescaler = 1;
+    uint16_t ubrr0;
 
     // Clear errors
     ucsr0a &= ~((1 << FE0) | (1 << DOR0) | (1 << UPE0));
 
+    // Configure address filter
+    if(this->_isMultiprocessor) {
+        setBit(ucsr0a, MPCM0);
+    } else {
+        clrBit(ucsr0a, MPCM0);
+    }
+
     // Configure stop bit
     switch(this->_stopBits) {
     case Usart0::StopBits::SINGLE:
@@ -100,50 +112,42 @@ bool_t Usart0::init(void)
     clrBit(ucsr0c, UCPOL0);             // Polarity
     switch(this->_mode) {
     case Usart0::Mode::ASYNCHRONOUS:
-        auxPrescaler = 16;
         break;
     case Usart0::Mode::ASYNCHRONOUS_DOUBLE_SPEED:
         setBit(ucsr0a, U2X0);           // Double Speed
-        auxPrescaler = 8;
         break;
     case Usart0::Mode::SYNCHRONOUS_TX_RISING_RX_FALLING:
         setMaskOffset(ucsr0c, 1, UMSEL00);      // Synchronous Mode Tx rising edge
         clrBit(ucsr0c, UCPOL0);
-        auxPrescaler = 2;
         break;
     case Usart0::Mode::SYNCHRONOUS_TX_FALLING_RX_RISING:
         setMaskOffset(ucsr0c, 1, UMSEL00);      // Synchronous Mode Tx falling edge
         setBit(ucsr0c, UCPOL0);
-        auxPrescaler = 2;
         break;
     case Usart0::Mode::MASTER_SPI_MODE_0:
         setMaskOffset(ucsr0c, 3, UMSEL00);      // Synchronous SPI Mode
         clrBit(ucsr0c, UCPOL0);         // Polarity
         clrBit(ucsr0c, UCPHA0);         // Phase
-        auxPrescaler = 2;
         break;
     case Usart0::Mode::MASTER_SPI_MODE_1:
         setMaskOffset(ucsr0c, 3, UMSEL00);      // Synchronous SPI Mode
         clrBit(ucsr0c, UCPOL0);         // Polarity
         setBit(ucsr0c, UCPHA0);         // Phase
-        auxPrescaler = 2;
         break;
     case Usart0::Mode::MASTER_SPI_MODE_2:
         setMaskOffset(ucsr0c, 3, UMSEL00);      // Synchronous SPI Mode
         setBit(ucsr0c, UCPOL0);         // Polarity
         clrBit(ucsr0c, UCPHA0);         // Phase
-        auxPrescaler = 2;
         break;
     case Usart0::Mode::MASTER_SPI_MODE_3:
         setMaskOffset(ucsr0c, 3, UMSEL00);      // Synchronous SPI Mode
         setBit(ucsr0c, UCPOL0);         // Polarity
         setBit(ucsr0c, UCPHA0);         // Phase
-        auxPrescaler = 2;
         break;
     }
 
-    // Configure baud rate
-    ubrr0 = (systemStatus.getCpuClock() / (auxPrescaler * (uint32_t)this->_baudRate) - 1);
+    // Configure baud rate (the divisor was computed at compile time)
+    ubrr0 = _computeUbrr(this->_baudDivisor, _getPrescalerShift(this->_mode));
 
     // Configures USART registers
     UCSR0A = ucsr0a;
@@ -151,6 +155,7 @@ bool_t Usart0::init(void)
     UCSR0C = ucsr0c;
     UBRR0H = (uint8_t)(0x0F & (ubrr0 >> 8));
     UBRR0L = (uint8_t)(0xFF & ubrr0);
+    this->_isInitialized = true;
 
     // Returns successfully
     this->_lastError = Error::NONE;
@@ -159,26 +164,17 @@ bool_t Usart0::init(void)
 
 bool_t Usart0::setMode(const Mode mode_p)
 {
-    // Resets data members
-    this->_isInitialized = false;
-
-    // Checks for errors
-    switch(mode_p) {
-    case Usart0::Mode::ASYNCHRONOUS:
-    case Usart0::Mode::ASYNCHRONOUS_DOUBLE_SPEED:
-    case Usart0::Mode::SYNCHRONOUS_TX_RISING_RX_FALLING:
-    case Usart0::Mode::SYNCHRONOUS_TX_FALLING_RX_RISING:
-    case Usart0::Mode::MASTER_SPI_MODE_0:
-    case Usart0::Mode::MASTER_SPI_MODE_1:
-    case Usart0::Mode::MASTER_SPI_MODE_2:
-    case Usart0::Mode::MASTER_SPI_MODE_3:
-        break;
-    default:
+    // The baud rate divisor was checked for the prescaler of the current
+    // mode; a mode with another prescaler must go through setBaudRate()
+    if(_getPrescalerShift(mode_p) != _getPrescalerShift(this->_mode)) {
         // Returns error
-        this->_lastError = Error::USART_MODE_NOT_SUPPORTED;
+        this->_lastError = Error::MODE_NOT_SUPPORTED;
         return false;
     }
 
+    // Resets data members
+    this->_isInitialized = false;
+
     // Updates class member
     this->_mode = mode_p;
 
@@ -192,20 +188,6 @@ bool_t Usart0::setDataSize(const DataSize dataSize_p)
     // Resets data members
     this->_isInitialized = false;
 
-    // Checks for errors
-    switch(dataSize_p) {
-    case Usart0::DataSize::DATA_5_BITS:
-    case Usart0::DataSize::DATA_6_BITS:
-    case Usart0::DataSize::DATA_7_BITS:
-    case Usart0::DataSize::DATA_8_BITS:
-    case Usart0::DataSize::DATA_9_BITS:
-        break;
-    default:
-        // Returns error
-        this->_lastError = Error::USART_DATA_SIZE_NOT_SUPPORTED;
-        return false;
-    }
-
     // Updates data members
     this->_dataSize = dataSize_p;
 
@@ -219,17 +201,6 @@ bool_t Usart0::setStopBits(const StopBits stopBits_p)
     // Resets data members
     this->_isInitialized = false;
 
-    // Checks for errors
-    switch(stopBits_p) {
-    case Usart0::StopBits::SINGLE:
-    case Usart0::StopBits::DOUBLE:
-        break;
-    default:
-        // Returns error
-        this->_lastError = Error::USART_STOP_BIT_NOT_SUPPORTED;
-        return false;
-    }
-
     // Updates data members
     this->_stopBits = stopBits_p;
 
@@ -243,18 +214,6 @@ bool_t Usart0::setParity(const Parity parity_p)
     // Resets data members
     this->_isInitialized = false;
 
-    // Checks for errors
-    switch(parity_p) {
-    case Usart0::Parity::NONE:
-    case Usart0::Parity::ODD:
-    case Usart0::Parity::EVEN:
-        break;
-    default:
-        // Returns error
-        this->_lastError = Error::USART_PARITY_NOT_SUPPORTED;
-        return false;
-    }
-
     // Updates data members
     this->_parity = parity_p;
 
@@ -263,44 +222,6 @@ bool_t Usart0::setParity(const Parity parity_p)
     return true;
 }
 
-bool_t Usart0::setBaudRate(const BaudRate baudRate_p)
-{
-    // Resets data members
-    this->_isInitialized = false;
-
-    // Checks for errors
-    switch(baudRate_p) {
-    case Usart0::BaudRate::BAUD_RATE_600:
-    case Usart0::BaudRate::BAUD_RATE_1200:
-    case Usart0::BaudRate::BAUD_RATE_1800:
-    case Usart0::BaudRate::BAUD_RATE_2400:
-    case Usart0::BaudRate::BAUD_RATE_4800:
-    case Usart0::BaudRate::BAUD_RATE_9600:
-    case Usart0::BaudRate::BAUD_RATE_14400:
-    case Usart0::BaudRate::BAUD_RATE_19200:
-    case Usart0::BaudRate::BAUD_RATE_28800:
-    case Usart0::BaudRate::BAUD_RATE_38400:
-    case Usart0::BaudRate::BAUD_RATE_56000:
-    case Usart0::BaudRate::BAUD_RATE_57600:
-    case Usart0::BaudRate::BAUD_RATE_115200:
-    case Usart0::BaudRate::BAUD_RATE_128000:
-    case Usart0::BaudRate::BAUD_RATE_230400:
-    case Usart0::BaudRate::BAUD_RATE_256000:
-        break;
-    default:
-        // Returns error
-        this->_lastError = Error::USART_BAUD_RATE_NOT_SUPPORTED;
-        return false;
-    }
-
-    // Updates data members
-    this->_baudRate = baudRate_p;
-
-    // Returns successfully
-    this->_lastError = Error::NONE;
-    return true;
-}
-
 bool_t Usart0::setFrameFormat(const FrameFormat frameFormat_p)
 {
     // Local variables
@@ -309,45 +230,6 @@ bool_t Usart0::setFrameFormat(const FrameFormat frameFormat_p)
     // Resets data members
     this->_isInitialized = false;
 
-    // Checks for errors
-    switch(frameFormat_p) {
-    case Usart0::FrameFormat::FRAME_FORMAT_8_N_1:
-    case Usart0::FrameFormat::FRAME_FORMAT_8_O_1:
-    case Usart0::FrameFormat::FRAME_FORMAT_8_E_1:
-    case Usart0::FrameFormat::FRAME_FORMAT_8_N_2:
-    case Usart0::FrameFormat::FRAME_FORMAT_8_O_2:
-    case Usart0::FrameFormat::FRAME_FORMAT_8_E_2:
-    case Usart0::FrameFormat::FRAME_FORMAT_9_N_1:
-    case Usart0::FrameFormat::FRAME_FORMAT_9_O_1:
-    case Usart0::FrameFormat::FRAME_FORMAT_9_E_1:
-    case Usart0::FrameFormat::FRAME_FORMAT_9_N_2:
-    case Usart0::FrameFormat::FRAME_FORMAT_9_O_2:
-    case Usart0::FrameFormat::FRAME_FORMAT_9_E_2:
-    case Usart0::FrameFormat::FRAME_FORMAT_5_N_1:
-    case Usart0::FrameFormat::FRAME_FORMAT_5_O_1:
-    case Usart0::FrameFormat::FRAME_FORMAT_5_E_1:
-    case Usart0::FrameFormat::FRAME_FORMAT_5_N_2:
-    case Usart0::FrameFormat::FRAME_FORMAT_5_O_2:
-    case Usart0::FrameFormat::FRAME_FORMAT_5_E_2:
-    case Usart0::FrameFormat::FRAME_FORMAT_6_N_1:
-    case Usart0::FrameFormat::FRAME_FORMAT_6_O_1:
-    case Usart0::FrameFormat::FRAME_FORMAT_6_E_1:
-    case Usart0::FrameFormat::FRAME_FORMAT_6_N_2:
-    case Usart0::FrameFormat::FRAME_FORMAT_6_O_2:
-    case Usart0::FrameFormat::FRAME_FORMAT_6_E_2:
-    case Usart0::FrameFormat::FRAME_FORMAT_7_N_1:
-    case Usart0::FrameFormat::FRAME_FORMAT_7_O_1:
-    case Usart0::FrameFormat::FRAME_FORMAT_7_E_1:
-    case Usart0::FrameFormat::FRAME_FORMAT_7_N_2:
-    case Usart0::FrameFormat::FRAME_FORMAT_7_O_2:
-    case Usart0::FrameFormat::FRAME_FORMAT_7_E_2:
-        break;
-    default:
-        // Returns error
-        this->_lastError = Error::USART_FRAME_FORMAT_NOT_SUPPORTED;
-        return false;
-    }
-
     // Decodes frame format
     auxFrame = (uint8_t)frameFormat_p;
     switch(auxFrame & 0x03) {
@@ -512,6 +394,19 @@ void Usart0::flushReceptionBuffer(void)
 
 char Usart0::receiveDataStd(FILE *stream_p)
 {
+    // Local variables
+    char auxChar;
+
+    // Buffered mode - waits for the reception interrupt
+    if(this->_isBuffered) {
+        while(this->_rxHead == this->_rxTail) {
+            // Waits until data is received
+        }
+        auxChar = (char)this->_rxBuffer[this->_rxTail];
+        this->_rxTail = (this->_rxTail + 1) & (USART0_RX_BUFFER_SIZE - 1);
+        return auxChar;
+    }
+
     waitUntilBitIsSet(UCSR0A, RXC0);	// Waits until last reception ends
 
     return (int16_t)UDR0;
@@ -519,17 +414,212 @@ char Usart0::receiveDataStd(FILE *stream_p)
 
 int16_t Usart0::sendDataStd(char data_p, FILE *stream_p)
 {
+    // Local variables
+    uint8_t next;
+
+    // Buffered mode - copies to the buffer and returns
+    if(this->_isBuffered) {
+        next = (this->_txHead + 1) & (USART0_TX_BUFFER_SIZE - 1);
+        if(isBitSet(SREG, SREG_I)) {
+            while(next == this->_txTail) {
+                // Waits until the interrupt frees a position
+            }
+        } else if(next == this->_txTail) {
+            // Buffer full in an interrupt - drops the character, as the
+            // buffer cannot be emptied while the interrupts are disabled
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                if(this->_txOverrunCount != 0xFFFF) {
+                    this->_txOverrunCount++;
+                }
+            }
+            return 0;
+        }
+        this->_txBuffer[this->_txHead] = (uint8_t)data_p;
+        this->_txHead = next;
+        this->activateTransmissionBufferEmptyInterrupt();
+        return 0;
+    }
+
     waitUntilBitIsSet(UCSR0A, UDRE0);	// Waits until last transmission ends
     UDR0 = data_p;
 
     return 0;
 }
 
+void Usart0::setBufferedMode(cbool_t buffered_p)
+{
+    // Stops the interrupts while the buffers are reset
+    this->deactivateTransmissionBufferEmptyInterrupt();
+    this->deactivateReceptionCompleteInterrupt();
+    this->_txHead = 0;
+    this->_txTail = 0;
+    this->_rxHead = 0;
+    this->_rxTail = 0;
+    this->_isBuffered = buffered_p;
+
+    // Reception is always interrupt-driven in buffered mode
+    if(buffered_p) {
+        this->flushReceptionBuffer();
+        this->activateReceptionCompleteInterrupt();
+    }
+
+    return;
+}
+
+uint8_t Usart0::getReceivedCount(void)
+{
+    // Returns value
+    return (this->_rxHead - this->_rxTail) & (USART0_RX_BUFFER_SIZE - 1);
+}
+
+uint16_t Usart0::getTransmissionOverrunCount(void)
+{
+    // Local variables
+    uint16_t aux16;
+
+    // Read atomically
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        aux16 = this->_txOverrunCount;
+    }
+
+    // Returns value
+    return aux16;
+}
+
+uint16_t Usart0::getReceptionOverrunCount(void)
+{
+    // Local variables
+    uint16_t aux16;
+
+    // Read atomically
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        aux16 = this->_rxOverrunCount;
+    }
+
+    // Returns value
+    return aux16;
+}
+
+void Usart0::clearOverrunCounters(void)
+{
+    // Reset data members
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        this->_txOverrunCount = 0;
+        this->_rxOverrunCount = 0;
+    }
+
+    return;
+}
+
+void Usart0::receptionCompleteHandler(void)
+{
+    // Local variables
+    bool_t overrun = isBitSet(UCSR0A, DOR0);
+    uint8_t data = UDR0;
+    uint8_t next = (this->_rxHead + 1) & (USART0_RX_BUFFER_SIZE - 1);
+
+    // Stores data
+    if(next == this->_rxTail) {
+        overrun = true;
+    } else {
+        this->_rxBuffer[this->_rxHead] = data;
+        this->_rxHead = next;
+    }
+    if(overrun && (this->_rxOverrunCount != 0xFFFF)) {
+        this->_rxOverrunCount++;
+    }
+
+    return;
+}
+
+void Usart0::transmissionBufferEmptyHandler(void)
+{
+    // Nothing else to send
+    if(this->_txHead == this->_txTail) {
+        this->deactivateTransmissionBufferEmptyInterrupt();
+        return;
+    }
+
+    // Sends next byte
+    UDR0 = this->_txBuffer[this->_txTail];
+    this->_txTail = (this->_txTail + 1) & (USART0_TX_BUFFER_SIZE - 1);
+
+    return;
+}
+
+bool_t Usart0::setMultiprocessorMode(cbool_t enabled_p, cuint8_t nodeAddress_p)
+{
+    // Checks for errors
+    if(enabled_p && (nodeAddress_p == USART0_BROADCAST_ADDRESS)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+        return false;
+    }
+    if(enabled_p && (this->_dataSize != DataSize::DATA_9_BITS)) {
+        // Returns error
+        this->_lastError = Error::USART_DATA_SIZE_NOT_SUPPORTED;
+        return false;
+    }
+
+    // Updates data members and the address filter
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        this->_nodeAddress = nodeAddress_p;
+        this->_isMultiprocessor = enabled_p;
+        this->_setAddressFilter(enabled_p);
+    }
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    return true;
+}
+
+bool_t Usart0::sendAddress(cuint8_t nodeAddress_p)
+{
+    // Checks for errors
+    if(this->_dataSize != DataSize::DATA_9_BITS) {
+        // Returns error
+        this->_lastError = Error::USART_DATA_SIZE_NOT_SUPPORTED;
+        return false;
+    }
+
+    // Sends frame with bit 8 set
+    return this->sendData((1 << 8) | nodeAddress_p);
+}
+
+void Usart0::multiprocessorReceptionHandler(void)
+{
+    // Local variables
+    uint16_t frame;
+
+    // Bit 8 must be read before the data register
+    frame = (isBitSet(UCSR0B, RXB80)) ? (1 << 8) : 0;
+    frame |= UDR0;
+
+    // Address frame - selects or deselects this node
+    if(isBitSet(frame, 8)) {
+        if(((uint8_t)frame != this->_nodeAddress) && ((uint8_t)frame != USART0_BROADCAST_ADDRESS)) {
+            this->_setAddressFilter(true);
+            return;
+        }
+        this->_setAddressFilter(false);
+    }
+
+    // Hands frame to the user
+    usartAddressedReceptionCallback(frame);
+
+    return;
+}
+
 int usartTransmitStdWrapper(char c, FILE *f)
 {
     return usartDefaultHandler->sendDataStd(c, f);
 }
 
+int usartReceiveStdWrapper(FILE *f)
+{
+    return (uint8_t)usartDefaultHandler->receiveDataStd(f);
+}
+
 // =============================================================================
 // Interrupt callback functions
 // =============================================================================
@@ -549,6 +639,11 @@ weakened void usartTransmissionCompleteCallback(void)
     return;
 }
 
+weakened void usartAddressedReceptionCallback(uint16_t frame_p)
+{
+    return;
+}
+
 // =============================================================================
 // Interrupt handlers
 // =============================================================================
@@ -559,6 +654,14 @@ weakened void usartTransmissionCompleteCallback(void)
 //!
 ISR(USART_RX_vect)
 {
+    if(usart0.isMultiprocessorMode()) {
+        usart0.multiprocessorReceptionHandler();
+        return;
+    }
+    if(usart0.isBufferedMode()) {
+        usart0.receptionCompleteHandler();
+        return;
+    }
     usartReceptionCompleteCallback();
 }
 
@@ -577,6 +680,10 @@ ISR(USART_TX_vect)
 //!
 ISR(USART_UDRE_vect)
 {
+    if(usart0.isBufferedMode()) {
+        usart0.transmissionBufferEmptyHandler();
+        return;
+    }
     usartTransmissionBufferEmptyCallback();
 }
 
@@ -39,6 +39,8 @@
 #include "../util/systemStatus.hpp"
 
 extern FILE usartStream;
+class Usart0;
+extern Usart0 *usartDefaultHandler;
 
 // =============================================================================
 // Undefining previous definitions
@@ -50,7 +52,42 @@ extern FILE usartStream;
 // Constant definitions
 // =============================================================================
 
-// NONE
+#ifndef USART0_MAX_BAUD_ERROR
+//!
+//! \brief          Largest baud rate error accepted, in tenths of percent
+//! \details        Checked at compile time by Usart0::setBaudRate().
+//!
+#   define USART0_MAX_BAUD_ERROR        20
+#endif
+
+#ifndef USART0_TX_BUFFER_SIZE
+//!
+//! \brief          Transmission buffer size of the buffered mode
+//! \details        Must be a power of two, up to 128.
+//!
+#   define USART0_TX_BUFFER_SIZE        32
+#endif
+
+#ifndef USART0_RX_BUFFER_SIZE
+//!
+//! \brief          Reception buffer size of the buffered mode
+//! \details        Must be a power of two, up to 128.
+//!
+#   define USART0_RX_BUFFER_SIZE        16
+#endif
+
+//!
+//! \brief          Node address accepted by every node in multiprocessor mode
+//!
+#define USART0_BROADCAST_ADDRESS        0xFF
+
+#if (USART0_TX_BUFFER_SIZE > 128) || (USART0_TX_BUFFER_SIZE & (USART0_TX_BUFFER_SIZE - 1)) != 0
+#   error "USART0_TX_BUFFER_SIZE must be a power of two, up to 128!"
+#endif
+
+#if (USART0_RX_BUFFER_SIZE > 128) || (USART0_RX_BUFFER_SIZE & (USART0_RX_BUFFER_SIZE - 1)) != 0
+#   error "USART0_RX_BUFFER_SIZE must be a power of two, up to 128!"
+#endif
 
 // =============================================================================
 // New data types
@@ -65,7 +102,8 @@ extern FILE usartStream;
 //!
 //! \brief          USART Reception Complete interrupt callback function
 //! \details        This function is called when the USART Reception Complete
-//!                     interrupt is treated. It is a weak function that can be
+//!                     interrupt is treated, unless the buffered mode is
+//!                     enabled. It is a weak function that can be
 //!                     overwritten by user code.
 //!
 void usartReceptionCompleteCallback(void);
@@ -73,8 +111,9 @@ void usartReceptionCompleteCallback(void);
 //!
 //! \brief          USART Transmission Buffer Empty interrupt callback function
 //! \details        This function is called when the USART Transmission Buffer
-//!                     Empty interrupt is treated. It is a weak function that
-//!                     can be overwritten by user code.
+//!                     Empty interrupt is treated, unless the buffered mode
+//!                     is enabled. It is a weak function that can be
+//!                     overwritten by user code.
 //!
 void usartTransmissionBufferEmptyCallback(void);
 
@@ -86,6 +125,17 @@ void usartTransmissionBufferEmptyCallback(void);
 //!
 void usartTransmissionCompleteCallback(void);
 
+//!
+//! \brief          USART addressed reception callback function
+//! \details        This function is called from the USART Reception Complete
+//!                     interrupt in multiprocessor mode, for every frame
+//!                     that passed the address filter. Address frames have
+//!                     bit 8 set. It is a weak function that can be
+//!                     overwritten by user code.
+//! \param          frame_p             Received frame (9 bits)
+//!
+void usartAddressedReceptionCallback(uint16_t frame_p);
+
 // =============================================================================
 // Usart Class
 // =============================================================================
@@ -261,6 +311,7 @@ public:
         BAUD_RATE_14400                 = 14400UL,
         BAUD_RATE_19200                 = 19200UL,
         BAUD_RATE_28800                 = 28800UL,
+        BAUD_RATE_31250                 = 31250UL,      //!< MIDI
         BAUD_RATE_38400                 = 38400UL,
         BAUD_RATE_56000                 = 56000UL,
         BAUD_RATE_57600                 = 57600UL,
@@ -274,12 +325,11 @@ public:
 public:
     //!
     //! \brief      Usart0 class constructor
-    //! \details    Creates an Usart0 object
+    //! \details    Creates an Usart0 object, configured to 9600 bps,
+    //!                 asynchronous mode, 8N1.
     //!
     Usart0(
-            BaudRate baudRate_p = BaudRate::BAUD_RATE_9600,
-            Mode mode_p = Mode::ASYNCHRONOUS,
-            FrameFormat format = FrameFormat::FRAME_FORMAT_8_N_1
+            void
     );
 
     //!
@@ -337,6 +387,17 @@ public:
             const DataSize dataSize_p
     );
 
+    //!
+    //! \brief      Sets the operation mode
+    //! \details    Changes between modes with the same clock prescaler (the
+    //!                 synchronous and SPI modes among themselves), keeping
+    //!                 the baud rate checked at compile time. Changing to or
+    //!                 from the asynchronous and double speed modes fails
+    //!                 with MODE_NOT_SUPPORTED; setBaudRate<baudRate, mode>()
+    //!                 must be used instead.
+    //! \param      mode_p              Operation mode
+    //! \return     bool_t              True on success / False on failure
+    //!
     bool_t setMode(
             const Mode mode_p
     );
@@ -349,8 +410,19 @@ public:
             const Parity parity_p
     );
 
-    bool_t setBaudRate(
-            const BaudRate baudRate_p
+    //!
+    //! \brief      Sets the baud rate
+    //! \details    Sets the baud rate and the operation mode. The baud rate
+    //!                 divisor is computed at compile time from F_CPU, and
+    //!                 the build fails if the resulting baud rate error is
+    //!                 larger than USART0_MAX_BAUD_ERROR for the given mode.
+    //! \tparam     baudRate_p          Baud rate
+    //! \tparam     mode_p              Operation mode
+    //! \return     bool_t              True on success / False on failure
+    //!
+    template <BaudRate baudRate_p, Mode mode_p = Mode::ASYNCHRONOUS>
+    bool_t inlined setBaudRate(
+            void
     );
 
     bool_t setFrameFormat(
@@ -430,12 +502,166 @@ public:
 
     //!
     //! \brief      Redirects standard i/o streams
-    //! \details    Redirects standard i/o streams.
+    //! \details    Redirects standard i/o streams (printf, scanf and the
+    //!                 like) to this USART. In buffered mode the streams
+    //!                 only copy data to and from the buffers.
     //!
     void inlined stdio(void);
 
-    // UCSRA    U2X0
-    // UCSRA    MPCM0
+    //     ///////////////////     BUFFERED MODE    /////////////////////     //
+
+    //!
+    //! \brief      Enables or disables the buffered mode
+    //! \details    In buffered mode the standard i/o streams use ring
+    //!                 buffers filled and emptied by the Reception Complete
+    //!                 and Transmission Buffer Empty interrupts, which no
+    //!                 longer call the user callbacks. Writing to a full
+    //!                 transmission buffer waits for a free position; only
+    //!                 when the global interrupts are disabled (inside an
+    //!                 interrupt handler, for instance), which would never
+    //!                 free it, is the character dropped. Data received with
+    //!                 the reception buffer full is lost. Both losses are
+    //!                 counted. Disabling the buffered mode discards the
+    //!                 pending data. Global interrupts must be enabled by the
+    //!                 user.
+    //! \param      buffered_p          True to enable / False to disable
+    //!
+    void setBufferedMode(
+            cbool_t buffered_p
+    );
+
+    //!
+    //! \brief      Returns the number of bytes waiting in the reception
+    //!                 buffer
+    //! \details    Returns the number of bytes waiting in the reception
+    //!                 buffer.
+    //! \return     uint8_t             Number of bytes
+    //!
+    uint8_t getReceivedCount(
+            void
+    );
+
+    //!
+    //! \brief      Returns the number of dropped transmission bytes
+    //! \details    Returns the number of bytes dropped because the
+    //!                 transmission buffer was full while the global
+    //!                 interrupts were disabled. The counter saturates at
+    //!                 0xFFFF.
+    //! \return     uint16_t            Dropped bytes
+    //!
+    uint16_t getTransmissionOverrunCount(
+            void
+    );
+
+    //!
+    //! \brief      Returns the number of lost reception bytes
+    //! \details    Returns the number of bytes lost because the reception
+    //!                 buffer was full or the USART reported a data overrun.
+    //!                 The counter saturates at 0xFFFF.
+    //! \return     uint16_t            Lost bytes
+    //!
+    uint16_t getReceptionOverrunCount(
+            void
+    );
+
+    //!
+    //! \brief      Clears the overrun counters
+    //! \details    Clears the overrun counters.
+    //!
+    void clearOverrunCounters(
+            void
+    );
+
+    //!
+    //! \brief      Reception Complete interrupt handler
+    //! \details    Stores the received byte in the reception buffer. Called
+    //!                 from the USART_RX interrupt in buffered mode.
+    //!
+    void receptionCompleteHandler(
+            void
+    );
+
+    //!
+    //! \brief      Transmission Buffer Empty interrupt handler
+    //! \details    Sends the next byte of the transmission buffer. Called
+    //!                 from the USART_UDRE interrupt in buffered mode.
+    //!
+    void transmissionBufferEmptyHandler(
+            void
+    );
+
+    //!
+    //! \brief      Checks if the buffered mode is enabled
+    //! \details    Checks if the buffered mode is enabled.
+    //! \return     bool_t              True if enabled / False otherwise
+    //!
+    bool_t inlined isBufferedMode(
+            void
+    );
+
+    //     ////////////////     MULTIPROCESSOR MODE    //////////////////     //
+
+    //!
+    //! \brief      Enables or disables the multiprocessor mode
+    //! \details    In multiprocessor mode (9-bit frames, bit 8 marks an
+    //!                 address frame) the USART hardware ignores data frames
+    //!                 until an address frame carrying the node address, or
+    //!                 USART0_BROADCAST_ADDRESS, arrives. The frames that pass
+    //!                 are handed to \ref{usartAddressedReceptionCallback}
+    //!                 from the Reception Complete interrupt, which must be
+    //!                 activated by the user; the user callback is not
+    //!                 called. An address frame for another node turns the
+    //!                 filter back on. The data size must be set to 9 bits.
+    //! \param      enabled_p           True to enable / False to disable
+    //! \param      nodeAddress_p       Node address (0 to 254)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t setMultiprocessorMode(
+            cbool_t enabled_p,
+            cuint8_t nodeAddress_p = 0
+    );
+
+    //!
+    //! \brief      Checks if the multiprocessor mode is enabled
+    //! \details    Checks if the multiprocessor mode is enabled.
+    //! \return     bool_t              True if enabled / False otherwise
+    //!
+    bool_t inlined isMultiprocessorMode(
+            void
+    );
+
+    //!
+    //! \brief      Turns the address filter on
+    //! \details    Makes the hardware ignore data frames again until the
+    //!                 next matching address frame. Usually called when the
+    //!                 end of the addressed packet is received.
+    //!
+    void inlined activateAddressFilter(
+            void
+    );
+
+    //!
+    //! \brief      Sends an address frame
+    //! \details    Sends a frame with bit 8 set, selecting the node that
+    //!                 will receive the next data frames.
+    //! \param      nodeAddress_p       Node address (0 to 254, or
+    //!                                     USART0_BROADCAST_ADDRESS)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t sendAddress(
+            cuint8_t nodeAddress_p
+    );
+
+    //!
+    //! \brief      Multiprocessor mode Reception Complete interrupt handler
+    //! \details    Applies the address filter and calls
+    //!                 \ref{usartAddressedReceptionCallback}. Called from the
+    //!                 USART_RX interrupt in multiprocessor mode.
+    //!
+    void multiprocessorReceptionHandler(
+            void
+    );
+
 
     bool_t sendData(cuint16_t data_p);
     bool_t receiveData(uint16_t *data_p);
@@ -445,10 +671,25 @@ public:
 
 
 private:
+    static constexpr uint16_t _computeDivisor(
+            const BaudRate baudRate_p
+    );
+    static constexpr uint8_t _getPrescalerShift(
+            const Mode mode_p
+    );
+    static constexpr uint16_t _computeUbrr(
+            cuint16_t divisor_p,
+            cuint8_t shift_p
+    );
+    static constexpr int32_t _computeBaudError(
+            const BaudRate baudRate_p,
+            const Mode mode_p
+    );
     char _receiveDataStd(FILE *stream_p);
     void _clearDataOverrunError(void);
     void _clearFrameError(void);
     void _clearParityError(void);
+    void inlined _setAddressFilter(cbool_t enabled_p);
 
     // -------------------------------------------------------------------------
     // Properties --------------------------------------------------------------
@@ -471,14 +712,76 @@ private:
     DataSize        _dataSize;
     Mode            _mode;
     BaudRate        _baudRate;
+    uint16_t        _baudDivisor;       // F_CPU / (2 * baud rate), rounded
     Parity          _parity;
     StopBits        _stopBits;
+
+    //     ///////////////////     BUFFERED MODE    /////////////////////     //
+    vbool_t         _isBuffered;
+    uint8_t         _txBuffer[USART0_TX_BUFFER_SIZE];
+    vuint8_t        _txHead;
+    vuint8_t        _txTail;
+    uint8_t         _rxBuffer[USART0_RX_BUFFER_SIZE];
+    vuint8_t        _rxHead;
+    vuint8_t        _rxTail;
+    vuint16_t       _txOverrunCount;
+    vuint16_t       _rxOverrunCount;
+
+    //     ////////////////     MULTIPROCESSOR MODE    //////////////////     //
+    vbool_t         _isMultiprocessor;
+    uint8_t         _nodeAddress;
 }; // class Usart0
 
 // =============================================================================
 // Class inlined functions
 // =============================================================================
 
+constexpr uint16_t Usart0::_computeDivisor(const BaudRate baudRate_p)
+{
+    return (uint16_t)((F_CPU + (uint32_t)baudRate_p) / (2 * (uint32_t)baudRate_p));
+}
+
+constexpr uint8_t Usart0::_getPrescalerShift(const Mode mode_p)
+{
+    return (mode_p == Mode::ASYNCHRONOUS) ? 3 : (mode_p == Mode::ASYNCHRONOUS_DOUBLE_SPEED) ? 2 : 0;
+}
+
+constexpr uint16_t Usart0::_computeUbrr(cuint16_t divisor_p, cuint8_t shift_p)
+{
+    return (uint16_t)(((divisor_p + ((1 << shift_p) >> 1)) >> shift_p) - 1);
+}
+
+constexpr int32_t Usart0::_computeBaudError(const BaudRate baudRate_p, const Mode mode_p)
+{
+    return (int32_t)(((uint64_t)F_CPU * 1000) / ((uint64_t)(2UL << _getPrescalerShift(mode_p)) *
+                            (_computeUbrr(_computeDivisor(baudRate_p), _getPrescalerShift(mode_p)) + 1) *
+                            (uint32_t)baudRate_p)) - 1000;
+}
+
+template <Usart0::BaudRate baudRate_p, Usart0::Mode mode_p>
+bool_t inlined Usart0::setBaudRate(void)
+{
+    static_assert(_computeDivisor(baudRate_p) >= 1,
+            "Baud rate too high for F_CPU!");
+    static_assert(_computeUbrr(_computeDivisor(baudRate_p), _getPrescalerShift(mode_p)) <= 4095,
+            "Baud rate too low for F_CPU!");
+    static_assert((_computeBaudError(baudRate_p, mode_p) <= USART0_MAX_BAUD_ERROR) &&
+            (_computeBaudError(baudRate_p, mode_p) >= -USART0_MAX_BAUD_ERROR),
+            "Baud rate error too high for F_CPU!");
+
+    // Resets data members
+    this->_isInitialized = false;
+
+    // Updates data members
+    this->_baudRate = baudRate_p;
+    this->_baudDivisor = _computeDivisor(baudRate_p);
+    this->_mode = mode_p;
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    return true;
+}
+
 void inlined Usart0::disableReceiver(void)
 {
     clrBit(UCSR0B, RXEN0);
@@ -556,10 +859,35 @@ void inlined Usart0::deactivateTransmissionCompleteInterrupt(void)
 
 void inlined Usart0::stdio(void)
 {
+    usartDefaultHandler = this;
     stdin = stdout = stderr = &usartStream;
     return;
 }
 
+bool_t inlined Usart0::isBufferedMode(void)
+{
+    return this->_isBuffered;
+}
+
+bool_t inlined Usart0::isMultiprocessorMode(void)
+{
+    return this->_isMultiprocessor;
+}
+
+void inlined Usart0::activateAddressFilter(void)
+{
+    this->_setAddressFilter(true);
+    return;
+}
+
+void inlined Usart0::_setAddressFilter(cbool_t enabled_p)
+{
+    // Not a read-modify-write of the whole register: writing back TXC0 would
+    // clear it, and FE0, DOR0 and UPE0 must be written as zero
+    UCSR0A = (UCSR0A & (1 << U2X0)) | ((enabled_p) ? (1 << MPCM0) : 0);
+    return;
+}
+
 Usart0::ReceptionError inlined operator|(Usart0::ReceptionError a, Usart0::ReceptionError b)
 {
     return static_cast<Usart0::ReceptionError>(static_cast<cuint8_t>(a) | static_cast<cuint8_t>(b));
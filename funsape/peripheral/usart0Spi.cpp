@@ -0,0 +1,329 @@
+//!
+//! \file           usart0Spi.cpp
+//! \brief          USART0 in Master SPI mode for the FunSAPE AVR8 Library
+//! \author         Leandro Schwarz (bladabuska+funsapeavr8lib@gmail.com)
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        USART0 in Master SPI mode for the FunSAPE AVR8 Library
+//!
+
+// =============================================================================
+// System file dependencies
+// =============================================================================
+
+#include "usart0Spi.hpp"
+#if !defined(__USART0_SPI_HPP)
+#    error "Header file is corrupted!"
+#elif __USART0_SPI_HPP != 2304
+#    error "Version mismatch between source and header files!"
+#endif
+
+// =============================================================================
+// File exclusive - Constants
+// =============================================================================
+
+#define USART0_SPI_MAX_UBRR             4095
+
+// =============================================================================
+// File exclusive - New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// File exclusive - Global variables
+// =============================================================================
+
+Usart0Spi usart0Spi;
+
+// =============================================================================
+// File exclusive - Macro-functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Class constructors
+// =============================================================================
+
+Usart0Spi::Usart0Spi(void)
+{
+    // Reset data members
+    this->_initialized = false;
+    this->_devSelectSet = false;
+    this->_ubrr = 0;
+    this->_activateDevice = nullptr;
+    this->_deactivateDevice = nullptr;
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    return;
+}
+
+Usart0Spi::~Usart0Spi(void)
+{
+    // Returns successfully
+    return;
+}
+
+// =============================================================================
+// Class public methods - Inhirited methods
+// =============================================================================
+
+Bus::BusType Usart0Spi::getBusType(void)
+{
+    // Returns bus type
+    return Bus::BusType::SPI;
+}
+
+bool_t Usart0Spi::readReg(cuint8_t reg_p, uint8_t *buffData_p, cuint16_t buffSize_p)
+{
+    // Check for errors
+    if(!this->_initialized) {
+        this->_lastError = Error::NOT_INITIALIZED;
+        return false;
+    }
+    if(!this->_devSelectSet) {
+        // Error - Device select functions not set
+        this->_lastError = Error::COMMUNICATION_NO_DEVICE_SELECTED;
+        return false;
+    }
+    if((buffSize_p > 0) && (buffData_p == nullptr)) {
+        this->_lastError = Error::ARGUMENT_POINTER_NULL;
+        return false;
+    }
+
+    // Send register address, then clock the data in
+    this->_activateDevice();
+    this->_transfer(&reg_p, nullptr, 1);
+    this->_transfer(nullptr, buffData_p, buffSize_p);
+    this->_deactivateDevice();
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    return true;
+}
+
+bool_t Usart0Spi::writeReg(cuint8_t reg_p, cuint8_t *buffData_p, cuint16_t buffSize_p)
+{
+    // Check for errors
+    if(!this->_initialized) {
+        this->_lastError = Error::NOT_INITIALIZED;
+        return false;
+    }
+    if(!this->_devSelectSet) {
+        // Error - Device select functions not set
+        this->_lastError = Error::COMMUNICATION_NO_DEVICE_SELECTED;
+        return false;
+    }
+    if((buffSize_p > 0) && (buffData_p == nullptr)) {
+        this->_lastError = Error::ARGUMENT_POINTER_NULL;
+        return false;
+    }
+
+    // Send register address, then the data
+    this->_activateDevice();
+    this->_transfer(&reg_p, nullptr, 1);
+    this->_transfer(buffData_p, nullptr, buffSize_p);
+    this->_deactivateDevice();
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    return true;
+}
+
+bool_t Usart0Spi::sendData(uint8_t *buffData_p, cuint16_t buffSize_p)
+{
+    // Exchange data in place
+    return this->sendData(buffData_p, buffData_p, buffSize_p);
+}
+
+bool_t Usart0Spi::sendData(cuint8_t *txBuffData_p, uint8_t *rxBuffData_p, cuint16_t buffSize_p)
+{
+    // Check for errors
+    if(!this->_initialized) {
+        this->_lastError = Error::NOT_INITIALIZED;
+        return false;
+    }
+    if(!this->_devSelectSet) {
+        // Error - Device select functions not set
+        this->_lastError = Error::COMMUNICATION_NO_DEVICE_SELECTED;
+        return false;
+    }
+    if(buffSize_p == 0) {
+        this->_lastError = Error::ARGUMENT_CANNOT_BE_ZERO;
+        return false;
+    }
+    if((txBuffData_p == nullptr) && (rxBuffData_p == nullptr)) {
+        this->_lastError = Error::ARGUMENT_POINTER_NULL;
+        return false;
+    }
+
+    // Exchange data
+    this->_activateDevice();
+    this->_transfer(txBuffData_p, rxBuffData_p, buffSize_p);
+    this->_deactivateDevice();
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    return true;
+}
+
+bool_t Usart0Spi::setDevice(void (* actFunc_p)(void), void (* deactFunc_p)(void))
+{
+    // Check for errors
+    if((actFunc_p == nullptr) || (deactFunc_p == nullptr)) {
+        this->_lastError = Error::FUNCTION_POINTER_NULL;
+        return false;
+    }
+
+    // Update data members
+    this->_activateDevice = actFunc_p;
+    this->_deactivateDevice = deactFunc_p;
+    this->_devSelectSet = true;
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    return true;
+}
+
+// =============================================================================
+// Class public methods - Own methods
+// =============================================================================
+
+bool_t Usart0Spi::init(cuint32_t clockSpeed_p, const Usart0::Mode mode_p, cbool_t lsbFirst_p)
+{
+    // Local variables
+    uint32_t aux32 = systemStatus.getCpuClock();
+    uint8_t ucsr0c = (3 << UMSEL00);
+
+    // Check for errors - XCK0 (PD4) driven as a GPIO by someone else
+    if(!this->_initialized && isBitSet(DDRD, DDD4)) {
+        this->_lastError = Error::BUSY;
+        return false;
+    }
+    // Check for errors - Clock speed
+    if(clockSpeed_p == 0) {
+        this->_lastError = Error::CLOCK_SPEED_TOO_LOW;
+        return false;
+    } else if(clockSpeed_p > (aux32 / 2)) {
+        this->_lastError = Error::CLOCK_SPEED_TOO_HIGH;
+        return false;
+    }
+
+    // Evaluate UBRR (rounded up, so the clock never exceeds the request)
+    aux32 = (aux32 + (2 * clockSpeed_p) - 1) / (2 * clockSpeed_p) - 1;
+    if(aux32 > USART0_SPI_MAX_UBRR) {
+        this->_lastError = Error::CLOCK_SPEED_TOO_LOW;
+        return false;
+    }
+
+    // Check for errors - Mode
+    switch(mode_p) {
+    case Usart0::Mode::MASTER_SPI_MODE_0:
+        break;
+    case Usart0::Mode::MASTER_SPI_MODE_1:
+        setBit(ucsr0c, UCPHA0);
+        break;
+    case Usart0::Mode::MASTER_SPI_MODE_2:
+        setBit(ucsr0c, UCPOL0);
+        break;
+    case Usart0::Mode::MASTER_SPI_MODE_3:
+        setBit(ucsr0c, UCPOL0);
+        setBit(ucsr0c, UCPHA0);
+        break;
+    default:
+        this->_lastError = Error::MODE_NOT_SUPPORTED;
+        return false;
+    }
+    if(lsbFirst_p) {
+        setBit(ucsr0c, UDORD0);
+    }
+
+    // Configure USART registers (sequence from the datasheet: the baud rate
+    // must be zero while the transmitter is enabled)
+    this->_initialized = false;
+    UCSR0B = 0;
+    UBRR0H = 0;
+    UBRR0L = 0;
+    setBit(DDRD, DDD4);                 // XCK0 is the SPI clock output
+    UCSR0C = ucsr0c;
+    UCSR0B = (1 << RXEN0) | (1 << TXEN0);
+    this->_ubrr = (uint16_t)aux32;
+    UBRR0H = (uint8_t)(this->_ubrr >> 8);
+    UBRR0L = (uint8_t)(this->_ubrr & 0xFF);
+    this->_initialized = true;
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    return true;
+}
+
+uint32_t Usart0Spi::getClockSpeed(void)
+{
+    // Returns the clock speed
+    return systemStatus.getCpuClock() / (2 * ((uint32_t)this->_ubrr + 1));
+}
+
+Error Usart0Spi::getLastError(void)
+{
+    // Returns last error
+    return this->_lastError;
+}
+
+// =============================================================================
+// Class private methods
+// =============================================================================
+
+void Usart0Spi::_transfer(cuint8_t *txBuffData_p, uint8_t *rxBuffData_p, cuint16_t buffSize_p)
+{
+    // Local variables
+    uint8_t aux8;
+
+    // Discard stale received data
+    while(isBitSet(UCSR0A, RXC0)) {
+        aux8 = UDR0;
+    }
+
+    // Start the first byte; the next one is queued while it is shifted
+    if(buffSize_p == 0) {
+        return;
+    }
+    UDR0 = (txBuffData_p != nullptr) ? txBuffData_p[0] : USART0_SPI_DUMMY_BYTE;
+    for(uint16_t i = 0; i < buffSize_p; i++) {
+        if((i + 1) < buffSize_p) {
+            waitUntilBitIsSet(UCSR0A, UDRE0);
+            UDR0 = (txBuffData_p != nullptr) ? txBuffData_p[i + 1] : USART0_SPI_DUMMY_BYTE;
+        }
+        waitUntilBitIsSet(UCSR0A, RXC0);
+        aux8 = UDR0;
+        if(rxBuffData_p != nullptr) {
+            rxBuffData_p[i] = aux8;
+        }
+    }
+
+    return;
+}
+
+// =============================================================================
+// Class protected methods
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// General public functions definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
@@ -0,0 +1,262 @@
+//!
+//! \file           usart0Spi.hpp
+//! \brief          USART0 in Master SPI mode for the FunSAPE AVR8 Library
+//! \author         Leandro Schwarz (bladabuska+funsapeavr8lib@gmail.com)
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Bus handler that drives the USART0 in Master SPI mode
+//!                     (MSPIM), giving a second SPI port with clock up to
+//!                     F_CPU/2 and double-buffered transmission. XCK0 (PD4)
+//!                     is the clock, TXD0 (PD1) is MOSI and RXD0 (PD0) is
+//!                     MISO. The USART0 hardware is shared with the Usart0
+//!                     class, so only one of them may be used at a time.
+//!                     PD4 is also a plain GPIO on many boards (the MIDI
+//!                     board drives the VS1053 reset line with it), so
+//!                     init() refuses to take a PD4 already configured as an
+//!                     output by someone else.
+//!
+
+// =============================================================================
+// Include guard (START)
+// =============================================================================
+
+#ifndef __USART0_SPI_HPP
+#define __USART0_SPI_HPP                        2304
+
+// =============================================================================
+// Dependencies
+// =============================================================================
+
+//     /////////////////     GLOBAL DEFINITIONS FILE    /////////////////     //
+#include "../globalDefines.hpp"
+#if !defined(__GLOBAL_DEFINES_HPP)
+#    error "Global definitions file is corrupted!"
+#elif __GLOBAL_DEFINES_HPP != __USART0_SPI_HPP
+#    error "Version mismatch between file header and global definitions file!"
+#endif
+
+//     //////////////////     LIBRARY DEPENDENCIES     //////////////////     //
+#include "../util/debug.hpp"
+#if !defined(__DEBUG_HPP)
+#   error "Header file (debug.hpp) is corrupted!"
+#elif __DEBUG_HPP != __USART0_SPI_HPP
+#   error "Version mismatch between header file and library dependency (debug.hpp)!"
+#endif
+
+#include "../util/bus.hpp"
+#if !defined(__BUS_HPP)
+#   error "Header file (bus.hpp) is corrupted!"
+#elif __BUS_HPP != __USART0_SPI_HPP
+#   error "Version mismatch between header file and library dependency (bus.hpp)!"
+#endif
+
+#include "../util/systemStatus.hpp"
+#if !defined(__SYSTEM_STATUS_HPP)
+#   error "Header file (systemStatus.hpp) is corrupted!"
+#elif __SYSTEM_STATUS_HPP != __USART0_SPI_HPP
+#   error "Version mismatch between header file and library dependency (systemStatus.hpp)!"
+#endif
+
+#include "usart0.hpp"
+#if !defined(__USART0_HPP)
+#   error "Header file (usart0.hpp) is corrupted!"
+#elif __USART0_HPP != __USART0_SPI_HPP
+#   error "Version mismatch between header file and library dependency (usart0.hpp)!"
+#endif
+
+// =============================================================================
+// Undefining previous definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Constant definitions
+// =============================================================================
+
+//!
+//! \brief          Byte clocked out when there is no data to send
+//!
+#define USART0_SPI_DUMMY_BYTE           0xFF
+
+// =============================================================================
+// New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Usart0Spi Class
+// =============================================================================
+
+//!
+//! \brief          Usart0Spi class
+//! \details        Transfers are blocking and polled: the transmit buffer
+//!                     is refilled while the previous byte is still being
+//!                     shifted, so the clock runs back to back for the whole
+//!                     block. The slave select functions set by setDevice()
+//!                     are called around every transfer.
+//!
+class Usart0Spi : public Bus
+{
+    // -------------------------------------------------------------------------
+    // New data types ----------------------------------------------------------
+public:
+    // NONE
+
+private:
+    // NONE
+
+protected:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Constructors ------------------------------------------------------------
+public:
+    //!
+    //! \brief      Usart0Spi class constructor
+    //! \details    Creates an Usart0Spi object
+    //!
+    Usart0Spi(
+            void
+    );
+
+    //!
+    //! \brief      Usart0Spi class destructor
+    //! \details    Destroys an Usart0Spi object
+    //!
+    ~Usart0Spi(
+            void
+    );
+
+    // -------------------------------------------------------------------------
+    // Methods - Inherited methods ---------------------------------------------
+public:
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+    Bus::BusType getBusType(
+            void
+    );
+
+    //     ////////////////////    DATA TRANSFER     ////////////////////     //
+    bool_t readReg(
+            cuint8_t reg_p,
+            uint8_t *buffData_p,
+            cuint16_t buffSize_p = 1
+    );
+    bool_t writeReg(
+            cuint8_t reg_p,
+            cuint8_t *buffData_p,
+            cuint16_t buffSize_p = 1
+    );
+    bool_t sendData(
+            uint8_t *buffData_p,
+            cuint16_t buffSize_p
+    );
+    bool_t sendData(
+            cuint8_t *txBuffData_p,
+            uint8_t *rxBuffData_p,
+            cuint16_t buffSize_p
+    );
+
+    //     //////////////////    PROTOCOL SPECIFIC     //////////////////     //
+    bool_t setDevice(
+            void (* actFunc_p)(void),
+            void (* deactFunc_p)(void)
+    );
+
+    // -------------------------------------------------------------------------
+    // Methods - Class own methods ---------------------------------------------
+public:
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+    //!
+    //! \brief      Initializes the USART0 in Master SPI mode
+    //! \details    Configures the USART0 as SPI master. The clock is the
+    //!                 fastest one not above the requested speed, from
+    //!                 F_CPU/2 down to F_CPU/8192. XCK0 (PD4) becomes the
+    //!                 clock output, so the first call fails with
+    //!                 Error::BUSY if PD4 is already an output, as it is
+    //!                 then in use as a GPIO (a reset or chip select line,
+    //!                 for instance) and would be toggled by the clock.
+    //! \param      clockSpeed_p        Clock speed, in Hz
+    //! \param      mode_p              SPI mode (Usart0::Mode::MASTER_SPI_MODE_0
+    //!                                     to Usart0::Mode::MASTER_SPI_MODE_3)
+    //! \param      lsbFirst_p          True to send the LSB first / False to
+    //!                                     send the MSB first
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t init(
+            cuint32_t clockSpeed_p      = 1'000'000,
+            const Usart0::Mode mode_p   = Usart0::Mode::MASTER_SPI_MODE_0,
+            cbool_t lsbFirst_p          = false
+    );
+
+    //!
+    //! \brief      Returns the actual clock speed
+    //! \details    Returns the clock speed set by the last init() call.
+    //! \return     uint32_t            Clock speed, in Hz
+    //!
+    uint32_t getClockSpeed(
+            void
+    );
+
+    Error getLastError(
+            void
+    );
+
+private:
+    //     ////////////////////    DATA TRANSFER     ////////////////////     //
+    void _transfer(
+            cuint8_t *txBuffData_p,
+            uint8_t *rxBuffData_p,
+            cuint16_t buffSize_p
+    );
+
+protected:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Properties --------------------------------------------------------------
+public:
+    // NONE
+
+private:
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+    bool_t              _initialized                    : 1;
+    bool_t              _devSelectSet                   : 1;
+    uint16_t            _ubrr;
+    Error               _lastError;
+
+    //     //////////////////    PROTOCOL SPECIFIC     //////////////////     //
+    void (*_activateDevice)(void);
+    void (*_deactivateDevice)(void);
+
+}; // class Usart0Spi
+
+// =============================================================================
+// Usart0Spi - Class inline function definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Extern global variables
+// =============================================================================
+
+extern Usart0Spi usart0Spi;
+
+// =============================================================================
+// Include guard (END)
+// =============================================================================
+
+#endif  // __USART0_SPI_HPP
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
@@ -222,6 +222,31 @@ public:
         return false;
     };
 
+    //!
+    //! \brief          Starts reading data from an address.
+    //! \details        This function starts reading a block of data from the
+    //!                     given register address and returns immediately.
+    //!                     The data vector is filled in background and must
+    //!                     not be used until \ref{isBusy} returns false.
+    //! \param[in]      reg_p           register address
+    //! \param[out]     buffData_p      pointer to data vector
+    //! \param[in]      buffSize_p      number of data elements to read
+    //! \return         bool_t          True on success / False on failure
+    //!
+    virtual bool_t readRegAsync(
+            cuint8_t reg_p,
+            uint8_t *buffData_p,
+            cuint16_t buffSize_p
+    ) {
+        // Mark passage for debugging purpose
+        debugMark("Bus::readRegAsync(cuint8_t, uint8_t *, cuint16_t)", DEBUG_BUS);
+
+        // Returns error
+        this->_lastError = Error::FEATURE_NOT_SUPPORTED;
+        debugMessage(Error::FEATURE_NOT_SUPPORTED, DEBUG_BUS);
+        return false;
+    };
+
     //     ////////////////     TWI PROTOCOL METHODS     ////////////////     //
     //!
     //! \brief          Sets the device slave address.
@@ -296,6 +321,18 @@ public:
         return BusType::NONE;
     }
 
+    //!
+    //! \brief          Checks if an asynchronous transfer is in progress.
+    //! \details        This function checks if an asynchronous transfer is in
+    //!                     progress. When the transfer is over, the last error
+    //!                     is updated with its result.
+    //! \return         bool_t          True if busy / False otherwise
+    //!
+    virtual bool_t isBusy(void) {
+        // Returns default status
+        return false;
+    }
+
     //!
     //! \brief          Retuns the last error.
     //! \details        This function returns the error code associated with the
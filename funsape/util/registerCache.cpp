@@ -0,0 +1,599 @@
+//!
+//! \file           registerCache.cpp
+//! \brief          Register cache for bus attached devices
+//! \author         Leandro Schwarz (bladabuska+funsapeavr8lib@gmail.com)
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Register cache for bus attached devices
+//!
+
+// =============================================================================
+// System file dependencies
+// =============================================================================
+
+#include "registerCache.hpp"
+#if !defined(__REGISTER_CACHE_HPP)
+#    error "Header file is corrupted!"
+#elif __REGISTER_CACHE_HPP != 2304
+#    error "Version mismatch between source and header files!"
+#endif
+
+// =============================================================================
+// File exclusive - Constants
+// =============================================================================
+
+#define DEBUG_REGISTER_CACHE            0x2FFF
+
+// =============================================================================
+// File exclusive - New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// File exclusive - Global variables
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// File exclusive - Macro-functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Class constructors
+// =============================================================================
+
+RegisterCache::RegisterCache(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("RegisterCache::RegisterCache(void)", DEBUG_REGISTER_CACHE);
+
+    // Reset data members
+    this->_busHandler                   = nullptr;
+    this->_deviceAddress                = 0;
+    this->_deviceSelected               = false;
+    this->_useLongAddress               = false;
+    this->_entriesUsed                  = 0;
+
+    // Returns successfully
+    this->_lastError                    = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_REGISTER_CACHE);
+    return;
+}
+
+RegisterCache::~RegisterCache(void)
+{
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_REGISTER_CACHE);
+    return;
+}
+
+// =============================================================================
+// Class public methods - Inhirited methods
+// =============================================================================
+
+//     /////////////////     CONTROL AND STATUS     /////////////////     //
+Bus::BusType RegisterCache::getBusType(void)
+{
+    // Returns the type of the attached bus
+    if(!isPointerValid(this->_busHandler)) {
+        return Bus::BusType::NONE;
+    }
+    return this->_busHandler->getBusType();
+}
+
+bool_t RegisterCache::isBusy(void)
+{
+    // Checks initialization
+    if(!isPointerValid(this->_busHandler)) {
+        return false;
+    }
+
+    // Take the result of the asynchronous transfer when it is over
+    if(this->_busHandler->isBusy()) {
+        return true;
+    }
+    this->_lastError = this->_busHandler->getLastError();
+    return false;
+}
+
+Error RegisterCache::getLastError(void)
+{
+    // Returns last error
+    return this->_lastError;
+}
+
+//     ////////////////////    DATA TRANSFER     ////////////////////     //
+bool_t RegisterCache::readReg(cuint8_t reg_p, uint8_t *buffData_p, cuint16_t buffSize_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("RegisterCache::readReg(cuint8_t, uint8_t *, cuint16_t)", DEBUG_REGISTER_CACHE);
+
+    // Local variables
+    Entry *entry = nullptr;
+    bool_t cacheHit = (buffSize_p != 0);
+
+    // Checks for errors
+    if(!isPointerValid(this->_busHandler)) {
+        // Returns error
+        this->_lastError = Error::NOT_INITIALIZED;
+        debugMessage(Error::NOT_INITIALIZED, DEBUG_REGISTER_CACHE);
+        return false;
+    }
+    if(!isPointerValid(buffData_p)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_POINTER_NULL;
+        debugMessage(Error::ARGUMENT_POINTER_NULL, DEBUG_REGISTER_CACHE);
+        return false;
+    }
+
+    // Serve from the cache when all registers are held
+    for(uint16_t i = 0; i < buffSize_p; i++) {
+        entry = this->_findEntry((uint8_t)(reg_p + i));
+        if(!isPointerValid(entry) || !entry->valid) {
+            cacheHit = false;
+            break;
+        }
+    }
+    if(cacheHit) {
+        for(uint16_t i = 0; i < buffSize_p; i++) {
+            buffData_p[i] = this->_findEntry((uint8_t)(reg_p + i))->value;
+        }
+        // Returns successfully
+        this->_lastError = Error::NONE;
+        debugMessage(Error::NONE, DEBUG_REGISTER_CACHE);
+        return true;
+    }
+
+    // Read from the device
+    if(!this->_selectDevice()) {
+        // Returns error
+        debugMessage(this->_lastError, DEBUG_REGISTER_CACHE);
+        return false;
+    }
+    if(!this->_busHandler->readReg(reg_p, buffData_p, buffSize_p)) {
+        // Returns error
+        this->_lastError = this->_busHandler->getLastError();
+        debugMessage(this->_lastError, DEBUG_REGISTER_CACHE);
+        return false;
+    }
+
+    // Update the cache; pending and write-only values take precedence
+    for(uint16_t i = 0; (i < buffSize_p) && (this->_entriesUsed != 0); i++) {
+        entry = this->_findEntry((uint8_t)(reg_p + i));
+        if(!isPointerValid(entry)) {
+            continue;
+        }
+        if((entry->policy == Policy::CACHED) && !entry->dirty) {
+            entry->value = buffData_p[i];
+            entry->valid = true;
+        } else if(entry->valid) {
+            buffData_p[i] = entry->value;
+        }
+    }
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_REGISTER_CACHE);
+    return true;
+}
+
+bool_t RegisterCache::writeReg(cuint8_t reg_p, cuint8_t *buffData_p, cuint16_t buffSize_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("RegisterCache::writeReg(cuint8_t, cuint8_t *, cuint16_t)", DEBUG_REGISTER_CACHE);
+
+    // Local variables
+    Entry *entry = nullptr;
+    bool_t unchanged = (buffSize_p != 0);
+    bool_t written;
+
+    // Checks for errors
+    if(!isPointerValid(this->_busHandler)) {
+        // Returns error
+        this->_lastError = Error::NOT_INITIALIZED;
+        debugMessage(Error::NOT_INITIALIZED, DEBUG_REGISTER_CACHE);
+        return false;
+    }
+    if(!isPointerValid(buffData_p)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_POINTER_NULL;
+        debugMessage(Error::ARGUMENT_POINTER_NULL, DEBUG_REGISTER_CACHE);
+        return false;
+    }
+
+    // Skip the transfer when the device already holds the values
+    for(uint16_t i = 0; i < buffSize_p; i++) {
+        entry = this->_findEntry((uint8_t)(reg_p + i));
+        if(!isPointerValid(entry) || !entry->valid || entry->dirty || (entry->value != buffData_p[i])) {
+            unchanged = false;
+            break;
+        }
+    }
+    if(unchanged) {
+        // Returns successfully
+        this->_lastError = Error::NONE;
+        debugMessage(Error::NONE, DEBUG_REGISTER_CACHE);
+        return true;
+    }
+
+    // Write to the device
+    if(!this->_selectDevice()) {
+        // Returns error
+        debugMessage(this->_lastError, DEBUG_REGISTER_CACHE);
+        return false;
+    }
+    written = this->_busHandler->writeReg(reg_p, buffData_p, buffSize_p);
+
+    // Update the cache; values not written are kept as dirty
+    for(uint16_t i = 0; (i < buffSize_p) && (this->_entriesUsed != 0); i++) {
+        entry = this->_findEntry((uint8_t)(reg_p + i));
+        if(isPointerValid(entry)) {
+            entry->value = buffData_p[i];
+            entry->valid = true;
+            entry->dirty = !written;
+        }
+    }
+    if(!written) {
+        // Returns error
+        this->_lastError = this->_busHandler->getLastError();
+        debugMessage(this->_lastError, DEBUG_REGISTER_CACHE);
+        return false;
+    }
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_REGISTER_CACHE);
+    return true;
+}
+
+bool_t RegisterCache::readRegAsync(cuint8_t reg_p, uint8_t *buffData_p, cuint16_t buffSize_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("RegisterCache::readRegAsync(cuint8_t, uint8_t *, cuint16_t)", DEBUG_REGISTER_CACHE);
+
+    // Checks for errors
+    if(!isPointerValid(this->_busHandler)) {
+        // Returns error
+        this->_lastError = Error::NOT_INITIALIZED;
+        debugMessage(Error::NOT_INITIALIZED, DEBUG_REGISTER_CACHE);
+        return false;
+    }
+
+    // Asynchronous reads always go to the device
+    if(!this->_selectDevice()) {
+        // Returns error
+        debugMessage(this->_lastError, DEBUG_REGISTER_CACHE);
+        return false;
+    }
+    if(!this->_busHandler->readRegAsync(reg_p, buffData_p, buffSize_p)) {
+        // Returns error
+        this->_lastError = this->_busHandler->getLastError();
+        debugMessage(this->_lastError, DEBUG_REGISTER_CACHE);
+        return false;
+    }
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_REGISTER_CACHE);
+    return true;
+}
+
+bool_t RegisterCache::sendData(uint8_t *buffData_p, cuint16_t buffSize_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("RegisterCache::sendData(uint8_t *, cuint16_t)", DEBUG_REGISTER_CACHE);
+
+    // Checks for errors
+    if(!isPointerValid(this->_busHandler)) {
+        // Returns error
+        this->_lastError = Error::NOT_INITIALIZED;
+        debugMessage(Error::NOT_INITIALIZED, DEBUG_REGISTER_CACHE);
+        return false;
+    }
+
+    // Raw transfers are not cached
+    if(!this->_selectDevice()) {
+        // Returns error
+        debugMessage(this->_lastError, DEBUG_REGISTER_CACHE);
+        return false;
+    }
+    if(!this->_busHandler->sendData(buffData_p, buffSize_p)) {
+        // Returns error
+        this->_lastError = this->_busHandler->getLastError();
+        debugMessage(this->_lastError, DEBUG_REGISTER_CACHE);
+        return false;
+    }
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_REGISTER_CACHE);
+    return true;
+}
+
+bool_t RegisterCache::sendData(cuint8_t *txBuffData_p, uint8_t *rxBuffData_p, cuint16_t buffSize_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("RegisterCache::sendData(cuint8_t *, uint8_t *, cuint16_t)", DEBUG_REGISTER_CACHE);
+
+    // Checks for errors
+    if(!isPointerValid(this->_busHandler)) {
+        // Returns error
+        this->_lastError = Error::NOT_INITIALIZED;
+        debugMessage(Error::NOT_INITIALIZED, DEBUG_REGISTER_CACHE);
+        return false;
+    }
+
+    // Raw transfers are not cached
+    if(!this->_selectDevice()) {
+        // Returns error
+        debugMessage(this->_lastError, DEBUG_REGISTER_CACHE);
+        return false;
+    }
+    if(!this->_busHandler->sendData(txBuffData_p, rxBuffData_p, buffSize_p)) {
+        // Returns error
+        this->_lastError = this->_busHandler->getLastError();
+        debugMessage(this->_lastError, DEBUG_REGISTER_CACHE);
+        return false;
+    }
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_REGISTER_CACHE);
+    return true;
+}
+
+//     //////////////////    PROTOCOL SPECIFIC     //////////////////     //
+bool_t RegisterCache::setDevice(cuint16_t address_p, cbool_t useLongAddress_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("RegisterCache::setDevice(cuint16_t, cbool_t)", DEBUG_REGISTER_CACHE);
+
+    // Checks for errors
+    if(!isPointerValid(this->_busHandler)) {
+        // Returns error
+        this->_lastError = Error::NOT_INITIALIZED;
+        debugMessage(Error::NOT_INITIALIZED, DEBUG_REGISTER_CACHE);
+        return false;
+    }
+
+    // The address is sent to the bus before each transfer
+    this->_deviceAddress = address_p;
+    this->_useLongAddress = useLongAddress_p;
+    this->_deviceSelected = true;
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_REGISTER_CACHE);
+    return true;
+}
+
+bool_t RegisterCache::setDevice(void (* actFunc_p)(void), void (* deactFunc_p)(void))
+{
+    // Mark passage for debugging purpose
+    debugMark("RegisterCache::setDevice(void *(void), void *(void))", DEBUG_REGISTER_CACHE);
+
+    // Checks for errors
+    if(!isPointerValid(this->_busHandler)) {
+        // Returns error
+        this->_lastError = Error::NOT_INITIALIZED;
+        debugMessage(Error::NOT_INITIALIZED, DEBUG_REGISTER_CACHE);
+        return false;
+    }
+
+    // Slave select functions are kept by the bus itself
+    this->_deviceSelected = false;
+    if(!this->_busHandler->setDevice(actFunc_p, deactFunc_p)) {
+        // Returns error
+        this->_lastError = this->_busHandler->getLastError();
+        debugMessage(this->_lastError, DEBUG_REGISTER_CACHE);
+        return false;
+    }
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_REGISTER_CACHE);
+    return true;
+}
+
+// =============================================================================
+// Class public methods - Own methods
+// =============================================================================
+
+//     ///////////////////     CONFIGURATION     ////////////////////     //
+bool_t RegisterCache::init(Bus *busHandler_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("RegisterCache::init(Bus *)", DEBUG_REGISTER_CACHE);
+
+    // Empty the cache
+    this->_busHandler = nullptr;
+    this->_deviceSelected = false;
+    this->_entriesUsed = 0;
+
+    // Check function arguments for errors
+    if(!isPointerValid(busHandler_p)) {
+        // Returns error
+        this->_lastError = Error::BUS_HANDLER_POINTER_NULL;
+        debugMessage(Error::BUS_HANDLER_POINTER_NULL, DEBUG_REGISTER_CACHE);
+        return false;
+    }
+
+    // Update data members
+    this->_busHandler = busHandler_p;
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_REGISTER_CACHE);
+    return true;
+}
+
+bool_t RegisterCache::setPolicy(cuint8_t reg_p, const Policy policy_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("RegisterCache::setPolicy(cuint8_t, const Policy)", DEBUG_REGISTER_CACHE);
+
+    // Local variables
+    Entry *entry = this->_findEntry(reg_p);
+
+    // Volatile registers are not held
+    if(policy_p == Policy::VOLATILE) {
+        if(isPointerValid(entry)) {
+            *entry = this->_entries[--this->_entriesUsed];
+        }
+        // Returns successfully
+        this->_lastError = Error::NONE;
+        debugMessage(Error::NONE, DEBUG_REGISTER_CACHE);
+        return true;
+    }
+
+    // Take a new entry
+    if(!isPointerValid(entry)) {
+        if(this->_entriesUsed == REGISTER_CACHE_SIZE) {
+            // Returns error
+            this->_lastError = Error::BUFFER_NOT_ENOUGH_SPACE;
+            debugMessage(Error::BUFFER_NOT_ENOUGH_SPACE, DEBUG_REGISTER_CACHE);
+            return false;
+        }
+        entry = &this->_entries[this->_entriesUsed++];
+        entry->reg = reg_p;
+    }
+
+    // Update entry
+    entry->policy = policy_p;
+    entry->value = 0;
+    entry->valid = false;
+    entry->dirty = false;
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_REGISTER_CACHE);
+    return true;
+}
+
+//     ////////////////////    CACHE HANDLING     ////////////////////     //
+bool_t RegisterCache::flush(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("RegisterCache::flush(void)", DEBUG_REGISTER_CACHE);
+
+    // Checks for errors
+    if(!isPointerValid(this->_busHandler)) {
+        // Returns error
+        this->_lastError = Error::NOT_INITIALIZED;
+        debugMessage(Error::NOT_INITIALIZED, DEBUG_REGISTER_CACHE);
+        return false;
+    }
+
+    // Send the dirty registers
+    for(uint8_t i = 0; i < this->_entriesUsed; i++) {
+        Entry *entry = &this->_entries[i];
+        if(!entry->dirty) {
+            continue;
+        }
+        if(!this->_selectDevice()) {
+            // Returns error
+            debugMessage(this->_lastError, DEBUG_REGISTER_CACHE);
+            return false;
+        }
+        if(!this->_busHandler->writeReg(entry->reg, &entry->value, 1)) {
+            // Returns error
+            this->_lastError = this->_busHandler->getLastError();
+            debugMessage(this->_lastError, DEBUG_REGISTER_CACHE);
+            return false;
+        }
+        entry->dirty = false;
+    }
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_REGISTER_CACHE);
+    return true;
+}
+
+void RegisterCache::invalidate(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("RegisterCache::invalidate(void)", DEBUG_REGISTER_CACHE);
+
+    // Discard values
+    for(uint8_t i = 0; i < this->_entriesUsed; i++) {
+        this->_entries[i].valid = false;
+        this->_entries[i].dirty = false;
+    }
+
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_REGISTER_CACHE);
+    return;
+}
+
+bool_t RegisterCache::isDirty(void)
+{
+    // Look for pending writes
+    for(uint8_t i = 0; i < this->_entriesUsed; i++) {
+        if(this->_entries[i].dirty) {
+            return true;
+        }
+    }
+
+    // Returns status
+    return false;
+}
+
+// =============================================================================
+// Class private methods
+// =============================================================================
+
+RegisterCache::Entry *RegisterCache::_findEntry(cuint8_t reg_p)
+{
+    // Look for the register
+    for(uint8_t i = 0; i < this->_entriesUsed; i++) {
+        if(this->_entries[i].reg == reg_p) {
+            return &this->_entries[i];
+        }
+    }
+
+    // Register not held
+    return nullptr;
+}
+
+bool_t RegisterCache::_selectDevice(void)
+{
+    // Select the device on the bus, that may be shared
+    if(this->_deviceSelected) {
+        if(!this->_busHandler->setDevice(this->_deviceAddress, this->_useLongAddress)) {
+            // Returns error
+            this->_lastError = this->_busHandler->getLastError();
+            return false;
+        }
+    }
+
+    // Returns successfully
+    return true;
+}
+
+// =============================================================================
+// Class protected methods
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// General public functions definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
@@ -0,0 +1,303 @@
+//!
+//! \file           registerCache.hpp
+//! \brief          Register cache for bus attached devices
+//! \author         Leandro Schwarz (bladabuska+funsapeavr8lib@gmail.com)
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Keeps a copy of selected device registers in front of a
+//!                     bus handler, so that configuration registers are not
+//!                     read or written again over the bus when the value is
+//!                     already known.
+//!
+
+// =============================================================================
+// Include guard (START)
+// =============================================================================
+
+#ifndef __REGISTER_CACHE_HPP
+#define __REGISTER_CACHE_HPP                    2304
+
+// =============================================================================
+// Dependencies
+// =============================================================================
+
+//     /////////////////     GLOBAL DEFINITIONS FILE    /////////////////     //
+#include "../globalDefines.hpp"
+#if !defined(__GLOBAL_DEFINES_HPP)
+#   error "Global definitions file is corrupted!"
+#elif __GLOBAL_DEFINES_HPP != __REGISTER_CACHE_HPP
+#   error "Version mismatch between file header and global definitions file!"
+#endif
+
+//     //////////////////     LIBRARY DEPENDENCIES     //////////////////     //
+#include "bus.hpp"
+#if !defined(__BUS_HPP)
+#   error "Header file (bus.hpp) is corrupted!"
+#elif __BUS_HPP != __REGISTER_CACHE_HPP
+#   error "Version mismatch between header file and library dependency (bus.hpp)!"
+#endif
+
+// =============================================================================
+// Undefining previous definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Constant definitions
+// =============================================================================
+
+#ifndef REGISTER_CACHE_SIZE
+//!
+//! \brief          Number of registers each cache can hold
+//!
+#   define REGISTER_CACHE_SIZE          4
+#endif
+
+#if (REGISTER_CACHE_SIZE == 0) || (REGISTER_CACHE_SIZE > 255)
+#   error "REGISTER_CACHE_SIZE must be between 1 and 255!"
+#endif
+
+// =============================================================================
+// New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// RegisterCache Class
+// =============================================================================
+
+//!
+//! \brief          RegisterCache class
+//! \details        A RegisterCache is a Bus handler that forwards the
+//!                     transfers to another Bus handler, so a device driver
+//!                     uses it in place of the bus with no other changes.
+//!                     Each register has a policy:
+//!                     - VOLATILE registers (the default) always go to the
+//!                         bus, as their value is changed by the device;
+//!                     - CACHED registers are read from the bus once and
+//!                         then from the cache (read-through), and written to
+//!                         the bus only when the value changes
+//!                         (write-through);
+//!                     - WRITE_ONLY registers cannot be read back from the
+//!                         device; they are written as CACHED registers, and
+//!                         reads return the last value written.
+//!                     A block transfer is served by the cache only when all
+//!                     its registers are cached; otherwise the whole block
+//!                     goes to the bus and the cache is updated from it. A
+//!                     register whose write failed is marked dirty, and the
+//!                     value is sent again by flush(). The device address is
+//!                     selected on the bus only before an actual transfer,
+//!                     so the bus can be shared by several devices.
+//!
+class RegisterCache : public Bus
+{
+    // -------------------------------------------------------------------------
+    // New data types ----------------------------------------------------------
+public:
+    //     ////////////////////     Cache Policy    /////////////////////     //
+    //!
+    //! \brief      Cache policy enumeration
+    //! \details    Cache policy of a register.
+    //!
+    enum class Policy : uint8_t {
+        VOLATILE                        = 0,    //!< Always read and written on the bus
+        CACHED                          = 1,    //!< Read-through and write-through
+        WRITE_ONLY                      = 2,    //!< Write-through, read from the cache only
+    };
+
+private:
+    typedef struct Entry {
+        uint8_t         reg;
+        Policy          policy;
+        uint8_t         value;
+        bool_t          valid                   : 1;
+        bool_t          dirty                   : 1;
+    } Entry;
+
+    // -------------------------------------------------------------------------
+    // Constructors ------------------------------------------------------------
+public:
+    //!
+    //! \brief      RegisterCache class constructor
+    //! \details    Creates a RegisterCache object
+    //!
+    RegisterCache(
+            void
+    );
+
+    //!
+    //! \brief      RegisterCache class destructor
+    //! \details    Destroys a RegisterCache object
+    //!
+    ~RegisterCache(
+            void
+    );
+
+    // -------------------------------------------------------------------------
+    // Methods - Inherited methods ---------------------------------------------
+public:
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+    Bus::BusType getBusType(
+            void
+    );
+    bool_t isBusy(
+            void
+    );
+    Error getLastError(
+            void
+    );
+
+    //     ////////////////////    DATA TRANSFER     ////////////////////     //
+    bool_t readReg(
+            cuint8_t reg_p,
+            uint8_t *buffData_p,
+            cuint16_t buffSize_p = 1
+    );
+    bool_t writeReg(
+            cuint8_t reg_p,
+            cuint8_t *buffData_p,
+            cuint16_t buffSize_p = 1
+    );
+    bool_t readRegAsync(
+            cuint8_t reg_p,
+            uint8_t *buffData_p,
+            cuint16_t buffSize_p
+    );
+    bool_t sendData(
+            uint8_t *buffData_p,
+            cuint16_t buffSize_p
+    );
+    bool_t sendData(
+            cuint8_t *txBuffData_p,
+            uint8_t *rxBuffData_p,
+            cuint16_t buffSize_p
+    );
+
+    //     //////////////////    PROTOCOL SPECIFIC     //////////////////     //
+    bool_t setDevice(
+            cuint16_t address_p,
+            cbool_t useLongAddress_p = false
+    );
+    bool_t setDevice(
+            void (* actFunc_p)(void),
+            void (* deactFunc_p)(void)
+    );
+
+    // -------------------------------------------------------------------------
+    // Methods - Class own methods ---------------------------------------------
+public:
+    //     ///////////////////     CONFIGURATION     ////////////////////     //
+
+    //!
+    //! \brief      Initializes the cache
+    //! \details    Attaches the cache to a bus handler and empties it. All
+    //!                 registers become VOLATILE.
+    //! \param      busHandler_p        Pointer to the bus handler
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t init(
+            Bus *busHandler_p
+    );
+
+    //!
+    //! \brief      Sets the policy of a register
+    //! \details    Sets the policy of a register. The cached value, if any,
+    //!                 is discarded.
+    //! \param      reg_p               Register address
+    //! \param      policy_p            Cache policy
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t setPolicy(
+            cuint8_t reg_p,
+            const Policy policy_p
+    );
+
+    //     ////////////////////    CACHE HANDLING     ////////////////////     //
+
+    //!
+    //! \brief      Sends the dirty registers to the device
+    //! \details    Writes again, one at a time, the registers whose last
+    //!                 write failed.
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t flush(
+            void
+    );
+
+    //!
+    //! \brief      Discards the cached values
+    //! \details    Discards the cached values, keeping the policies. Must be
+    //!                 called when the device loses its configuration (after
+    //!                 a reset or a power cycle).
+    //!
+    void invalidate(
+            void
+    );
+
+    //!
+    //! \brief      Checks for dirty registers
+    //! \details    Checks if any register must still be sent to the device.
+    //! \return     bool_t              True if dirty / False otherwise
+    //!
+    bool_t isDirty(
+            void
+    );
+
+protected:
+    // NONE
+
+private:
+    Entry *_findEntry(
+            cuint8_t reg_p
+    );
+    bool_t _selectDevice(
+            void
+    );
+
+    // -------------------------------------------------------------------------
+    // Properties --------------------------------------------------------------
+private:
+    //     ////////////////    PERIPHERAL BUS HANDLER     ////////////////     //
+    Bus                 *_busHandler;
+    uint16_t            _deviceAddress;
+    bool_t              _deviceSelected                 : 1;
+    bool_t              _useLongAddress                 : 1;
+
+    //     ////////////////////    CACHE HANDLING     ////////////////////     //
+    Entry               _entries[REGISTER_CACHE_SIZE];
+    uint8_t             _entriesUsed;
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+    Error               _lastError;
+}; // class RegisterCache
+
+// =============================================================================
+// RegisterCache - Class inline function definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// External global variables
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Include guard (END)
+// =============================================================================
+
+#endif  // __REGISTER_CACHE_HPP
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
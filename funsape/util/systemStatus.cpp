@@ -154,8 +154,16 @@ Error SystemStatus::getLastError(void)
 
 uint32_t SystemStatus::readStopwatch(void)
 {
+    // Local variables
+    uint32_t aux32;
+
+    // Read atomically, the stopwatch is incremented by an interrupt
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        aux32 = this->_stopwatchValue;
+    }
+
     // Returns value
-    return this->_stopwatchValue;
+    return aux32;
 }
 
 void SystemStatus::resumeStopwatch(void)
@@ -179,8 +187,10 @@ void SystemStatus::pauseStopwatch(void)
 void SystemStatus::resetStopwatch(void)
 {
     // Resets stopwatch
-    this->_stopwatchValue = 0;
-    this->_stopwatchMark = 0;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        this->_stopwatchValue = 0;
+        this->_stopwatchMark = 0;
+    }
 
     // Returns successfully
     return;
@@ -189,7 +199,9 @@ void SystemStatus::resetStopwatch(void)
 void SystemStatus::setStopwatchMark(void)
 {
     // Sets stopwatch mark
-    this->_stopwatchMark = this->_stopwatchValue;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        this->_stopwatchMark = this->_stopwatchValue;
+    }
 
     // Returns successfully
     return;
@@ -209,17 +221,21 @@ void SystemStatus::incrementStopwatch(void)
 uint32_t SystemStatus::getElapsedTime(bool_t setNewMark)
 {
     // Local variables
-    uint32_t start = this->_stopwatchMark;
-    uint32_t current = this->_stopwatchValue;
+    uint32_t start;
+    uint32_t current;
     uint32_t elapsed = 0;
 
-    // Evaluate time elapsed between marks
-    elapsed = (current > start) ? (current - start) : (((0xFFFFFFFF - start)  + current) + 1);
+    // Evaluate time elapsed between marks (unsigned, so wrap safe)
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        start = this->_stopwatchMark;
+        current = this->_stopwatchValue;
 
-    // Sets new stopwatch mark
-    if(setNewMark) {
-        this->_stopwatchMark = current;
+        // Sets new stopwatch mark
+        if(setNewMark) {
+            this->_stopwatchMark = current;
+        }
     }
+    elapsed = current - start;
 
     // Returns value
     return elapsed;
@@ -138,9 +138,11 @@ public:
 
     //     //////////////////////    STOPWATCH     //////////////////////     //
     //!
-    //! \brief          Brief description
-    //! \details        Long description
-    //! \return         uint32_t              Return info
+    //! \brief          Reads the stopwatch
+    //! \details        Returns the stopwatch value, in milliseconds when it is
+    //!                     driven by the system tick (see systemTick.hpp).
+    //!                     The value is read atomically.
+    //! \return         uint32_t              Stopwatch value
     //!
     uint32_t readStopwatch(
             void
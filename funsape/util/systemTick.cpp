@@ -0,0 +1,201 @@
+//!
+//! \file           systemTick.cpp
+//! \brief          System timebase for the FunSAPE AVR8 Library
+//! \author         Leandro Schwarz (bladabuska+funsapeavr8lib@gmail.com)
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        System timebase for the FunSAPE AVR8 Library
+//!
+
+// =============================================================================
+// System file dependencies
+// =============================================================================
+
+#include "systemTick.hpp"
+#if !defined(__SYSTEM_TICK_HPP)
+#    error "Header file is corrupted!"
+#elif __SYSTEM_TICK_HPP != 2304
+#    error "Version mismatch between source and header files!"
+#endif
+
+// =============================================================================
+// File exclusive - Constants
+// =============================================================================
+
+#define DEBUG_SYSTEM_TICK               0x2FFF
+
+// =============================================================================
+// File exclusive - New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// File exclusive - Global variables
+// =============================================================================
+
+SystemTick systemTick;
+
+// =============================================================================
+// File exclusive - Macro-functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Class constructors
+// =============================================================================
+
+SystemTick::SystemTick(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("SystemTick::SystemTick(void)", DEBUG_SYSTEM_TICK);
+
+    // Reset data members
+    this->_milliseconds                 = 0;
+    this->_countToMicroseconds          = 0;
+    this->_isInitialized                = false;
+
+    // Returns successfully
+    this->_lastError                    = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_SYSTEM_TICK);
+    return;
+}
+
+SystemTick::~SystemTick(void)
+{
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_SYSTEM_TICK);
+    return;
+}
+
+// =============================================================================
+// Class public methods
+// =============================================================================
+
+//     ///////////////////     CONFIGURATION     ////////////////////     //
+bool_t SystemTick::init(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("SystemTick::init(void)", DEBUG_SYSTEM_TICK);
+
+    // Local variables
+    Timer0::ClockSource clockSource = Timer0::ClockSource::PRESCALER_64;
+    uint32_t countsPerTick = systemStatus.getCpuClock() / 64000UL;
+
+    // Evaluate prescaler and period
+    if(countsPerTick > 256) {
+        clockSource = Timer0::ClockSource::PRESCALER_256;
+        countsPerTick = systemStatus.getCpuClock() / 256000UL;
+    }
+
+    // Checks for errors
+    if(countsPerTick > 256) {
+        // Returns error
+        this->_lastError = Error::CLOCK_SPEED_TOO_HIGH;
+        debugMessage(Error::CLOCK_SPEED_TOO_HIGH, DEBUG_SYSTEM_TICK);
+        return false;
+    }
+    if(countsPerTick < 4) {
+        // Returns error
+        this->_lastError = Error::CLOCK_SPEED_TOO_LOW;
+        debugMessage(Error::CLOCK_SPEED_TOO_LOW, DEBUG_SYSTEM_TICK);
+        return false;
+    }
+
+    // Configure TIMER0 (CTC mode, 1 ms period)
+    timer0.deactivateCompareAInterrupt();
+    timer0.init(Timer0::Mode::CTC_OCRA, Timer0::ClockSource::DISABLED);
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        this->_milliseconds = 0;
+    }
+    this->_countToMicroseconds = (uint16_t)((1000UL << 8) / countsPerTick);
+    timer0.setCompareAValue((uint8_t)(countsPerTick - 1));
+    timer0.setCounterValue(0);
+    timer0.clearCompareAInterruptRequest();
+    timer0.activateCompareAInterrupt();
+    timer0.setClockSource(clockSource);
+    this->_isInitialized = true;
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_SYSTEM_TICK);
+    return true;
+}
+
+//     //////////////////////     READERS     ///////////////////////     //
+uint32_t SystemTick::getMilliseconds(void)
+{
+    // Local variables
+    uint32_t aux32;
+
+    // Read atomically
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        aux32 = this->_milliseconds;
+    }
+
+    // Returns value
+    return aux32;
+}
+
+uint32_t SystemTick::getMicroseconds(void)
+{
+    // Local variables
+    uint32_t milliseconds;
+    uint8_t count;
+
+    // Read the tick and the counter together
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        milliseconds = this->_milliseconds;
+        count = TCNT0;
+        if(isBitSet(TIFR0, OCF0A)) {    // Tick not counted yet by the interrupt
+            count = TCNT0;
+            milliseconds++;
+        }
+    }
+
+    // Returns value
+    return (milliseconds * 1000) + (((uint32_t)count * this->_countToMicroseconds) >> 8);
+}
+
+//     /////////////////     CONTROL AND STATUS     /////////////////     //
+Error SystemTick::getLastError(void)
+{
+    // Returns last error
+    return this->_lastError;
+}
+
+// =============================================================================
+// Class private methods
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Class protected methods
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// General public functions definitions
+// =============================================================================
+
+weakened uint32_t getTick(void)
+{
+    return systemTick.getMilliseconds();
+}
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+void timer0CompareACallback(void)
+{
+    systemTick.tickHandler();
+}
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
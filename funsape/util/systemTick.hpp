@@ -0,0 +1,245 @@
+//!
+//! \file           systemTick.hpp
+//! \brief          System timebase for the FunSAPE AVR8 Library
+//! \author         Leandro Schwarz (bladabuska+funsapeavr8lib@gmail.com)
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Monotonic timebase on TIMER0: a 1 ms tick, that also
+//!                     drives the SystemStatus stopwatch and getTick(), and a
+//!                     microsecond timestamp built from the counter register.
+//!                     TIMER0 is used exclusively by this module.
+//!
+
+// =============================================================================
+// Include guard (START)
+// =============================================================================
+
+#ifndef __SYSTEM_TICK_HPP
+#define __SYSTEM_TICK_HPP                       2304
+
+// =============================================================================
+// Dependencies
+// =============================================================================
+
+//     /////////////////     GLOBAL DEFINITIONS FILE    /////////////////     //
+#include "../globalDefines.hpp"
+#if !defined(__GLOBAL_DEFINES_HPP)
+#   error "Global definitions file is corrupted!"
+#elif __GLOBAL_DEFINES_HPP != __SYSTEM_TICK_HPP
+#   error "Version mismatch between file header and global definitions file!"
+#endif
+
+//     //////////////////     LIBRARY DEPENDENCIES     //////////////////     //
+#include "systemStatus.hpp"
+#if !defined(__SYSTEM_STATUS_HPP)
+#   error "Header file (systemStatus.hpp) is corrupted!"
+#elif __SYSTEM_STATUS_HPP != __SYSTEM_TICK_HPP
+#   error "Version mismatch between header file and library dependency (systemStatus.hpp)!"
+#endif
+
+#include "../peripheral/timer0.hpp"
+#if !defined(__TIMER0_HPP)
+#   error "Header file (timer0.hpp) is corrupted!"
+#elif __TIMER0_HPP != __SYSTEM_TICK_HPP
+#   error "Version mismatch between header file and library dependency (timer0.hpp)!"
+#endif
+
+// =============================================================================
+// Undefining previous definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Constant definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// SystemTick Class
+// =============================================================================
+
+//!
+//! \brief          SystemTick class
+//! \details        TIMER0 runs in CTC mode with a 1 ms period. The interrupt
+//!                     takes the same path on every tick: it increments the
+//!                     millisecond counter and the stopwatch, with no loops.
+//!                     The timestamps are unsigned and wrap around (the
+//!                     microseconds every 71.6 minutes, the milliseconds
+//!                     every 49.7 days), so intervals must be evaluated by
+//!                     subtraction, as in getElapsedMicroseconds(), which
+//!                     stays correct across the wrap. The readers are
+//!                     atomic and can be called from interrupts.
+//!
+class SystemTick
+{
+    // -------------------------------------------------------------------------
+    // Constructors ------------------------------------------------------------
+public:
+    //!
+    //! \brief      SystemTick class constructor
+    //! \details    Creates a SystemTick object
+    //!
+    SystemTick(
+            void
+    );
+
+    //!
+    //! \brief      SystemTick class destructor
+    //! \details    Destroys a SystemTick object
+    //!
+    ~SystemTick(
+            void
+    );
+
+    // -------------------------------------------------------------------------
+    // Methods -----------------------------------------------------------------
+public:
+    //     ///////////////////     CONFIGURATION     ////////////////////     //
+
+    //!
+    //! \brief      Starts the timebase
+    //! \details    Configures TIMER0 for a 1 ms period from the CPU clock,
+    //!                 with prescaler 64 up to 16.384 MHz and 256 above it.
+    //!                 The period is exact when the CPU clock is a multiple
+    //!                 of 64 kHz (or 256 kHz). Global interrupts must be
+    //!                 enabled by the user.
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t init(
+            void
+    );
+
+    //     //////////////////////     READERS     ///////////////////////     //
+
+    //!
+    //! \brief      Returns the milliseconds
+    //! \details    Returns the milliseconds elapsed since init().
+    //! \return     uint32_t            Milliseconds
+    //!
+    uint32_t getMilliseconds(
+            void
+    );
+
+    //!
+    //! \brief      Returns the microseconds
+    //! \details    Returns the microseconds elapsed since init(), with the
+    //!                 resolution of one TIMER0 count (4 us at 16 MHz).
+    //! \return     uint32_t            Microseconds
+    //!
+    uint32_t getMicroseconds(
+            void
+    );
+
+    //!
+    //! \brief      Returns the milliseconds elapsed since a timestamp
+    //! \details    Returns the milliseconds elapsed since a value returned
+    //!                 by getMilliseconds().
+    //! \param      start_p             Timestamp, in milliseconds
+    //! \return     uint32_t            Elapsed milliseconds
+    //!
+    uint32_t inlined getElapsedMilliseconds(
+            cuint32_t start_p
+    );
+
+    //!
+    //! \brief      Returns the microseconds elapsed since a timestamp
+    //! \details    Returns the microseconds elapsed since a value returned
+    //!                 by getMicroseconds().
+    //! \param      start_p             Timestamp, in microseconds
+    //! \return     uint32_t            Elapsed microseconds
+    //!
+    uint32_t inlined getElapsedMicroseconds(
+            cuint32_t start_p
+    );
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+
+    //!
+    //! \brief      Returns the last error
+    //! \details    Returns the last error.
+    //! \return     Error               Error status of the last operation
+    //!
+    Error getLastError(
+            void
+    );
+
+    //     /////////////////////     INTERRUPTS    //////////////////////     //
+
+    //!
+    //! \brief      Tick handler
+    //! \details    Counts one millisecond. Called from the TIMER0 Compare A
+    //!                 Match interrupt.
+    //!
+    void inlined tickHandler(
+            void
+    );
+
+protected:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Properties --------------------------------------------------------------
+private:
+    //     //////////////////////     READERS     ///////////////////////     //
+    vuint32_t           _milliseconds;
+    uint16_t            _countToMicroseconds;   // Microseconds per count (8.8 fixed point)
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+    bool_t              _isInitialized                  : 1;
+    Error               _lastError;
+}; // class SystemTick
+
+// =============================================================================
+// SystemTick - Class inline function definitions
+// =============================================================================
+
+uint32_t inlined SystemTick::getElapsedMilliseconds(cuint32_t start_p)
+{
+    return (this->getMilliseconds() - start_p);
+}
+
+uint32_t inlined SystemTick::getElapsedMicroseconds(cuint32_t start_p)
+{
+    return (this->getMicroseconds() - start_p);
+}
+
+void inlined SystemTick::tickHandler(void)
+{
+    this->_milliseconds++;
+    systemStatus.incrementStopwatch();
+}
+
+// =============================================================================
+// External global variables
+// =============================================================================
+
+//!
+//! \brief          System timebase object
+//! \details        System timebase object
+//!
+extern SystemTick systemTick;
+
+// =============================================================================
+// Include guard (END)
+// =============================================================================
+
+#endif  // __SYSTEM_TICK_HPP
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
@@ -3,16 +3,28 @@
 #include <avr/interrupt.h>
 #include "funsape/peripheral/twi.hpp"
 #include "funsape/device/keypad.hpp"
+#include "funsape/device/mpu9250.hpp"
 #include "funsape/globalDefines.hpp"
 #include "funsape/peripheral/usart0.hpp"
 #include "funsape/peripheral/timer2.hpp"
+#include "funsape/util/systemTick.hpp"
+#include "midi/channelState.hpp"
+#include "midi/keyboardZones.hpp"
+#include "midi/midiClock.hpp"
+#include "midi/midiMerge.hpp"
+#include "midi/midiOutput.hpp"
+#include "midi/midiPeripheral.hpp"
+#include "midi/motionMapper.hpp"
+#include "midi/motionTracker.hpp"
+#include "midi/noteScheduler.hpp"
+#include "midi/sequencer.hpp"
+#include "midi/voiceTracker.hpp"
 
 #define issetBit(REG, bit)  ((REG)&(1<<bit))
 #define setBit(reg, bit)                ((reg) |= (1 << (bit)))
 #define clrBit(reg, bit)                ((reg) &= ~(1 << (bit)))
 #define cplBit(reg, bit)                ((reg) ^= (1 << (bit)))
 #define setMaskOffset(reg, mask, offset)        ((reg) |= ((mask) << (offset)))
-#define MPU9250_SLAVEADRESS             0b1101000
 
 // Um abraço para o Leonardo Beche
 
@@ -190,6 +202,13 @@ typedef char                          int8;
 #define fff  112
 #define ffff 127
 
+// número máximo de notas soando ao mesmo tempo; acima disso, a nota mais
+// antiga é desligada para não sobrecarregar o VS1053
+#define MAX_POLIFONIA   16
+
+// andamento do MIDI clock, em centésimos de BPM (12000 = 120 BPM)
+#define ANDAMENTO       12000
+
 struct MIDI {
     uint8 STATUS_BYTE = 0b10000000; // primeiro byte a ser enviado
     uint8 DATA_BYTE1  = 0b00000000; // segundo byte a ser enviado
@@ -202,6 +221,44 @@ struct MIDI {
 
 typedef MIDI        Midi_t;
 
+// músicas gravadas na memória de programa: cada evento guarda a nota, a
+// velocidade, a duração e o tempo até o próximo evento (unidades de 10 ms)
+#define SONG_NOTE(nota, duracao)    {(uint8)((nota) + 60), fff, (duracao), (duracao)}
+
+// Jingle Bells
+const SongEvent jingleBells[] PROGMEM = {
+    // Jingle Bells, Jingle Bells
+    SONG_NOTE(E, 50), SONG_NOTE(E, 50), SONG_NOTE(E, 100),
+    // Jingle all the way
+    SONG_NOTE(E, 50), SONG_NOTE(E, 50), SONG_NOTE(E, 100),
+    // Oh, what fun it is to ride
+    SONG_NOTE(G, 50), SONG_NOTE(A, 50), SONG_NOTE(A, 100),
+    // In a one-horse open sleigh
+    SONG_NOTE(A, 50), SONG_NOTE(G, 50), SONG_NOTE(F, 100),
+};
+
+// Brilha, brilha, estrelinha
+const SongEvent brilhaBrilha[] PROGMEM = {
+    // Brilha, brilha, estrelinha
+    SONG_NOTE(C, 60), SONG_NOTE(C, 60), SONG_NOTE(G, 60), SONG_NOTE(G, 60), SONG_NOTE(A, 60), SONG_NOTE(A, 60), SONG_NOTE(G, 60),
+    // Lá no alto é que está
+    SONG_NOTE(F, 60), SONG_NOTE(F, 60), SONG_NOTE(F, 60), SONG_NOTE(E, 60), SONG_NOTE(E, 60), SONG_NOTE(D, 60),
+    // C no final para dar uma pausa
+    SONG_NOTE(C, 120),
+};
+
+// A Barata Diz Que Tem
+const SongEvent aBarata[] PROGMEM = {
+    // A barata diz que tem
+    SONG_NOTE(A, 50), SONG_NOTE(G, 50), SONG_NOTE(F, 50), SONG_NOTE(E, 50), SONG_NOTE(D, 50), SONG_NOTE(C, 50),
+    // A barata diz que tem
+    SONG_NOTE(A, 50), SONG_NOTE(G, 50), SONG_NOTE(F, 50), SONG_NOTE(E, 50), SONG_NOTE(D, 50), SONG_NOTE(C, 50),
+    // A barata diz que tem
+    SONG_NOTE(A, 50), SONG_NOTE(G, 50), SONG_NOTE(F, 50), SONG_NOTE(E, 50), SONG_NOTE(D, 50), SONG_NOTE(C, 50),
+    // E o homem diz que não tem
+    SONG_NOTE(G, 50), SONG_NOTE(A, 50), SONG_NOTE(G, 50), SONG_NOTE(F, 50), SONG_NOTE(E, 50), SONG_NOTE(D, 50), SONG_NOTE(C, 100),
+};
+
 
 // -----------------------------config----------------------------------------------
 // The TXCn Flag can be used to check that the
@@ -223,24 +280,26 @@ typedef MIDI        Midi_t;
 //  The CPU can load the transmit buffer by writing to the UDRn I/O location
 //------------------------------comunication--------------------------------------------
 
-volatile Midi_t Midi_Variable;
-
-// essa função recebe um canal midi e entrega esses dados a uma estrutura igual
-// que está declarada globalmente para ser usada pelo periférico e sua interrupção,
-// habilitando a transmição dos dados contidos no midi para o tx do atmega
+// essa função recebe um canal midi e coloca a mensagem correspondente na fila
+// de transmissão, que é esvaziada pela interrupção do UDR0; se a fila estiver
+// cheia, espera a interrupção liberar espaço, então nenhuma mensagem é perdida.
+// A mensagem passa pelo merge, que a intercala com as mensagens recebidas
+// pela entrada MIDI (MIDI THRU) sem quebrar nenhuma delas; antes disso, a
+// tabela de estado dos canais descarta trocas de programa e de controle
+// repetidas e o rastreador de vozes registra as notas que estão soando
 uint8 play(Midi_t *midi)
 {
-    if(issetBit(UCSR0A, UDRE0)) {
-        Midi_Variable.DATA_BYTE1 = (midi->DATA_BYTE1);
-        Midi_Variable.DATA_BYTE2 = (midi->DATA_BYTE2);
-        Midi_Variable.DATA_SENT = (midi->DATA_SENT);
-        Midi_Variable.MIDI_CHANEL = (midi->MIDI_CHANEL);
-        Midi_Variable.STATUS_BYTE = (midi->STATUS_BYTE);
-        setBit(UCSR0B, TXEN0);  //habilita a transmição;
-        setBit(UCSR0B, UDRIE0); // enables interrupt on the UDREn
-        return 1;
+    uint8 message[3];
+    uint8 size = 3;
+
+    message[0] = midi->STATUS_BYTE;
+    message[1] = midi->DATA_BYTE1;
+    message[2] = midi->DATA_BYTE2;
+    // program change e channel pressure têm apenas um byte de dados
+    if(((midi->STATUS_BYTE & 0xF0) == 0xC0) || ((midi->STATUS_BYTE & 0xF0) == 0xD0)) {
+        size = 2;
     }
-    return 0;
+    return channelState.sendMessage(message, size);
 }
 
 
@@ -251,10 +310,19 @@ void init_midi(Midi_t *midi, uint8 chanel)
 {
     midi->MIDI_CHANEL = chanel;
 //-----------------------Baud_Rate--------------------------------------------
+    // 31250 bps: divisor calculado em tempo de compilação (UBRR0 = 31 a 16 MHz)
+    usart0.setBaudRate<Usart0::BaudRate::BAUD_RATE_31250>();
     usart0.init();
-    usart0.enableTransmitter();
-    UBRR0 = 31;
-    setBit(UCSR0B, TXEN0);  //habilita a transmição;
+    midiOutput.init();
+    midiOutput.setRunningStatus(true, 16); // omite status repetidos (note_off = note_on com velocidade 0)
+    midiMerge.init();   // habilita a recepção e o MIDI THRU
+    voiceTracker.setPolyphony(MAX_POLIFONIA); // rouba a voz mais antiga acima do limite
+    // o teclado inteiro toca no canal escolhido, com o instrumento do canal;
+    // outras zonas podem dividir o teclado ou sobrepor instrumentos
+    keyboardZones.setZone(0, 0, 127, chanel, CHANNEL_STATE_UNKNOWN);
+    // MIDI clock (24 pulsos por semínima) no TIMER1, para sincronizar
+    // baterias eletrônicas e sequenciadores externos
+    midiClock.init(ANDAMENTO);
 
 //-----------------------Baud_Rate--------------------------------------------
 
@@ -286,9 +354,7 @@ bool note_on(Midi_t *midi, uint8 relative_pitch, int8 oitava_ave, uint8 velocida
         setBit(midi->DATA_SENT, 0);         // setando a quantidade de bytes
         setBit(midi->DATA_SENT, 1);         //
         setBit(midi->DATA_SENT, 2);         // note_on
-        play(midi);
-        delayMs(1);
-        return 1;
+        return play(midi);
     } else {
         return 0;
     }
@@ -301,9 +367,32 @@ void note_off(Midi_t *midi, uint8 relative_pitch, int8 oitava_ave)
     note_on(midi, relative_pitch, oitava_ave, 0);
 }
 
+// toca uma nota e agenda o seu note_off para daqui a duracao_ms milissegundos,
+// sem travar o laço principal; a nota é tocada em todas as zonas do teclado
+// que contêm a tecla, cada uma com o seu canal e instrumento; se a fila do
+// agendador estiver cheia, a nota é desligada imediatamente para não ficar presa
+bool play_note(Midi_t *midi, uint8 relative_pitch, int8 oitava_ave, uint8 velocidade_city, uint16_t duracao_ms)
+{
+    uint8 pitch = (relative_pitch) + 12 * oitava_ave + 60;
+
+    if((velocidade_city >= 0b10000000) || (pitch >= 0b10000000)) {
+        return 0;
+    }
+    return keyboardZones.playNote(pitch, velocidade_city, duracao_ms);
+}
+
+// chamada pelo agendador quando a duração de uma nota termina
+void noteSchedulerNoteOffCallback(uint8_t channel_p, uint8_t pitch_p)
+{
+    uint8 message[3] = {(uint8)(0b10010000 | channel_p), pitch_p, 0};
+
+    voiceTracker.sendMessage(message, 3);
+}
+
 // troca o instrumento por mandar uma mensagem via tx do atmega
 // usando 2 bytes com nenhum bit de paridade e um stopbit, primeiro byte de
-// status (Status_byte) e depois o instrumento (Data_byte)
+// status (Status_byte) e depois o instrumento (Data_byte); se o canal já
+// estiver com esse instrumento, nada é enviado
 void change_instrument(Midi_t *midi, uint8 instrument)
 {
     midi->STATUS_BYTE = (0b11000000 | (midi->MIDI_CHANEL & 0b00001111));
@@ -312,8 +401,7 @@ void change_instrument(Midi_t *midi, uint8 instrument)
     clrBit(midi->DATA_SENT, 0);         // setando a quantidade de bytes
     setBit(midi->DATA_SENT, 1);         //
     setBit(midi->DATA_SENT, 3);         // change_instrument
-    play(midi);
-    delayMs(1);
+    channelState.setProgram(midi->MIDI_CHANEL & 0b00001111, midi->DATA_BYTE1);
 }
 
 //void play_major_chord();
@@ -330,14 +418,14 @@ int main()
     // Local variables
     Keypad keypad;
     uint8_t keyPressed;
+    uint8_t keyHeld;
 
 
-    uint8_t AccelX;
-    uint8_t AccelY;
-    uint8_t AccelZ;
-    int8_t  AccelXConv;
-    int8_t  AccelYConv;
-    int8_t  AccelZConv;
+    Mpu9250 mpu;
+    int16_t AccelX;
+    int16_t AccelY;
+    int16_t AccelZ;
+    MotionTracker::Event evento;
 
     uint8_t instrumento = 0;
 
@@ -345,17 +433,18 @@ int main()
     // MIDI configuration
     Midi_t midi;
     init_midi(&midi, 0);
+    // base de tempo única de 1 ms no TIMER0: conta os timeouts do TWI,
+    // mede a latência das transações e marca o tempo do agendador de notas,
+    // do sequenciador, do player SMF, do teclado e do acelerômetro
+    systemTick.init();
     sei();
 
     uint8 oitava_ = 0;
     uint8 velocidade_ = fff;
-    //uint32_t sustentacao = 78125; //tempo de sustentação da nota
-    // (0,5 s converção)
-    //  t = 1024*(sustentacao)[vai até 2^16, ao todo 67M]/(16M)
-    // máximo de 4,2 segundos.
+    uint16_t sustentacao = 500; // tempo de sustentação da nota, em ms
 
-    //timer2.init(Timer2::Mode::CTC_OCRA, Timer2::ClockSource::PRESCALER_1024);
-    //timer2.setCompareAValue(sustentacao);
+    // agendador de note_off (usa a base de tempo do TIMER0)
+    noteScheduler.init();
 
     // MIDI configuration
 
@@ -370,338 +459,126 @@ int main()
     );
     keypad.init(5);
 
-    twi.init(10000);
+    // 400 kHz: uma leitura completa do acelerômetro leva cerca de 250 us
+    twi.init(400000);
+
+    // acorda o módulo e confere a identificação (endereço 0x68)
+    mpu.init(&twi);
 
-    twi.setDevice(MPU9250_SLAVEADRESS); // endereço do módulo
-//    // envia o que esta no buffer para o registrador do módulo
-    // nao usa twi.writeReg();
-//    // lê o que esta no buffer para o registrador do módulo
+    // a placa também responde como escrava no barramento I2C (endereço
+    // 0x30): um controlador externo lê as notas soando e a tecla pressionada
+    // e envia comandos de nota pelo mapa de registradores
+    midiPeripheral.init();
 
-    // Lê os valores dos registradores high do módulo
-    twi.readReg(0x3B, &AccelX, 1);
-    twi.readReg(0x3D, &AccelY, 1);
-    twi.readReg(0x3F, &AccelZ, 1);
+    // controladores contínuos pela inclinação em relação à posição de
+    // repouso (a orientação que escolheu o instrumento), limitados a
+    // 300 bytes/s para não atrasar as notas; em repouso a expressão fica no
+    // máximo e o pitch bend no centro, em qualquer orientação
+    motionMapper.init(midi.MIDI_CHANEL);
 
     while(1) {
 
-        twi.readReg(0x3B, &AccelX, 1);
-        twi.readReg(0x3D, &AccelY, 1);
-        twi.readReg(0x3F, &AccelZ, 1);
-        // Converte os valores do acelerômetro para valores com polaridade
-        AccelXConv = (int8_t)AccelX;
-        AccelYConv = (int8_t)AccelY;
-        AccelZConv = (int8_t)AccelZ;
+        // amostra o acelerômetro a uma taxa fixa (a cada 10 ms); a leitura
+        // corre na interrupção do TWI e o laço só pega o resultado
+        if(motionTracker.isSampleDue() && !mpu.isBusy()) {
+            mpu.startRead();
+        }
+        if(mpu.process()) {
+            mpu.getAccel(&AccelX, &AccelY, &AccelZ);
+            // filtra, estima a orientação e detecta os gestos
+            motionTracker.update(AccelX, AccelY, AccelZ);
+            // inclinação -> modulação, expressão e pitch bend
+            motionMapper.update();
+        }
 
         // valores para instrumento 0; 16 orgao; 46 harpa; 79 ocarina;
         //                          26 guitarra jazz; 19 orgam igreja;
-        // Seleciona o instrumento de acordo com o acelerômetro
-        if(AccelZConv > 49) {
-            instrumento = 0;
-        }
-        if(AccelZConv < -49) {
-            instrumento = 16;
+        // Seleciona o instrumento de acordo com a orientação do módulo; a
+        // histerese evita que o instrumento fique trocando perto dos limites
+        while(motionTracker.getEvent(&evento)) {
+            switch(evento) {
+            case MotionTracker::Event::ORIENTATION_CHANGED:
+                switch(motionTracker.getOrientation()) {
+                case MotionTracker::Orientation::Z_UP:      instrumento = 0;    break;
+                case MotionTracker::Orientation::Z_DOWN:    instrumento = 16;   break;
+                case MotionTracker::Orientation::Y_UP:      instrumento = 19;   break;
+                case MotionTracker::Orientation::Y_DOWN:    instrumento = 26;   break;
+                case MotionTracker::Orientation::X_UP:      instrumento = 46;   break;
+                case MotionTracker::Orientation::X_DOWN:    instrumento = 79;   break;
+                default:                                                        break;
+                }
+                break;
+            case MotionTracker::Event::SHAKE:   // chacoalhar interrompe a música
+                if(sequencer.isPlaying()) {
+                    sequencer.stop();
+                }
+                break;
+            default:
+                break;
+            }
         }
-        if(AccelYConv > 49) {
-            instrumento = 19;
-        }
-        if(AccelYConv < -49) {
-            instrumento = 26;
-        }
-        if(AccelXConv > 49) {
-            instrumento = 46;
+
+        // reenviar o mesmo instrumento não gera tráfego: a tabela de estado
+        // dos canais só envia o program change quando o instrumento muda
+        change_instrument(&midi, instrumento);
+
+        // repassa as mensagens recebidas (MIDI THRU)
+        midiMerge.process();
+
+        // desliga as notas cuja duração terminou (da música e do teclado)
+        // antes de tocar os eventos da música, para que uma nota repetida
+        // seja rearticulada
+        noteScheduler.process();
+        sequencer.process();
+
+        // com a saída pela porta SDI do VS1053, os bytes são enviados aqui;
+        // com a USART não faz nada (quem envia é a interrupção)
+        midiOutput.process();
+
+        // lê o teclado sem esperar a tecla ser solta, para não parar o
+        // MIDI THRU; a tecla é informada uma vez, quando é pressionada
+        keypad.scanKeyPressed(&keyPressed, &keyHeld);
+        // atualiza o mapa de registradores I2C e toca as notas pedidas pelo
+        // controlador externo
+        midiPeripheral.update(keyHeld);
+        midiPeripheral.process();
+        // qualquer tecla interrompe a música que estiver tocando
+        if((keyPressed != 0xFF) && sequencer.isPlaying()) {
+            sequencer.stop();
         }
-        if(AccelXConv < -49) {
-            instrumento = 79;
+        // avisa os dispositivos sincronizados quando a música termina
+        if(!sequencer.isPlaying() && midiClock.isPlaying()) {
+            midiClock.stop();
         }
-
-        //change_instrument(&midi, instrumento);
-
-        keypad.readKeyPressed(&keyPressed);
         switch(keyPressed) {
-        case 0x00:// de 0x00 a 0x0B toca as notas
-            note_on(&midi, C, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, C, oitava_);
-            break;
+        case 0x00:// de 0x00 a 0x0B toca as notas (C a B)
         case 0x01:
-            note_on(&midi, C_s, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, C_s, oitava_);
-            break;
         case 0x02:
-            note_on(&midi, D, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, D, oitava_);
-            break;
         case 0x03:
-            note_on(&midi, D_s, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, D_s, oitava_);
-            break;
         case 0x04:
-            note_on(&midi, E, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, E, oitava_);
-            break;
         case 0x05:
-            note_on(&midi, F, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, F, oitava_);
-            break;
         case 0x06:
-            note_on(&midi, F_s, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, F_s, oitava_);
-            break;
         case 0x07:
-            note_on(&midi, G, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, G, oitava_);
-            break;
         case 0x08:
-            note_on(&midi, G_s, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, G_s, oitava_);
-            break;
         case 0x09:
-            note_on(&midi, A, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, A, oitava_);
-            break;
         case 0x0A:
-            note_on(&midi, A_s, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, A_s, oitava_);
-            break;
         case 0x0B:
-            note_on(&midi, B, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, B, oitava_);
+            play_note(&midi, keyPressed, oitava_, velocidade_, sustentacao);
             break;
         case 0x0C : // Muda o instrumento
             change_instrument(&midi, instrumento);
             break;
-        case 0x0D:
-            // Jingle Bells, Jingle Bells
-            note_on(&midi, E, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, E, oitava_);
-
-            note_on(&midi, E, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, E, oitava_);
-
-            note_on(&midi, E, oitava_, velocidade_);
-            delayMs(1000);
-            note_off(&midi, E, oitava_);
-
-            // Jingle all the way
-            note_on(&midi, E, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, E, oitava_);
-
-            note_on(&midi, E, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, E, oitava_);
-
-            note_on(&midi, E, oitava_, velocidade_);
-            delayMs(1000);
-            note_off(&midi, E, oitava_);
-
-            // Oh, what fun it is to ride
-            note_on(&midi, G, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, G, oitava_);
-
-            note_on(&midi, A, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, A, oitava_);
-
-            note_on(&midi, A, oitava_, velocidade_);
-            delayMs(1000);
-            note_off(&midi, A, oitava_);
-
-            // In a one-horse open sleigh
-            note_on(&midi, A, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, A, oitava_);
-
-            note_on(&midi, G, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, G, oitava_);
-
-            note_on(&midi, F, oitava_, velocidade_);
-            delayMs(1000);
-            note_off(&midi, F, oitava_);
+        case 0x0D: // Jingle Bells
+            sequencer.play(jingleBells, songLength(jingleBells), midi.MIDI_CHANEL);
+            midiClock.start();
             break;
-        case 0x0E:
-            // Brilha, brilha, estrelinha
-            note_on(&midi, C, oitava_, velocidade_);
-            delayMs(600);
-            note_off(&midi, C, oitava_);
-
-            note_on(&midi, C, oitava_, velocidade_);
-            delayMs(600);
-            note_off(&midi, C, oitava_);
-
-            note_on(&midi, G, oitava_, velocidade_);
-            delayMs(600);
-            note_off(&midi, G, oitava_);
-
-            note_on(&midi, G, oitava_, velocidade_);
-            delayMs(600);
-            note_off(&midi, G, oitava_);
-
-            note_on(&midi, A, oitava_, velocidade_);
-            delayMs(600);
-            note_off(&midi, A, oitava_);
-
-            note_on(&midi, A, oitava_, velocidade_);
-            delayMs(600);
-            note_off(&midi, A, oitava_);
-
-            // Brilha, brilha, estrelinha
-            note_on(&midi, G, oitava_, velocidade_);
-            delayMs(600);
-            note_off(&midi, G, oitava_);
-
-            // Lá no alto é que está
-            note_on(&midi, F, oitava_, velocidade_);
-            delayMs(600);
-            note_off(&midi, F, oitava_);
-
-            // Como um diamante no céu
-            note_on(&midi, F, oitava_, velocidade_);
-            delayMs(600);
-            note_off(&midi, F, oitava_);
-
-            note_on(&midi, F, oitava_, velocidade_);
-            delayMs(600);
-            note_off(&midi, F, oitava_);
-
-            note_on(&midi, E, oitava_, velocidade_);
-            delayMs(600);
-            note_off(&midi, E, oitava_);
-
-            // Brilha, brilha, estrelinha
-            note_on(&midi, E, oitava_, velocidade_);
-            delayMs(600);
-            note_off(&midi, E, oitava_);
-
-            // Lá no alto é que está
-            note_on(&midi, D, oitava_, velocidade_);
-            delayMs(600);
-            note_off(&midi, D, oitava_);
-
-            // C note no final para dar uma pausa
-            note_on(&midi, C, oitava_, velocidade_);
-            delayMs(1200);
-            note_off(&midi, C, oitava_);
+        case 0x0E: // Brilha, brilha, estrelinha
+            sequencer.play(brilhaBrilha, songLength(brilhaBrilha), midi.MIDI_CHANEL);
+            midiClock.start();
             break;
-        case 0x0F:
-            // A Barata Diz Que Tem
-            note_on(&midi, A, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, A, oitava_);
-
-            note_on(&midi, G, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, G, oitava_);
-
-            note_on(&midi, F, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, F, oitava_);
-
-            note_on(&midi, E, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, E, oitava_);
-
-            note_on(&midi, D, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, D, oitava_);
-
-            note_on(&midi, C, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, C, oitava_);
-
-            // A barata diz que tem
-            note_on(&midi, A, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, A, oitava_);
-
-            note_on(&midi, G, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, G, oitava_);
-
-            note_on(&midi, F, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, F, oitava_);
-
-            note_on(&midi, E, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, E, oitava_);
-
-            note_on(&midi, D, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, D, oitava_);
-
-            note_on(&midi, C, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, C, oitava_);
-
-            // A barata diz que tem
-            note_on(&midi, A, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, A, oitava_);
-
-            note_on(&midi, G, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, G, oitava_);
-
-            note_on(&midi, F, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, F, oitava_);
-
-            note_on(&midi, E, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, E, oitava_);
-
-            note_on(&midi, D, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, D, oitava_);
-
-            note_on(&midi, C, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, C, oitava_);
-
-            // E o homem diz que não tem
-            note_on(&midi, G, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, G, oitava_);
-
-            note_on(&midi, A, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, A, oitava_);
-
-            note_on(&midi, G, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, G, oitava_);
-
-            note_on(&midi, F, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, F, oitava_);
-
-            note_on(&midi, E, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, E, oitava_);
-
-            note_on(&midi, D, oitava_, velocidade_);
-            delayMs(500);
-            note_off(&midi, D, oitava_);
-
-            note_on(&midi, C, oitava_, velocidade_);
-            delayMs(1000);
-            note_off(&midi, C, oitava_);
+        case 0x0F: // A Barata Diz Que Tem
+            sequencer.play(aBarata, songLength(aBarata), midi.MIDI_CHANEL);
+            midiClock.start();
             break;
         default:
             break;
@@ -709,34 +586,3 @@ int main()
     }
     return 0;
 }
-
-
-// os returns em cada instrução foram usados para que a função não tentasse
-// transmitir outro dado para o UDR0 sem esse estar zerado denovo
-void usartTransmissionBufferEmptyCallback()
-{
-    // De acordo com o valor em Midi_Variable.DATA_SENT manda os dados em Midi_Variable.STATUS_BYTE
-    // para noteon e noteoff manda 3 dados, para troca de instrumento manda 2 dados
-    if((Midi_Variable.DATA_SENT & 0b111) >= 4) {
-        UDR0 = Midi_Variable.STATUS_BYTE;
-        Midi_Variable.DATA_SENT = Midi_Variable.DATA_SENT - 4;
-        return ;
-    }
-    if((Midi_Variable.DATA_SENT & 0b111) == 3) {
-        UDR0 = Midi_Variable.DATA_BYTE1;
-        Midi_Variable.DATA_SENT = Midi_Variable.DATA_SENT - 2;
-        return;
-    }
-    if((Midi_Variable.DATA_SENT & 0b111) == 2) {
-        UDR0 = Midi_Variable.DATA_BYTE1;
-        Midi_Variable.DATA_SENT = 0;
-        clrBit(UCSR0B, UDRIE0); // disenables interrupt on the UDREn
-        return;
-    }
-    if((Midi_Variable.DATA_SENT & 0b111) == 1) {
-        UDR0 = Midi_Variable.DATA_BYTE2;
-        Midi_Variable.DATA_SENT = 0;
-        clrBit(UCSR0B, UDRIE0); // disenables interrupt on the UDREn
-        return;
-    }
-}
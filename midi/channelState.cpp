@@ -0,0 +1,413 @@
+//!
+//! \file           channelState.cpp
+//! \brief          Per-channel MIDI state table
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Per-channel MIDI state table
+//!
+
+// =============================================================================
+// System file dependencies
+// =============================================================================
+
+#include "channelState.hpp"
+#if !defined(__CHANNEL_STATE_HPP)
+#    error "Header file is corrupted!"
+#elif __CHANNEL_STATE_HPP != 2304
+#    error "Version mismatch between source and header files!"
+#endif
+
+// =============================================================================
+// File exclusive - Constants
+// =============================================================================
+
+#define DEBUG_CHANNEL_STATE             0x1FFF
+
+cuint8_t constControlResetAll           = 121;      //!< Reset All Controllers controller number
+cuint16_t constPitchBendUnknown         = 0xFFFF;   //!< Pitch bend not sent yet
+cuint16_t constPitchBendCenter          = 8192;     //!< Pitch bend center value
+
+// =============================================================================
+// File exclusive - New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// File exclusive - Global variables
+// =============================================================================
+
+ChannelState channelState;
+
+// =============================================================================
+// File exclusive - Macro-functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Class constructors
+// =============================================================================
+
+ChannelState::ChannelState(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("ChannelState::ChannelState(void)", DEBUG_CHANNEL_STATE);
+
+    // Reset data members
+    this->invalidate();
+    this->_suppressedCount              = 0;
+
+    // Returns successfully
+    this->_lastError                    = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_CHANNEL_STATE);
+    return;
+}
+
+ChannelState::~ChannelState(void)
+{
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_CHANNEL_STATE);
+    return;
+}
+
+// =============================================================================
+// Class public methods
+// =============================================================================
+
+//     ///////////////////     CONFIGURATION     ////////////////////     //
+void ChannelState::invalidate(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("ChannelState::invalidate(void)", DEBUG_CHANNEL_STATE);
+
+    // Forget every value
+    for(uint8_t i = 0; i < 16; i++) {
+        this->_program[i]               = CHANNEL_STATE_UNKNOWN;
+        this->_pitchBend[i]             = constPitchBendUnknown;
+        for(uint8_t j = 0; j < CHANNEL_STATE_CONTROLLERS; j++) {
+            this->_controller[i][j]     = CHANNEL_STATE_UNKNOWN;
+        }
+    }
+
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_CHANNEL_STATE);
+    return;
+}
+
+//     ////////////////////    DATA TRANSFER     ////////////////////     //
+bool_t ChannelState::sendMessage(cuint8_t *message_p, cuint8_t size_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("ChannelState::sendMessage(cuint8_t *, cuint8_t)", DEBUG_CHANNEL_STATE);
+
+    // Checks for errors
+    if(!isPointerValid(message_p)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_POINTER_NULL;
+        debugMessage(Error::ARGUMENT_POINTER_NULL, DEBUG_CHANNEL_STATE);
+        return false;
+    }
+
+    // Suppress redundant messages
+    if(this->_isRedundant(message_p, size_p)) {
+        if(this->_suppressedCount != 0xFFFF) {
+            this->_suppressedCount++;
+        }
+        this->_lastError = Error::NONE;
+        debugMessage(Error::NONE, DEBUG_CHANNEL_STATE);
+        return true;
+    }
+
+    // Send message
+    if(!voiceTracker.sendMessage(message_p, size_p)) {
+        // Returns error
+        this->_lastError = voiceTracker.getLastError();
+        debugMessage(this->_lastError, DEBUG_CHANNEL_STATE);
+        return false;
+    }
+    this->trackMessage(message_p, size_p);
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_CHANNEL_STATE);
+    return true;
+}
+
+void ChannelState::trackMessage(cuint8_t *message_p, cuint8_t size_p)
+{
+    // Local variables
+    uint8_t channel;
+    uint8_t index;
+
+    // Checks for errors
+    if(!isPointerValid(message_p) || (size_p == 0)) {
+        return;
+    }
+
+    // System Reset restores the default state of every channel
+    if(message_p[0] == 0xFF) {
+        this->invalidate();
+        return;
+    }
+
+    // Update channel state
+    channel = message_p[0] & 0x0F;
+    switch(message_p[0] & 0xF0) {
+    case 0xC0:
+        if(size_p == 2) {
+            this->_program[channel] = message_p[1];
+        }
+        break;
+    case 0xB0:
+        if(size_p != 3) {
+            break;
+        }
+        if(message_p[1] == constControlResetAll) {
+            // Volume, pan, bank and effects are not reset
+            this->_setController(channel, Controller::MODULATION, 0);
+            this->_setController(channel, Controller::EXPRESSION, 127);
+            this->_setController(channel, Controller::SUSTAIN, 0);
+            this->_pitchBend[channel] = constPitchBendCenter;
+            break;
+        }
+        index = this->_controllerIndex(message_p[1]);
+        if(index != CHANNEL_STATE_UNKNOWN) {
+            this->_controller[channel][index] = message_p[2];
+            if((message_p[1] == (uint8_t)Controller::BANK_SELECT_MSB) ||
+                            (message_p[1] == (uint8_t)Controller::BANK_SELECT_LSB)) {
+                // The new bank is used by the next Program Change
+                this->_program[channel] = CHANNEL_STATE_UNKNOWN;
+            }
+        }
+        break;
+    case 0xE0:
+        if(size_p == 3) {
+            this->_pitchBend[channel] = (uint16_t)message_p[1] | ((uint16_t)message_p[2] << 7);
+        }
+        break;
+    default:
+        break;
+    }
+
+    return;
+}
+
+bool_t ChannelState::setProgram(cuint8_t channel_p, cuint8_t program_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("ChannelState::setProgram(cuint8_t, cuint8_t)", DEBUG_CHANNEL_STATE);
+
+    // Local variables
+    uint8_t message[2];
+
+    // Checks for errors
+    if((channel_p > 15) || (program_p > 127)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+        debugMessage(Error::ARGUMENT_VALUE_INVALID, DEBUG_CHANNEL_STATE);
+        return false;
+    }
+
+    // Send message
+    message[0] = 0xC0 | channel_p;
+    message[1] = program_p;
+    return this->sendMessage(message, 2);
+}
+
+bool_t ChannelState::setBank(cuint8_t channel_p, cuint16_t bank_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("ChannelState::setBank(cuint8_t, cuint16_t)", DEBUG_CHANNEL_STATE);
+
+    // Checks for errors
+    if(bank_p > 16383) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+        debugMessage(Error::ARGUMENT_VALUE_INVALID, DEBUG_CHANNEL_STATE);
+        return false;
+    }
+
+    // Send messages
+    if(!this->setController(channel_p, (uint8_t)Controller::BANK_SELECT_MSB, (uint8_t)(bank_p >> 7))) {
+        // Returns error
+        return false;
+    }
+    return this->setController(channel_p, (uint8_t)Controller::BANK_SELECT_LSB, (uint8_t)(bank_p & 0x7F));
+}
+
+bool_t ChannelState::setController(cuint8_t channel_p, cuint8_t controller_p, cuint8_t value_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("ChannelState::setController(cuint8_t, cuint8_t, cuint8_t)", DEBUG_CHANNEL_STATE);
+
+    // Local variables
+    uint8_t message[3];
+
+    // Checks for errors
+    if((channel_p > 15) || (controller_p > 119) || (value_p > 127)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+        debugMessage(Error::ARGUMENT_VALUE_INVALID, DEBUG_CHANNEL_STATE);
+        return false;
+    }
+
+    // Send message
+    message[0] = 0xB0 | channel_p;
+    message[1] = controller_p;
+    message[2] = value_p;
+    return this->sendMessage(message, 3);
+}
+
+bool_t ChannelState::setPitchBend(cuint8_t channel_p, cuint16_t value_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("ChannelState::setPitchBend(cuint8_t, cuint16_t)", DEBUG_CHANNEL_STATE);
+
+    // Local variables
+    uint8_t message[3];
+
+    // Checks for errors
+    if((channel_p > 15) || (value_p > 16383)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+        debugMessage(Error::ARGUMENT_VALUE_INVALID, DEBUG_CHANNEL_STATE);
+        return false;
+    }
+
+    // Send message
+    message[0] = 0xE0 | channel_p;
+    message[1] = (uint8_t)(value_p & 0x7F);
+    message[2] = (uint8_t)(value_p >> 7);
+    return this->sendMessage(message, 3);
+}
+
+//     /////////////////     CONTROL AND STATUS     /////////////////     //
+uint8_t ChannelState::getProgram(cuint8_t channel_p)
+{
+    // Returns value
+    return this->_program[channel_p & 0x0F];
+}
+
+uint8_t ChannelState::getController(cuint8_t channel_p, cuint8_t controller_p)
+{
+    // Local variables
+    uint8_t index = this->_controllerIndex(controller_p);
+
+    // Returns value
+    if(index == CHANNEL_STATE_UNKNOWN) {
+        return CHANNEL_STATE_UNKNOWN;
+    }
+    return this->_controller[channel_p & 0x0F][index];
+}
+
+uint16_t ChannelState::getPitchBend(cuint8_t channel_p)
+{
+    // Returns value
+    return this->_pitchBend[channel_p & 0x0F];
+}
+
+uint16_t ChannelState::getSuppressedCount(void)
+{
+    // Returns value
+    return this->_suppressedCount;
+}
+
+void ChannelState::clearCounters(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("ChannelState::clearCounters(void)", DEBUG_CHANNEL_STATE);
+
+    // Reset data members
+    this->_suppressedCount              = 0;
+
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_CHANNEL_STATE);
+    return;
+}
+
+Error ChannelState::getLastError(void)
+{
+    // Returns last error
+    return this->_lastError;
+}
+
+// =============================================================================
+// Class private methods
+// =============================================================================
+
+//     ///////////////////     STATE TABLE     //////////////////////     //
+bool_t ChannelState::_isRedundant(cuint8_t *message_p, cuint8_t size_p)
+{
+    // Local variables
+    uint8_t channel = message_p[0] & 0x0F;
+    uint8_t index;
+
+    // Compare against the cached state
+    switch(message_p[0] & 0xF0) {
+    case 0xC0:
+        return ((size_p == 2) && (this->_program[channel] == message_p[1]));
+    case 0xB0:
+        if(size_p != 3) {
+            return false;
+        }
+        index = this->_controllerIndex(message_p[1]);
+        return ((index != CHANNEL_STATE_UNKNOWN) && (this->_controller[channel][index] == message_p[2]));
+    case 0xE0:
+        return ((size_p == 3) &&
+                        (this->_pitchBend[channel] == ((uint16_t)message_p[1] | ((uint16_t)message_p[2] << 7))));
+    default:
+        return false;
+    }
+}
+
+uint8_t ChannelState::_controllerIndex(cuint8_t controller_p)
+{
+    // Position of the controller in the state table
+    switch(controller_p) {
+    case (uint8_t)Controller::BANK_SELECT_MSB:  return 0;
+    case (uint8_t)Controller::MODULATION:       return 1;
+    case (uint8_t)Controller::VOLUME:           return 2;
+    case (uint8_t)Controller::PAN:              return 3;
+    case (uint8_t)Controller::EXPRESSION:       return 4;
+    case (uint8_t)Controller::BANK_SELECT_LSB:  return 5;
+    case (uint8_t)Controller::SUSTAIN:          return 6;
+    case (uint8_t)Controller::REVERB:           return 7;
+    case (uint8_t)Controller::CHORUS:           return 8;
+    default:                                    return CHANNEL_STATE_UNKNOWN;
+    }
+}
+
+void ChannelState::_setController(cuint8_t channel_p, Controller controller_p, cuint8_t value_p)
+{
+    // Update table entry
+    this->_controller[channel_p][this->_controllerIndex((uint8_t)controller_p)] = value_p;
+
+    return;
+}
+
+// =============================================================================
+// Class protected methods
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// General public functions definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+void midiMergeThruCallback(cuint8_t *message_p, cuint8_t size_p)
+{
+    channelState.trackMessage(message_p, size_p);
+}
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
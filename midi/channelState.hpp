@@ -0,0 +1,352 @@
+//!
+//! \file           channelState.hpp
+//! \brief          Per-channel MIDI state table
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Caches the program, bank, pitch bend and the values of
+//!                     the most used controllers (volume, pan, modulation,
+//!                     expression, sustain, reverb and chorus) of each of
+//!                     the 16 MIDI channels. Program, controller and pitch
+//!                     bend changes that would not change the cached state
+//!                     are not sent, so the link is not flooded by code that
+//!                     keeps asserting the same values.
+//!
+//!                     Values are unknown until they are sent for the first
+//!                     time, so the first change is always sent. Messages
+//!                     forwarded by the MIDI merge engine also update the
+//!                     table.
+//!
+
+// =============================================================================
+// Include guard (START)
+// =============================================================================
+
+#ifndef __CHANNEL_STATE_HPP
+#define __CHANNEL_STATE_HPP                     2304
+
+// =============================================================================
+// Dependencies
+// =============================================================================
+
+//     /////////////////     GLOBAL DEFINITIONS FILE    /////////////////     //
+#include "../funsape/globalDefines.hpp"
+#if !defined(__GLOBAL_DEFINES_HPP)
+#   error "Global definitions file is corrupted!"
+#elif __GLOBAL_DEFINES_HPP != __CHANNEL_STATE_HPP
+#   error "Version mismatch between file header and global definitions file!"
+#endif
+
+//     //////////////////     LIBRARY DEPENDENCIES     //////////////////     //
+#include "voiceTracker.hpp"
+#if !defined(__VOICE_TRACKER_HPP)
+#   error "Header file (voiceTracker.hpp) is corrupted!"
+#elif __VOICE_TRACKER_HPP != __CHANNEL_STATE_HPP
+#   error "Version mismatch between header file and library dependency (voiceTracker.hpp)!"
+#endif
+
+// =============================================================================
+// Undefining previous definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Constant definitions
+// =============================================================================
+
+//!
+//! \brief          Value returned for unknown or untracked state
+//!
+#define CHANNEL_STATE_UNKNOWN           0xFF
+
+//!
+//! \brief          Number of controllers tracked per channel
+//!
+#define CHANNEL_STATE_CONTROLLERS       9
+
+// =============================================================================
+// New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// ChannelState Class
+// =============================================================================
+
+//!
+//! \brief          ChannelState class
+//! \details        Local messages that may change the channel state must be
+//!                     sent through sendMessage() or the setter methods,
+//!                     which forward them to the voice tracker.
+//!
+class ChannelState
+{
+    // -------------------------------------------------------------------------
+    // New data types ----------------------------------------------------------
+public:
+    //!
+    //! \brief      Controller numbers enumeration
+    //! \details    Numbers of the controllers tracked by the state table.
+    //!
+    enum class Controller : uint8_t {
+        BANK_SELECT_MSB                 = 0,
+        MODULATION                      = 1,
+        VOLUME                          = 7,
+        PAN                             = 10,
+        EXPRESSION                      = 11,
+        BANK_SELECT_LSB                 = 32,
+        SUSTAIN                         = 64,
+        REVERB                          = 91,
+        CHORUS                          = 93,
+    };
+
+    // -------------------------------------------------------------------------
+    // Constructors ------------------------------------------------------------
+public:
+    //!
+    //! \brief      ChannelState class constructor
+    //! \details    Creates a ChannelState object
+    //!
+    ChannelState(
+            void
+    );
+
+    //!
+    //! \brief      ChannelState class destructor
+    //! \details    Destroys a ChannelState object
+    //!
+    ~ChannelState(
+            void
+    );
+
+    // -------------------------------------------------------------------------
+    // Methods -----------------------------------------------------------------
+public:
+    //     ///////////////////     CONFIGURATION     ////////////////////     //
+
+    //!
+    //! \brief      Forgets the state of every channel
+    //! \details    Marks every value as unknown, so the next change of each
+    //!                 one is sent. Must be called when the synthesizer is
+    //!                 reset.
+    //!
+    void invalidate(
+            void
+    );
+
+    //     ////////////////////    DATA TRANSFER     ////////////////////     //
+
+    //!
+    //! \brief      Sends a locally generated message
+    //! \details    Updates the state table and sends the message through the
+    //!                 voice tracker. Program Change, tracked Control Change
+    //!                 and Pitch Bend messages that would not change the
+    //!                 cached state are not sent.
+    //! \param      message_p           Pointer to the message bytes
+    //! \param      size_p              Number of bytes of the message (1 to 3)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t sendMessage(
+            cuint8_t *message_p,
+            cuint8_t size_p
+    );
+
+    //!
+    //! \brief      Updates the state table
+    //! \details    Updates the state table with a message sent by another
+    //!                 source, without sending it.
+    //! \param      message_p           Pointer to the message bytes
+    //! \param      size_p              Number of bytes of the message (1 to 3)
+    //!
+    void trackMessage(
+            cuint8_t *message_p,
+            cuint8_t size_p
+    );
+
+    //!
+    //! \brief      Changes the program of a channel
+    //! \details    Sends a Program Change message if the program differs from
+    //!                 the cached one.
+    //! \param      channel_p           MIDI channel (0 to 15)
+    //! \param      program_p           Program number (0 to 127)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t setProgram(
+            cuint8_t channel_p,
+            cuint8_t program_p
+    );
+
+    //!
+    //! \brief      Selects the bank of a channel
+    //! \details    Sends the Bank Select messages that differ from the cached
+    //!                 ones. The new bank is used by the synthesizer after the
+    //!                 next Program Change, so the cached program becomes
+    //!                 unknown.
+    //! \param      channel_p           MIDI channel (0 to 15)
+    //! \param      bank_p              Bank number (0 to 16383)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t setBank(
+            cuint8_t channel_p,
+            cuint16_t bank_p
+    );
+
+    //!
+    //! \brief      Changes a controller of a channel
+    //! \details    Sends a Control Change message, unless the controller is
+    //!                 tracked and its value equals the cached one.
+    //! \param      channel_p           MIDI channel (0 to 15)
+    //! \param      controller_p        Controller number (0 to 119)
+    //! \param      value_p             Controller value (0 to 127)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t setController(
+            cuint8_t channel_p,
+            cuint8_t controller_p,
+            cuint8_t value_p
+    );
+
+    //!
+    //! \brief      Changes the pitch bend of a channel
+    //! \details    Sends a Pitch Bend message if the value differs from the
+    //!                 cached one.
+    //! \param      channel_p           MIDI channel (0 to 15)
+    //! \param      value_p             Pitch bend (0 to 16383, 8192 is center)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t setPitchBend(
+            cuint8_t channel_p,
+            cuint16_t value_p
+    );
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+
+    //!
+    //! \brief      Returns the program of a channel
+    //! \details    Returns the program of a channel.
+    //! \param      channel_p           MIDI channel (0 to 15)
+    //! \return     uint8_t             Program number, or
+    //!                                     CHANNEL_STATE_UNKNOWN
+    //!
+    uint8_t getProgram(
+            cuint8_t channel_p
+    );
+
+    //!
+    //! \brief      Returns the value of a controller of a channel
+    //! \details    Returns the value of a controller of a channel.
+    //! \param      channel_p           MIDI channel (0 to 15)
+    //! \param      controller_p        Controller number
+    //! \return     uint8_t             Controller value, or
+    //!                                     CHANNEL_STATE_UNKNOWN if the value
+    //!                                     is unknown or not tracked
+    //!
+    uint8_t getController(
+            cuint8_t channel_p,
+            cuint8_t controller_p
+    );
+
+    //!
+    //! \brief      Returns the pitch bend of a channel
+    //! \details    Returns the pitch bend of a channel.
+    //! \param      channel_p           MIDI channel (0 to 15)
+    //! \return     uint16_t            Pitch bend, or 0xFFFF if unknown
+    //!
+    uint16_t getPitchBend(
+            cuint8_t channel_p
+    );
+
+    //!
+    //! \brief      Returns the number of suppressed messages
+    //! \details    Returns the number of messages that were not sent because
+    //!                 they would not change the cached state. The counter
+    //!                 saturates at 0xFFFF.
+    //! \return     uint16_t            Suppressed messages
+    //!
+    uint16_t getSuppressedCount(
+            void
+    );
+
+    //!
+    //! \brief      Clears the counters
+    //! \details    Clears the suppressed messages counter.
+    //!
+    void clearCounters(
+            void
+    );
+
+    //!
+    //! \brief      Returns the last error
+    //! \details    Returns the last error.
+    //! \return     Error               Error status of the last operation
+    //!
+    Error getLastError(
+            void
+    );
+
+private:
+    //     ///////////////////     STATE TABLE     //////////////////////     //
+    bool_t _isRedundant(
+            cuint8_t *message_p,
+            cuint8_t size_p
+    );
+
+    uint8_t _controllerIndex(
+            cuint8_t controller_p
+    );
+
+    void _setController(
+            cuint8_t channel_p,
+            Controller controller_p,
+            cuint8_t value_p
+    );
+
+protected:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Properties --------------------------------------------------------------
+private:
+    //     ///////////////////     STATE TABLE     //////////////////////     //
+    uint8_t             _program[16];
+    uint8_t             _controller[16][CHANNEL_STATE_CONTROLLERS];
+    uint16_t            _pitchBend[16];
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+    uint16_t            _suppressedCount;
+    Error               _lastError;
+}; // class ChannelState
+
+// =============================================================================
+// ChannelState - Class inline function definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// External global variables
+// =============================================================================
+
+//!
+//! \brief          Channel state table handler object
+//! \details        Channel state table handler object
+//!
+extern ChannelState channelState;
+
+// =============================================================================
+// Include guard (END)
+// =============================================================================
+
+#endif  // __CHANNEL_STATE_HPP
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
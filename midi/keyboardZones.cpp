@@ -0,0 +1,263 @@
+//!
+//! \file           keyboardZones.cpp
+//! \brief          Keyboard split and layer zones
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Keyboard split and layer zones
+//!
+
+// =============================================================================
+// System file dependencies
+// =============================================================================
+
+#include "keyboardZones.hpp"
+#if !defined(__KEYBOARD_ZONES_HPP)
+#    error "Header file is corrupted!"
+#elif __KEYBOARD_ZONES_HPP != 2304
+#    error "Version mismatch between source and header files!"
+#endif
+
+// =============================================================================
+// File exclusive - Constants
+// =============================================================================
+
+#define DEBUG_KEYBOARD_ZONES            0x1FFF
+
+// =============================================================================
+// File exclusive - New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// File exclusive - Global variables
+// =============================================================================
+
+KeyboardZones keyboardZones;
+
+// =============================================================================
+// File exclusive - Macro-functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Class constructors
+// =============================================================================
+
+KeyboardZones::KeyboardZones(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("KeyboardZones::KeyboardZones(void)", DEBUG_KEYBOARD_ZONES);
+
+    // Reset data members
+    for(uint8_t i = 0; i < KEYBOARD_ZONES_COUNT; i++) {
+        this->_lowKey[i]                = 0;
+        this->_highKey[i]               = 127;
+        this->_channel[i]               = 0;
+        this->_program[i]               = CHANNEL_STATE_UNKNOWN;
+        this->_transpose[i]             = 0;
+    }
+    this->_enabled                      = 0;
+
+    // Returns successfully
+    this->_lastError                    = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_KEYBOARD_ZONES);
+    return;
+}
+
+KeyboardZones::~KeyboardZones(void)
+{
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_KEYBOARD_ZONES);
+    return;
+}
+
+// =============================================================================
+// Class public methods
+// =============================================================================
+
+//     ///////////////////     CONFIGURATION     ////////////////////     //
+bool_t KeyboardZones::setZone(cuint8_t index_p, cuint8_t lowKey_p, cuint8_t highKey_p, cuint8_t channel_p,
+        cuint8_t program_p, cint8_t transpose_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("KeyboardZones::setZone(cuint8_t, cuint8_t, cuint8_t, cuint8_t, cuint8_t, cint8_t)",
+            DEBUG_KEYBOARD_ZONES);
+
+    // Checks for errors
+    if((index_p >= KEYBOARD_ZONES_COUNT) || (highKey_p > 127) || (lowKey_p > highKey_p) || (channel_p > 15) ||
+                    ((program_p > 127) && (program_p != CHANNEL_STATE_UNKNOWN))) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+        debugMessage(Error::ARGUMENT_VALUE_INVALID, DEBUG_KEYBOARD_ZONES);
+        return false;
+    }
+
+    // Update data members
+    this->_lowKey[index_p]              = lowKey_p;
+    this->_highKey[index_p]             = highKey_p;
+    this->_channel[index_p]             = channel_p;
+    this->_program[index_p]             = program_p;
+    this->_transpose[index_p]           = transpose_p;
+    setBit(this->_enabled, index_p);
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_KEYBOARD_ZONES);
+    return true;
+}
+
+bool_t KeyboardZones::clearZone(cuint8_t index_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("KeyboardZones::clearZone(cuint8_t)", DEBUG_KEYBOARD_ZONES);
+
+    // Checks for errors
+    if(index_p >= KEYBOARD_ZONES_COUNT) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+        debugMessage(Error::ARGUMENT_VALUE_INVALID, DEBUG_KEYBOARD_ZONES);
+        return false;
+    }
+
+    // Update data members
+    clrBit(this->_enabled, index_p);
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_KEYBOARD_ZONES);
+    return true;
+}
+
+//     ////////////////////    DATA TRANSFER     ////////////////////     //
+bool_t KeyboardZones::noteOn(cuint8_t key_p, cuint8_t velocity_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("KeyboardZones::noteOn(cuint8_t, cuint8_t)", DEBUG_KEYBOARD_ZONES);
+
+    // Checks for errors
+    if((velocity_p == 0) || (velocity_p > 127)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+        debugMessage(Error::ARGUMENT_VALUE_INVALID, DEBUG_KEYBOARD_ZONES);
+        return false;
+    }
+
+    // Send notes
+    return this->_sendNote(key_p, velocity_p, 0);
+}
+
+bool_t KeyboardZones::noteOff(cuint8_t key_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("KeyboardZones::noteOff(cuint8_t)", DEBUG_KEYBOARD_ZONES);
+
+    // Send notes
+    return this->_sendNote(key_p, 0, 0);
+}
+
+bool_t KeyboardZones::playNote(cuint8_t key_p, cuint8_t velocity_p, cuint16_t durationMs_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("KeyboardZones::playNote(cuint8_t, cuint8_t, cuint16_t)", DEBUG_KEYBOARD_ZONES);
+
+    // Checks for errors
+    if((velocity_p == 0) || (velocity_p > 127)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+        debugMessage(Error::ARGUMENT_VALUE_INVALID, DEBUG_KEYBOARD_ZONES);
+        return false;
+    }
+    if(durationMs_p == 0) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_CANNOT_BE_ZERO;
+        debugMessage(Error::ARGUMENT_CANNOT_BE_ZERO, DEBUG_KEYBOARD_ZONES);
+        return false;
+    }
+
+    // Send notes
+    return this->_sendNote(key_p, velocity_p, durationMs_p);
+}
+
+//     /////////////////     CONTROL AND STATUS     /////////////////     //
+Error KeyboardZones::getLastError(void)
+{
+    // Returns last error
+    return this->_lastError;
+}
+
+// =============================================================================
+// Class private methods
+// =============================================================================
+
+//     ////////////////////    DATA TRANSFER     ////////////////////     //
+bool_t KeyboardZones::_sendNote(cuint8_t key_p, cuint8_t velocity_p, cuint16_t durationMs_p)
+{
+    // Local variables
+    uint8_t message[3];
+    int16_t pitch;
+
+    // Checks for errors
+    if(key_p > 127) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+        debugMessage(Error::ARGUMENT_VALUE_INVALID, DEBUG_KEYBOARD_ZONES);
+        return false;
+    }
+
+    // Send the note on every zone that contains the key
+    this->_lastError = Error::NONE;
+    for(uint8_t i = 0; i < KEYBOARD_ZONES_COUNT; i++) {
+        if(isBitClr(this->_enabled, i) || (key_p < this->_lowKey[i]) || (key_p > this->_highKey[i])) {
+            continue;
+        }
+        pitch = (int16_t)key_p + this->_transpose[i];
+        if((pitch < 0) || (pitch > 127)) {
+            continue;
+        }
+        if((velocity_p != 0) && (this->_program[i] != CHANNEL_STATE_UNKNOWN)) {
+            channelState.setProgram(this->_channel[i], this->_program[i]);
+        }
+        message[0] = 0x90 | this->_channel[i];
+        message[1] = (uint8_t)pitch;
+        message[2] = velocity_p;
+        if(!channelState.sendMessage(message, 3)) {
+            this->_lastError = channelState.getLastError();
+            continue;
+        }
+        if((durationMs_p != 0) && !noteScheduler.scheduleNoteOff(this->_channel[i], message[1], durationMs_p)) {
+            // Scheduler is full - do not leave the note hanging
+            message[2] = 0;
+            channelState.sendMessage(message, 3);
+            this->_lastError = noteScheduler.getLastError();
+        }
+    }
+
+    // Returns status
+    debugMessage(this->_lastError, DEBUG_KEYBOARD_ZONES);
+    return (this->_lastError == Error::NONE);
+}
+
+// =============================================================================
+// Class protected methods
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// General public functions definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
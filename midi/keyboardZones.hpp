@@ -0,0 +1,258 @@
+//!
+//! \file           keyboardZones.hpp
+//! \brief          Keyboard split and layer zones
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Routes the notes played on the keyboard to one or more
+//!                     MIDI channels, according to a table of key ranges.
+//!                     Each zone has its own channel, program and transpose;
+//!                     zones with disjoint ranges split the keyboard, and
+//!                     overlapping zones layer the instruments.
+//!
+
+// =============================================================================
+// Include guard (START)
+// =============================================================================
+
+#ifndef __KEYBOARD_ZONES_HPP
+#define __KEYBOARD_ZONES_HPP                    2304
+
+// =============================================================================
+// Dependencies
+// =============================================================================
+
+//     /////////////////     GLOBAL DEFINITIONS FILE    /////////////////     //
+#include "../funsape/globalDefines.hpp"
+#if !defined(__GLOBAL_DEFINES_HPP)
+#   error "Global definitions file is corrupted!"
+#elif __GLOBAL_DEFINES_HPP != __KEYBOARD_ZONES_HPP
+#   error "Version mismatch between file header and global definitions file!"
+#endif
+
+//     //////////////////     LIBRARY DEPENDENCIES     //////////////////     //
+#include "channelState.hpp"
+#if !defined(__CHANNEL_STATE_HPP)
+#   error "Header file (channelState.hpp) is corrupted!"
+#elif __CHANNEL_STATE_HPP != __KEYBOARD_ZONES_HPP
+#   error "Version mismatch between header file and library dependency (channelState.hpp)!"
+#endif
+
+#include "noteScheduler.hpp"
+#if !defined(__NOTE_SCHEDULER_HPP)
+#   error "Header file (noteScheduler.hpp) is corrupted!"
+#elif __NOTE_SCHEDULER_HPP != __KEYBOARD_ZONES_HPP
+#   error "Version mismatch between header file and library dependency (noteScheduler.hpp)!"
+#endif
+
+// =============================================================================
+// Undefining previous definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Constant definitions
+// =============================================================================
+
+#ifndef KEYBOARD_ZONES_COUNT
+//!
+//! \brief          Number of keyboard zones
+//!
+#   define KEYBOARD_ZONES_COUNT         4
+#endif
+#if KEYBOARD_ZONES_COUNT > 8
+#   error "KEYBOARD_ZONES_COUNT must not be greater than 8!"
+#endif
+
+// =============================================================================
+// New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// KeyboardZones Class
+// =============================================================================
+
+//!
+//! \brief          KeyboardZones class
+//! \details        Every zone starts disabled. Before each note, the program
+//!                     of the zone is asserted through the channel state
+//!                     table, so it is only sent when the channel is playing
+//!                     another instrument.
+//!
+class KeyboardZones
+{
+    // -------------------------------------------------------------------------
+    // New data types ----------------------------------------------------------
+public:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Constructors ------------------------------------------------------------
+public:
+    //!
+    //! \brief      KeyboardZones class constructor
+    //! \details    Creates a KeyboardZones object
+    //!
+    KeyboardZones(
+            void
+    );
+
+    //!
+    //! \brief      KeyboardZones class destructor
+    //! \details    Destroys a KeyboardZones object
+    //!
+    ~KeyboardZones(
+            void
+    );
+
+    // -------------------------------------------------------------------------
+    // Methods -----------------------------------------------------------------
+public:
+    //     ///////////////////     CONFIGURATION     ////////////////////     //
+
+    //!
+    //! \brief      Configures and enables a zone
+    //! \details    Configures and enables a zone.
+    //! \param      index_p             Zone index (0 to KEYBOARD_ZONES_COUNT - 1)
+    //! \param      lowKey_p            Lowest key of the zone (0 to 127)
+    //! \param      highKey_p           Highest key of the zone (lowKey_p to 127)
+    //! \param      channel_p           MIDI channel of the zone (0 to 15)
+    //! \param      program_p           Program of the zone (0 to 127), or
+    //!                                     CHANNEL_STATE_UNKNOWN to keep the
+    //!                                     program of the channel
+    //! \param      transpose_p         Transpose, in semitones
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t setZone(
+            cuint8_t index_p,
+            cuint8_t lowKey_p,
+            cuint8_t highKey_p,
+            cuint8_t channel_p,
+            cuint8_t program_p,
+            cint8_t transpose_p = 0
+    );
+
+    //!
+    //! \brief      Disables a zone
+    //! \details    Disables a zone. Notes already sounding are not affected.
+    //! \param      index_p             Zone index (0 to KEYBOARD_ZONES_COUNT - 1)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t clearZone(
+            cuint8_t index_p
+    );
+
+    //     ////////////////////    DATA TRANSFER     ////////////////////     //
+
+    //!
+    //! \brief      Plays a key
+    //! \details    Sends a Note On message on every zone that contains the
+    //!                 key.
+    //! \param      key_p               Key number (0 to 127)
+    //! \param      velocity_p          Note velocity (1 to 127)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t noteOn(
+            cuint8_t key_p,
+            cuint8_t velocity_p
+    );
+
+    //!
+    //! \brief      Releases a key
+    //! \details    Sends a Note Off message on every zone that contains the
+    //!                 key.
+    //! \param      key_p               Key number (0 to 127)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t noteOff(
+            cuint8_t key_p
+    );
+
+    //!
+    //! \brief      Plays a key for a given time
+    //! \details    Sends a Note On message on every zone that contains the
+    //!                 key and schedules the matching Note Off messages. If
+    //!                 the note scheduler is full, the note is released
+    //!                 immediately.
+    //! \param      key_p               Key number (0 to 127)
+    //! \param      velocity_p          Note velocity (1 to 127)
+    //! \param      durationMs_p        Note duration, in milliseconds
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t playNote(
+            cuint8_t key_p,
+            cuint8_t velocity_p,
+            cuint16_t durationMs_p
+    );
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+
+    //!
+    //! \brief      Returns the last error
+    //! \details    Returns the last error.
+    //! \return     Error               Error status of the last operation
+    //!
+    Error getLastError(
+            void
+    );
+
+private:
+    //     ////////////////////    DATA TRANSFER     ////////////////////     //
+    bool_t _sendNote(
+            cuint8_t key_p,
+            cuint8_t velocity_p,
+            cuint16_t durationMs_p
+    );
+
+protected:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Properties --------------------------------------------------------------
+private:
+    //     ////////////////////     ZONE TABLE     //////////////////////     //
+    uint8_t             _lowKey[KEYBOARD_ZONES_COUNT];
+    uint8_t             _highKey[KEYBOARD_ZONES_COUNT];
+    uint8_t             _channel[KEYBOARD_ZONES_COUNT];
+    uint8_t             _program[KEYBOARD_ZONES_COUNT];
+    int8_t              _transpose[KEYBOARD_ZONES_COUNT];
+    uint8_t             _enabled;
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+    Error               _lastError;
+}; // class KeyboardZones
+
+// =============================================================================
+// KeyboardZones - Class inline function definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// External global variables
+// =============================================================================
+
+//!
+//! \brief          Keyboard zones handler object
+//! \details        Keyboard zones handler object
+//!
+extern KeyboardZones keyboardZones;
+
+// =============================================================================
+// Include guard (END)
+// =============================================================================
+
+#endif  // __KEYBOARD_ZONES_HPP
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
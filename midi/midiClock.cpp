@@ -0,0 +1,404 @@
+//!
+//! \file           midiClock.cpp
+//! \brief          MIDI Beat Clock generator
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        MIDI Beat Clock generator
+//!
+
+// =============================================================================
+// System file dependencies
+// =============================================================================
+
+#include "midiClock.hpp"
+#if !defined(__MIDI_CLOCK_HPP)
+#    error "Header file is corrupted!"
+#elif __MIDI_CLOCK_HPP != 2304
+#    error "Version mismatch between source and header files!"
+#endif
+
+// =============================================================================
+// File exclusive - Constants
+// =============================================================================
+
+#define DEBUG_MIDI_CLOCK                0x1FFF
+
+// Timer counts per clock pulse times the tempo in hundredths of BPM:
+// (F_CPU / 64) * 60 s * 100 / MIDI_CLOCK_PPQN
+cuint32_t constPeriodNumerator          = (F_CPU / 64UL) * 6000UL / MIDI_CLOCK_PPQN;
+cuint8_t constMidiClock                 = 0xF8;     //!< Timing Clock message
+cuint8_t constMidiStart                 = 0xFA;     //!< Start message
+cuint8_t constMidiContinue              = 0xFB;     //!< Continue message
+cuint8_t constMidiStop                  = 0xFC;     //!< Stop message
+
+// =============================================================================
+// File exclusive - New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// File exclusive - Global variables
+// =============================================================================
+
+MidiClock midiClock;
+
+// =============================================================================
+// File exclusive - Macro-functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Class constructors
+// =============================================================================
+
+MidiClock::MidiClock(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiClock::MidiClock(void)", DEBUG_MIDI_CLOCK);
+
+    // Reset data members
+    this->_tempo                        = 0;
+    this->_periodCounts                 = 0;
+    this->_periodRemainder              = 0;
+    this->_accumulator                  = 0;
+    this->_position                     = 0;
+    this->_isInitialized                = false;
+    this->_isPlaying                    = false;
+    this->_minLatency                   = 0xFFFF;
+    this->_maxLatency                   = 0;
+    this->_droppedCount                 = 0;
+
+    // Returns successfully
+    this->_lastError                    = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MIDI_CLOCK);
+    return;
+}
+
+MidiClock::~MidiClock(void)
+{
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_MIDI_CLOCK);
+    return;
+}
+
+// =============================================================================
+// Class public methods
+// =============================================================================
+
+//     ///////////////////     CONFIGURATION     ////////////////////     //
+bool_t MidiClock::init(cuint16_t tempo_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiClock::init(cuint16_t)", DEBUG_MIDI_CLOCK);
+
+    // Stop generating the clock
+    timer1.deactivateCompareAInterrupt();
+    this->_isInitialized                = false;
+    this->_isPlaying                    = false;
+    this->_position                     = 0;
+
+    // Configure the period
+    if(!this->setTempo(tempo_p)) {
+        // Returns error
+        debugMessage(this->_lastError, DEBUG_MIDI_CLOCK);
+        return false;
+    }
+    this->_accumulator                  = 0;
+    timer1.setCounterValue(0);
+    timer1.setCompareAValue(this->_periodCounts - 1);
+
+    // Configure timer
+    if(!timer1.init(Timer1::Mode::CTC_OCRA, Timer1::ClockSource::PRESCALER_64)) {
+        // Returns error
+        this->_lastError = timer1.getLastError();
+        debugMessage(this->_lastError, DEBUG_MIDI_CLOCK);
+        return false;
+    }
+    this->clearCounters();
+    this->_isInitialized                = true;
+    timer1.clearCompareAInterruptRequest();
+    timer1.activateCompareAInterrupt();
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MIDI_CLOCK);
+    return true;
+}
+
+bool_t MidiClock::setTempo(cuint16_t tempo_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiClock::setTempo(cuint16_t)", DEBUG_MIDI_CLOCK);
+
+    // Checks for errors
+    if((tempo_p < MIDI_CLOCK_MIN_TEMPO) || (tempo_p > MIDI_CLOCK_MAX_TEMPO)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+        debugMessage(Error::ARGUMENT_VALUE_INVALID, DEBUG_MIDI_CLOCK);
+        return false;
+    }
+
+    // Split the period in integer and fractional counts
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        this->_tempo                    = tempo_p;
+        this->_periodCounts             = (uint16_t)(constPeriodNumerator / tempo_p);
+        this->_periodRemainder          = (uint16_t)(constPeriodNumerator % tempo_p);
+        if(this->_accumulator >= tempo_p) {
+            this->_accumulator          = 0;
+        }
+    }
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MIDI_CLOCK);
+    return true;
+}
+
+uint16_t MidiClock::getTempo(void)
+{
+    // Returns value
+    return this->_tempo;
+}
+
+//     //////////////////////     TRANSPORT     ///////////////////////     //
+bool_t MidiClock::start(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiClock::start(void)", DEBUG_MIDI_CLOCK);
+
+    // Send message
+    return this->_sendTransport(constMidiStart, true);
+}
+
+bool_t MidiClock::stop(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiClock::stop(void)", DEBUG_MIDI_CLOCK);
+
+    // Send message
+    return this->_sendTransport(constMidiStop, false);
+}
+
+bool_t MidiClock::resume(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiClock::resume(void)", DEBUG_MIDI_CLOCK);
+
+    // Send message
+    return this->_sendTransport(constMidiContinue, false);
+}
+
+//     /////////////////     CONTROL AND STATUS     /////////////////     //
+uint32_t MidiClock::getPosition(void)
+{
+    // Local variables
+    uint32_t aux32;
+
+    // Read atomically
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        aux32 = this->_position;
+    }
+
+    // Returns value
+    return aux32;
+}
+
+uint16_t MidiClock::getJitter(void)
+{
+    // Local variables
+    uint16_t minLatency;
+    uint16_t maxLatency;
+
+    // Read atomically
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        minLatency = this->_minLatency;
+        maxLatency = this->_maxLatency;
+    }
+
+    // Returns value
+    if(minLatency > maxLatency) {
+        return 0;
+    }
+    return (uint16_t)((uint32_t)(maxLatency - minLatency) * 64 / (F_CPU / 1000000UL));
+}
+
+uint16_t MidiClock::getMaxLatency(void)
+{
+    // Local variables
+    uint16_t maxLatency;
+
+    // Read atomically
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        maxLatency = this->_maxLatency;
+    }
+
+    // Returns value
+    return (uint16_t)((uint32_t)maxLatency * 64 / (F_CPU / 1000000UL));
+}
+
+uint16_t MidiClock::getDroppedCount(void)
+{
+    // Local variables
+    uint16_t aux16;
+
+    // Read atomically
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        aux16 = this->_droppedCount;
+    }
+
+    // Returns value
+    return aux16;
+}
+
+void MidiClock::clearCounters(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiClock::clearCounters(void)", DEBUG_MIDI_CLOCK);
+
+    // Reset data members
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        this->_minLatency               = 0xFFFF;
+        this->_maxLatency               = 0;
+        this->_droppedCount             = 0;
+    }
+
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_MIDI_CLOCK);
+    return;
+}
+
+Error MidiClock::getLastError(void)
+{
+    // Returns last error
+    return this->_lastError;
+}
+
+//     /////////////////////     INTERRUPTS    //////////////////////     //
+void MidiClock::timerMatchHandler(void)
+{
+    // Schedule the next period, adding one count each time the fractional
+    // part overflows (the period is OCR1A + 1 counts)
+    this->_accumulator += this->_periodRemainder;
+    if(this->_accumulator >= this->_tempo) {
+        this->_accumulator -= this->_tempo;
+        OCR1A = this->_periodCounts;
+    } else {
+        OCR1A = this->_periodCounts - 1;
+    }
+
+    // Send clock pulse
+    if(!midiOutput.pushRealtime(constMidiClock)) {
+        if(this->_droppedCount != 0xFFFF) {
+            this->_droppedCount++;
+        }
+        return;
+    }
+    if(this->_isPlaying) {
+        this->_position++;
+    }
+
+    return;
+}
+
+void MidiClock::clockSentHandler(void)
+{
+    // Local variables
+    uint16_t latency;
+
+    // Counts since the last timer match
+    if(!this->_isInitialized) {
+        return;
+    }
+    latency = TCNT1;
+
+    // Update measurement
+    if(latency < this->_minLatency) {
+        this->_minLatency = latency;
+    }
+    if(latency > this->_maxLatency) {
+        this->_maxLatency = latency;
+    }
+
+    return;
+}
+
+// =============================================================================
+// Class private methods
+// =============================================================================
+
+//     ///////////////////     CONFIGURATION     ////////////////////     //
+bool_t MidiClock::_sendTransport(cuint8_t message_p, cbool_t restart_p)
+{
+    // Local variables
+    bool_t queued = false;
+
+    // Checks for errors
+    if(!this->_isInitialized) {
+        // Returns error
+        this->_lastError = Error::NOT_INITIALIZED;
+        debugMessage(Error::NOT_INITIALIZED, DEBUG_MIDI_CLOCK);
+        return false;
+    }
+
+    // Send message and update the transport state at once
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        queued = midiOutput.pushRealtime(message_p);
+        if(queued) {
+            if(restart_p) {
+                // Next clock pulse comes one full period later
+                TCNT1 = 0;
+                this->_accumulator = 0;
+                OCR1A = this->_periodCounts - 1;
+                timer1.clearCompareAInterruptRequest();
+                this->_position = 0;
+            }
+            this->_isPlaying = (message_p != constMidiStop);
+        }
+    }
+    if(!queued) {
+        // Returns error
+        this->_lastError = Error::BUFFER_NOT_ENOUGH_SPACE;
+        debugMessage(Error::BUFFER_NOT_ENOUGH_SPACE, DEBUG_MIDI_CLOCK);
+        return false;
+    }
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MIDI_CLOCK);
+    return true;
+}
+
+// =============================================================================
+// Class protected methods
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// General public functions definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+void timer1CompareACallback(void)
+{
+    midiClock.timerMatchHandler();
+}
+
+void midiOutputRealtimeSentCallback(uint8_t message_p)
+{
+    if(message_p == constMidiClock) {
+        midiClock.clockSentHandler();
+    }
+}
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
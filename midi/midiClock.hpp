@@ -0,0 +1,350 @@
+//!
+//! \file           midiClock.hpp
+//! \brief          MIDI Beat Clock generator
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Generates the MIDI Beat Clock (0xF8, 24 pulses per quarter
+//!                     note) from the TIMER1 compare A interrupt, in CTC mode.
+//!                     The tempo is given in hundredths of BPM; the clock
+//!                     period is split in an integer number of timer counts
+//!                     and a remainder, which is accumulated and added as an
+//!                     extra count whenever it overflows, so the long-term
+//!                     tempo has no drift at any BPM. The clock keeps running
+//!                     while the transport is stopped, so the slaves stay
+//!                     locked to the tempo.
+//!
+//!                     The jitter is measured as the spread of the delay
+//!                     between each timer match and the moment the clock
+//!                     byte is handed to the USART. The transmission of the
+//!                     byte in the shift register, if any, may add up to one
+//!                     byte time (320 us) more.
+//!
+
+// =============================================================================
+// Include guard (START)
+// =============================================================================
+
+#ifndef __MIDI_CLOCK_HPP
+#define __MIDI_CLOCK_HPP                        2304
+
+// =============================================================================
+// Dependencies
+// =============================================================================
+
+//     /////////////////     GLOBAL DEFINITIONS FILE    /////////////////     //
+#include "../funsape/globalDefines.hpp"
+#if !defined(__GLOBAL_DEFINES_HPP)
+#   error "Global definitions file is corrupted!"
+#elif __GLOBAL_DEFINES_HPP != __MIDI_CLOCK_HPP
+#   error "Version mismatch between file header and global definitions file!"
+#endif
+
+//     //////////////////     LIBRARY DEPENDENCIES     //////////////////     //
+#include "../funsape/peripheral/timer1.hpp"
+#if !defined(__TIMER1_HPP)
+#   error "Header file (timer1.hpp) is corrupted!"
+#elif __TIMER1_HPP != __MIDI_CLOCK_HPP
+#   error "Version mismatch between header file and library dependency (timer1.hpp)!"
+#endif
+
+#include "midiOutput.hpp"
+#if !defined(__MIDI_OUTPUT_HPP)
+#   error "Header file (midiOutput.hpp) is corrupted!"
+#elif __MIDI_OUTPUT_HPP != __MIDI_CLOCK_HPP
+#   error "Version mismatch between header file and library dependency (midiOutput.hpp)!"
+#endif
+
+// =============================================================================
+// Undefining previous definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Constant definitions
+// =============================================================================
+
+//!
+//! \brief          Number of clock pulses per quarter note
+//!
+#define MIDI_CLOCK_PPQN                 24
+
+//!
+//! \brief          Slowest tempo, in hundredths of BPM
+//!
+#define MIDI_CLOCK_MIN_TEMPO            1000
+
+//!
+//! \brief          Fastest tempo, in hundredths of BPM
+//!
+#define MIDI_CLOCK_MAX_TEMPO            30000
+
+// =============================================================================
+// New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// MidiClock Class
+// =============================================================================
+
+//!
+//! \brief          MidiClock class
+//! \details        Uses TIMER1 exclusively. The MIDI output must be
+//!                     initialized beforehand.
+//!
+class MidiClock
+{
+    // -------------------------------------------------------------------------
+    // New data types ----------------------------------------------------------
+public:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Constructors ------------------------------------------------------------
+public:
+    //!
+    //! \brief      MidiClock class constructor
+    //! \details    Creates a MidiClock object
+    //!
+    MidiClock(
+            void
+    );
+
+    //!
+    //! \brief      MidiClock class destructor
+    //! \details    Destroys a MidiClock object
+    //!
+    ~MidiClock(
+            void
+    );
+
+    // -------------------------------------------------------------------------
+    // Methods -----------------------------------------------------------------
+public:
+    //     ///////////////////     CONFIGURATION     ////////////////////     //
+
+    //!
+    //! \brief      Initializes the clock generator
+    //! \details    Configures TIMER1 and starts sending the clock. The
+    //!                 transport starts stopped.
+    //! \param      tempo_p             Tempo, in hundredths of BPM
+    //!                                     (MIDI_CLOCK_MIN_TEMPO to
+    //!                                     MIDI_CLOCK_MAX_TEMPO)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t init(
+            cuint16_t tempo_p
+    );
+
+    //!
+    //! \brief      Changes the tempo
+    //! \details    Changes the tempo. The new tempo is used from the next
+    //!                 clock pulse on.
+    //! \param      tempo_p             Tempo, in hundredths of BPM
+    //!                                     (MIDI_CLOCK_MIN_TEMPO to
+    //!                                     MIDI_CLOCK_MAX_TEMPO)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t setTempo(
+            cuint16_t tempo_p
+    );
+
+    //!
+    //! \brief      Returns the tempo
+    //! \details    Returns the tempo.
+    //! \return     uint16_t            Tempo, in hundredths of BPM
+    //!
+    uint16_t getTempo(
+            void
+    );
+
+    //     //////////////////////     TRANSPORT     ///////////////////////     //
+
+    //!
+    //! \brief      Starts the song from the beginning
+    //! \details    Sends a Start message and restarts the clock phase, so the
+    //!                 first clock pulse, which marks the first beat, comes
+    //!                 exactly one period later.
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t start(
+            void
+    );
+
+    //!
+    //! \brief      Stops the song
+    //! \details    Sends a Stop message. The clock keeps running.
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t stop(
+            void
+    );
+
+    //!
+    //! \brief      Continues the song
+    //! \details    Sends a Continue message. The song resumes from the
+    //!                 position where it was stopped.
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t resume(
+            void
+    );
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+
+    //!
+    //! \brief      Checks if the song is playing
+    //! \details    Checks if the song is playing.
+    //! \return     bool_t              True if playing / False otherwise
+    //!
+    bool_t inlined isPlaying(
+            void
+    );
+
+    //!
+    //! \brief      Returns the song position
+    //! \details    Returns the number of clock pulses sent while the song was
+    //!                 playing since the last Start message.
+    //! \return     uint32_t            Song position, in clock pulses
+    //!
+    uint32_t getPosition(
+            void
+    );
+
+    //!
+    //! \brief      Returns the measured jitter
+    //! \details    Returns the difference between the largest and the
+    //!                 smallest delay between a timer match and the clock
+    //!                 byte being handed to the USART.
+    //! \return     uint16_t            Jitter, in microseconds
+    //!
+    uint16_t getJitter(
+            void
+    );
+
+    //!
+    //! \brief      Returns the largest measured latency
+    //! \details    Returns the largest delay between a timer match and the
+    //!                 clock byte being handed to the USART.
+    //! \return     uint16_t            Latency, in microseconds
+    //!
+    uint16_t getMaxLatency(
+            void
+    );
+
+    //!
+    //! \brief      Returns the number of dropped clock pulses
+    //! \details    Returns the number of clock pulses that could not be
+    //!                 enqueued. The counter saturates at 0xFFFF.
+    //! \return     uint16_t            Dropped clock pulses
+    //!
+    uint16_t getDroppedCount(
+            void
+    );
+
+    //!
+    //! \brief      Clears the counters
+    //! \details    Clears the jitter measurement and the dropped clock pulses
+    //!                 counter.
+    //!
+    void clearCounters(
+            void
+    );
+
+    //!
+    //! \brief      Returns the last error
+    //! \details    Returns the last error.
+    //! \return     Error               Error status of the last operation
+    //!
+    Error getLastError(
+            void
+    );
+
+    //     /////////////////////     INTERRUPTS    //////////////////////     //
+
+    //!
+    //! \brief      Timer match handler
+    //! \details    Schedules the next clock period and enqueues a clock
+    //!                 pulse. Called from the TIMER1 compare A interrupt.
+    //!
+    void timerMatchHandler(
+            void
+    );
+
+    //!
+    //! \brief      Clock pulse sent handler
+    //! \details    Measures the latency of the clock pulse. Called from the
+    //!                 USART Data Register Empty interrupt.
+    //!
+    void clockSentHandler(
+            void
+    );
+
+private:
+    //     ///////////////////     CONFIGURATION     ////////////////////     //
+    bool_t _sendTransport(
+            cuint8_t message_p,
+            cbool_t restart_p
+    );
+
+protected:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Properties --------------------------------------------------------------
+private:
+    //     //////////////////////     PERIOD     ////////////////////////     //
+    uint16_t            _tempo;
+    uint16_t            _periodCounts;
+    uint16_t            _periodRemainder;
+    uint16_t            _accumulator;   // Used only by the interrupt
+
+    //     //////////////////////     TRANSPORT     ///////////////////////     //
+    vuint32_t           _position;
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+    bool_t              _isInitialized                  : 1;
+    vbool_t             _isPlaying;
+    vuint16_t           _minLatency;
+    vuint16_t           _maxLatency;
+    vuint16_t           _droppedCount;
+    Error               _lastError;
+}; // class MidiClock
+
+// =============================================================================
+// MidiClock - Class inline function definitions
+// =============================================================================
+
+bool_t inlined MidiClock::isPlaying(void)
+{
+    return this->_isPlaying;
+}
+
+// =============================================================================
+// External global variables
+// =============================================================================
+
+//!
+//! \brief          MIDI clock generator handler object
+//! \details        MIDI clock generator handler object
+//!
+extern MidiClock midiClock;
+
+// =============================================================================
+// Include guard (END)
+// =============================================================================
+
+#endif  // __MIDI_CLOCK_HPP
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
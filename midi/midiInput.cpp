@@ -0,0 +1,376 @@
+//!
+//! \file           midiInput.cpp
+//! \brief          Interrupt-driven MIDI input parser
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Interrupt-driven MIDI input parser
+//!
+
+// =============================================================================
+// System file dependencies
+// =============================================================================
+
+#include "midiInput.hpp"
+#if !defined(__MIDI_INPUT_HPP)
+#    error "Header file is corrupted!"
+#elif __MIDI_INPUT_HPP != 2304
+#    error "Version mismatch between source and header files!"
+#endif
+
+// =============================================================================
+// File exclusive - Constants
+// =============================================================================
+
+#define DEBUG_MIDI_INPUT                0x1FFF
+
+static_assert((MIDI_INPUT_QUEUE_SIZE & (MIDI_INPUT_QUEUE_SIZE - 1)) == 0,
+        "MIDI_INPUT_QUEUE_SIZE must be a power of two!");
+static_assert((MIDI_INPUT_QUEUE_SIZE >= 2) && (MIDI_INPUT_QUEUE_SIZE <= 128),
+        "MIDI_INPUT_QUEUE_SIZE must be between 2 and 128!");
+
+cuint8_t constQueueMask                 = (MIDI_INPUT_QUEUE_SIZE - 1);  //!< Queue index mask
+
+// =============================================================================
+// File exclusive - New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// File exclusive - Global variables
+// =============================================================================
+
+MidiInput midiInput;
+
+// =============================================================================
+// File exclusive - Macro-functions
+// =============================================================================
+
+#define saturatedIncrement(counter)     do{if((counter) != 0xFFFF){(counter)++;}}while(0)
+
+// =============================================================================
+// Class constructors
+// =============================================================================
+
+MidiInput::MidiInput(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiInput::MidiInput(void)", DEBUG_MIDI_INPUT);
+
+    // Reset data members
+    this->_head                         = 0;
+    this->_tail                         = 0;
+    this->_messageIndex                 = 0;
+    this->_messageSize                  = 0;
+    this->_inSysEx                      = false;
+    this->_droppedEvents                = 0;
+    this->_receptionErrors              = 0;
+    this->_strayBytes                   = 0;
+    this->_isInitialized                = false;
+
+    // Returns successfully
+    this->_lastError                    = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MIDI_INPUT);
+    return;
+}
+
+MidiInput::~MidiInput(void)
+{
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_MIDI_INPUT);
+    return;
+}
+
+// =============================================================================
+// Class public methods
+// =============================================================================
+
+//     ///////////////////     CONFIGURATION     ////////////////////     //
+bool_t MidiInput::init(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiInput::init(void)", DEBUG_MIDI_INPUT);
+
+    // Stop the producer before touching the indexes
+    usart0.deactivateReceptionCompleteInterrupt();
+
+    // Reset data members
+    this->_head                         = 0;
+    this->_tail                         = 0;
+    this->_messageIndex                 = 0;
+    this->_messageSize                  = 0;
+    this->_inSysEx                      = false;
+    this->_droppedEvents                = 0;
+    this->_receptionErrors              = 0;
+    this->_strayBytes                   = 0;
+
+    // Enable receiver
+    usart0.enableReceiver();
+    usart0.activateReceptionCompleteInterrupt();
+    this->_isInitialized                = true;
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MIDI_INPUT);
+    return true;
+}
+
+//     ////////////////////    DATA TRANSFER     ////////////////////     //
+bool_t MidiInput::readEvent(MidiEvent *event_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiInput::readEvent(MidiEvent *)", DEBUG_MIDI_INPUT);
+
+    // Local variables
+    uint8_t auxTail = this->_tail;
+
+    // Checks for errors
+    if(!isPointerValid(event_p)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_POINTER_NULL;
+        debugMessage(Error::ARGUMENT_POINTER_NULL, DEBUG_MIDI_INPUT);
+        return false;
+    }
+    if(auxTail == this->_head) {
+        // Returns error
+        this->_lastError = Error::BUFFER_EMPTY;
+        debugMessage(Error::BUFFER_EMPTY, DEBUG_MIDI_INPUT);
+        return false;
+    }
+
+    // Copy event, releasing the slot only afterwards
+    *event_p = this->_queue[auxTail];
+    this->_tail = (auxTail + 1) & constQueueMask;
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MIDI_INPUT);
+    return true;
+}
+
+//     /////////////////     CONTROL AND STATUS     /////////////////     //
+uint16_t MidiInput::getDroppedEvents(void)
+{
+    // Local variables
+    uint16_t aux16;
+
+    // Counter is updated by the interrupt
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        aux16 = this->_droppedEvents;
+    }
+
+    // Returns value
+    return aux16;
+}
+
+uint16_t MidiInput::getReceptionErrors(void)
+{
+    // Local variables
+    uint16_t aux16;
+
+    // Counter is updated by the interrupt
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        aux16 = this->_receptionErrors;
+    }
+
+    // Returns value
+    return aux16;
+}
+
+uint16_t MidiInput::getStrayBytes(void)
+{
+    // Local variables
+    uint16_t aux16;
+
+    // Counter is updated by the interrupt
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        aux16 = this->_strayBytes;
+    }
+
+    // Returns value
+    return aux16;
+}
+
+void MidiInput::clearCounters(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiInput::clearCounters(void)", DEBUG_MIDI_INPUT);
+
+    // Reset data members
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        this->_droppedEvents            = 0;
+        this->_receptionErrors          = 0;
+        this->_strayBytes               = 0;
+    }
+
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_MIDI_INPUT);
+    return;
+}
+
+Error MidiInput::getLastError(void)
+{
+    // Returns last error
+    return this->_lastError;
+}
+
+//     /////////////////////     INTERRUPTS    //////////////////////     //
+void MidiInput::receptionCompleteHandler(void)
+{
+    // Local variables - status must be read before the data register
+    uint8_t status = UCSR0A;
+    uint8_t data = UDR0;
+
+    // Checks for reception errors
+    if(status & ((1 << FE0) | (1 << DOR0))) {
+        saturatedIncrement(this->_receptionErrors);
+        if(isBitSet(status, FE0)) {
+            // Byte is corrupted
+            return;
+        }
+    }
+
+    this->_parseByte(data);
+
+    return;
+}
+
+// =============================================================================
+// Class private methods
+// =============================================================================
+
+//     //////////////////////     PARSING     ///////////////////////     //
+void MidiInput::_pushEvent(cuint8_t *data_p, cuint8_t size_p, cbool_t isSysEx_p)
+{
+    // Local variables
+    uint8_t auxHead = this->_head;
+    uint8_t nextHead = (auxHead + 1) & constQueueMask;
+
+    // Checks for free space
+    if(nextHead == this->_tail) {
+        saturatedIncrement(this->_droppedEvents);
+        return;
+    }
+
+    // Store event, publishing it only afterwards
+    this->_queue[auxHead].data[0] = data_p[0];
+    this->_queue[auxHead].data[1] = data_p[1];
+    this->_queue[auxHead].data[2] = data_p[2];
+    this->_queue[auxHead].size = size_p;
+    this->_queue[auxHead].isSysEx = isSysEx_p;
+    this->_head = nextHead;
+
+    return;
+}
+
+void MidiInput::_parseByte(cuint8_t byte_p)
+{
+    // Local variables
+    uint8_t realTime[3] = {byte_p, 0, 0};
+
+    // System Real-Time - may appear anywhere and changes nothing
+    if(byte_p >= 0xF8) {
+        this->_pushEvent(realTime, 1, false);
+        return;
+    }
+
+    // Data bytes
+    if(byte_p < 0x80) {
+        if(this->_inSysEx) {
+            this->_message[this->_messageIndex++] = byte_p;
+            if(this->_messageIndex == 3) {
+                this->_pushEvent(this->_message, 3, true);
+                this->_messageIndex = 0;
+            }
+        } else if(this->_messageSize == 0) {
+            saturatedIncrement(this->_strayBytes);
+        } else {
+            this->_message[this->_messageIndex++] = byte_p;
+            if(this->_messageIndex == this->_messageSize) {
+                this->_pushEvent(this->_message, this->_messageSize, false);
+                if(this->_message[0] < 0xF0) {
+                    // Running status - keep the status byte
+                    this->_messageIndex = 1;
+                } else {
+                    this->_messageSize = 0;
+                }
+            }
+        }
+        return;
+    }
+
+    // Any other status byte ends a System Exclusive message
+    if(this->_inSysEx) {
+        this->_inSysEx = false;
+        if(byte_p == 0xF7) {
+            this->_message[this->_messageIndex++] = byte_p;
+            this->_pushEvent(this->_message, this->_messageIndex, true);
+            this->_messageSize = 0;
+            return;
+        }
+        if(this->_messageIndex > 0) {
+            this->_pushEvent(this->_message, this->_messageIndex, true);
+        }
+    }
+
+    // Status bytes
+    this->_message[0] = byte_p;
+    this->_messageIndex = 1;
+    if(byte_p < 0xF0) {
+        // Channel message - Program Change and Channel Pressure have one data byte
+        this->_messageSize = ((byte_p & 0xE0) == 0xC0) ? 2 : 3;
+        return;
+    }
+    switch(byte_p) {
+    case 0xF0:          // System Exclusive start
+        this->_inSysEx = true;
+        this->_messageSize = 0;
+        break;
+    case 0xF1:          // MIDI Time Code Quarter Frame
+    case 0xF3:          // Song Select
+        this->_messageSize = 2;
+        break;
+    case 0xF2:          // Song Position Pointer
+        this->_messageSize = 3;
+        break;
+    case 0xF6:          // Tune Request
+        this->_pushEvent(this->_message, 1, false);
+        this->_messageSize = 0;
+        break;
+    case 0xF7:          // Stray End of Exclusive
+        saturatedIncrement(this->_strayBytes);
+        this->_messageSize = 0;
+        break;
+    default:            // Undefined
+        this->_messageSize = 0;
+        break;
+    }
+
+    return;
+}
+
+// =============================================================================
+// Class protected methods
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// General public functions definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+void usartReceptionCompleteCallback(void)
+{
+    midiInput.receptionCompleteHandler();
+}
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
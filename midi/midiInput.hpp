@@ -0,0 +1,286 @@
+//!
+//! \file           midiInput.hpp
+//! \brief          Interrupt-driven MIDI input parser
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        MIDI input parser fed by the USART0 Reception Complete
+//!                     interrupt. Each received byte goes through a small
+//!                     state machine with constant cost, and the decoded
+//!                     messages are stored in a bounded event queue read by
+//!                     the main loop.
+//!
+
+// =============================================================================
+// Include guard (START)
+// =============================================================================
+
+#ifndef __MIDI_INPUT_HPP
+#define __MIDI_INPUT_HPP                        2304
+
+// =============================================================================
+// Dependencies
+// =============================================================================
+
+//     /////////////////     GLOBAL DEFINITIONS FILE    /////////////////     //
+#include "../funsape/globalDefines.hpp"
+#if !defined(__GLOBAL_DEFINES_HPP)
+#   error "Global definitions file is corrupted!"
+#elif __GLOBAL_DEFINES_HPP != __MIDI_INPUT_HPP
+#   error "Version mismatch between file header and global definitions file!"
+#endif
+
+//     //////////////////     LIBRARY DEPENDENCIES     //////////////////     //
+#include "../funsape/peripheral/usart0.hpp"
+#if !defined(__USART0_HPP)
+#   error "Header file (usart0.hpp) is corrupted!"
+#elif __USART0_HPP != __MIDI_INPUT_HPP
+#   error "Version mismatch between header file and library dependency (usart0.hpp)!"
+#endif
+
+// =============================================================================
+// Undefining previous definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Constant definitions
+// =============================================================================
+
+#ifndef MIDI_INPUT_QUEUE_SIZE
+//!
+//! \brief          Number of events of the reception queue
+//! \details        Must be a power of two no larger than 128.
+//!
+#   define MIDI_INPUT_QUEUE_SIZE        16
+#endif
+
+// =============================================================================
+// New data types
+// =============================================================================
+
+//!
+//! \brief          Received MIDI event
+//! \details        Holds a complete channel, System Common or System Real-Time
+//!                     message, always with its status byte. System Exclusive
+//!                     messages are delivered as a stream of chunks of up to
+//!                     three bytes flagged with isSysEx; the first chunk
+//!                     starts with 0xF0 and the last one ends with 0xF7,
+//!                     unless the message was interrupted by another status
+//!                     byte. Real-Time messages received in the middle of a
+//!                     System Exclusive message are delivered between its
+//!                     chunks.
+//!
+typedef struct {
+    uint8_t     data[3];                //!< Message bytes
+    uint8_t     size            : 2;    //!< Number of valid bytes in data
+    bool_t      isSysEx         : 1;    //!< System Exclusive chunk
+} MidiEvent;
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// MidiInput Class
+// =============================================================================
+
+//!
+//! \brief          MidiInput class
+//! \details        Decodes the MIDI stream received by USART0. The interrupt
+//!                     is the only producer and the main loop the only
+//!                     consumer of the event queue.
+//!
+class MidiInput
+{
+    // -------------------------------------------------------------------------
+    // New data types ----------------------------------------------------------
+public:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Constructors ------------------------------------------------------------
+public:
+    //!
+    //! \brief      MidiInput class constructor
+    //! \details    Creates a MidiInput object
+    //!
+    MidiInput(
+            void
+    );
+
+    //!
+    //! \brief      MidiInput class destructor
+    //! \details    Destroys a MidiInput object
+    //!
+    ~MidiInput(
+            void
+    );
+
+    // -------------------------------------------------------------------------
+    // Methods -----------------------------------------------------------------
+public:
+    //     ///////////////////     CONFIGURATION     ////////////////////     //
+
+    //!
+    //! \brief      Initializes the MIDI input parser
+    //! \details    Resets the parser and the counters, and enables the USART0
+    //!                 receiver and its Reception Complete interrupt. The
+    //!                 USART0 frame format and baud rate must be configured
+    //!                 beforehand.
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t init(
+            void
+    );
+
+    //     ////////////////////    DATA TRANSFER     ////////////////////     //
+
+    //!
+    //! \brief      Reads the oldest event of the queue
+    //! \details    Reads the oldest event of the queue.
+    //! \param      event_p             Pointer to store the event
+    //! \return     bool_t              True if an event was read / False if
+    //!                                     the queue is empty
+    //!
+    bool_t readEvent(
+            MidiEvent *event_p
+    );
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+
+    //!
+    //! \brief      Returns the number of events in the queue
+    //! \details    Returns the number of events in the queue.
+    //! \return     uint8_t             Number of queued events
+    //!
+    uint8_t inlined getEventCount(
+            void
+    );
+
+    //!
+    //! \brief      Returns the number of events lost because the queue was full
+    //! \details    Returns the number of events lost because the queue was
+    //!                 full. The counter saturates at 0xFFFF.
+    //! \return     uint16_t            Lost events
+    //!
+    uint16_t getDroppedEvents(
+            void
+    );
+
+    //!
+    //! \brief      Returns the number of reception errors
+    //! \details    Returns the number of bytes received with frame error or
+    //!                 lost by data overrun. The counter saturates at 0xFFFF.
+    //! \return     uint16_t            Reception errors
+    //!
+    uint16_t getReceptionErrors(
+            void
+    );
+
+    //!
+    //! \brief      Returns the number of ignored data bytes
+    //! \details    Returns the number of data bytes received without a valid
+    //!                 status byte. The counter saturates at 0xFFFF.
+    //! \return     uint16_t            Ignored bytes
+    //!
+    uint16_t getStrayBytes(
+            void
+    );
+
+    //!
+    //! \brief      Clears the error counters
+    //! \details    Clears the error counters.
+    //!
+    void clearCounters(
+            void
+    );
+
+    //!
+    //! \brief      Returns the last error
+    //! \details    Returns the last error.
+    //! \return     Error               Error status of the last operation
+    //!
+    Error getLastError(
+            void
+    );
+
+    //     /////////////////////     INTERRUPTS    //////////////////////     //
+
+    //!
+    //! \brief      Reception Complete interrupt handler
+    //! \details    Reads UDR0 and feeds the byte to the parser. Must be called
+    //!                 only from USART_RX_vect.
+    //!
+    void receptionCompleteHandler(
+            void
+    );
+
+private:
+    //     //////////////////////     PARSING     ///////////////////////     //
+    void _pushEvent(
+            cuint8_t *data_p,
+            cuint8_t size_p,
+            cbool_t isSysEx_p
+    );
+
+    void _parseByte(
+            cuint8_t byte_p
+    );
+
+protected:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Properties --------------------------------------------------------------
+private:
+    //     ////////////////////    DATA BUFFERS      ////////////////////     //
+    MidiEvent           _queue[MIDI_INPUT_QUEUE_SIZE];
+    vuint8_t            _head;          // Written only by the interrupt
+    vuint8_t            _tail;          // Written only by the main loop
+
+    //     //////////////////////     PARSING     ///////////////////////     //
+    uint8_t             _message[3];
+    uint8_t             _messageIndex;
+    uint8_t             _messageSize;
+    bool_t              _inSysEx                        : 1;
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+    bool_t              _isInitialized                  : 1;
+    uint16_t            _droppedEvents;
+    uint16_t            _receptionErrors;
+    uint16_t            _strayBytes;
+    Error               _lastError;
+}; // class MidiInput
+
+// =============================================================================
+// MidiInput - Class inline function definitions
+// =============================================================================
+
+uint8_t inlined MidiInput::getEventCount(void)
+{
+    return (uint8_t)((this->_head - this->_tail) & (MIDI_INPUT_QUEUE_SIZE - 1));
+}
+
+// =============================================================================
+// External global variables
+// =============================================================================
+
+//!
+//! \brief          MIDI input parser handler object
+//! \details        MIDI input parser handler object
+//!
+extern MidiInput midiInput;
+
+// =============================================================================
+// Include guard (END)
+// =============================================================================
+
+#endif  // __MIDI_INPUT_HPP
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
@@ -0,0 +1,373 @@
+//!
+//! \file           midiMerge.cpp
+//! \brief          MIDI THRU / merge engine
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        MIDI THRU / merge engine
+//!
+
+// =============================================================================
+// System file dependencies
+// =============================================================================
+
+#include "midiMerge.hpp"
+#if !defined(__MIDI_MERGE_HPP)
+#    error "Header file is corrupted!"
+#elif __MIDI_MERGE_HPP != 2304
+#    error "Version mismatch between source and header files!"
+#endif
+
+// =============================================================================
+// File exclusive - Constants
+// =============================================================================
+
+#define DEBUG_MIDI_MERGE                0x1FFF
+
+cuint8_t constEndOfExclusive            = 0xF7;
+cuint8_t constAllNotesOff               = 123;
+
+// =============================================================================
+// File exclusive - New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// File exclusive - Global variables
+// =============================================================================
+
+MidiMerge midiMerge;
+
+// =============================================================================
+// File exclusive - Macro-functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Class constructors
+// =============================================================================
+
+MidiMerge::MidiMerge(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiMerge::MidiMerge(void)", DEBUG_MIDI_MERGE);
+
+    // Reset data members
+    this->_backlogFirst                 = 0;
+    this->_backlogCount                 = 0;
+    this->_backlogBytes                 = 0;
+    this->_pendingNotesOff              = 0;
+    this->_isInitialized                = false;
+    this->_inSysEx                      = false;
+    this->_sysExTime                    = 0;
+    this->_backlogPeak                  = 0;
+    this->_droppedBytes                 = 0;
+
+    // Returns successfully
+    this->_lastError                    = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MIDI_MERGE);
+    return;
+}
+
+MidiMerge::~MidiMerge(void)
+{
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_MIDI_MERGE);
+    return;
+}
+
+// =============================================================================
+// Class public methods
+// =============================================================================
+
+//     ///////////////////     CONFIGURATION     ////////////////////     //
+bool_t MidiMerge::init(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiMerge::init(void)", DEBUG_MIDI_MERGE);
+
+    // Reset data members
+    this->_backlogFirst                 = 0;
+    this->_backlogCount                 = 0;
+    this->_backlogBytes                 = 0;
+    this->_pendingNotesOff              = 0;
+    this->_inSysEx                      = false;
+    this->_sysExTime                    = 0;
+    this->_backlogPeak                  = 0;
+    this->_droppedBytes                 = 0;
+
+    // Initialize input
+    if(!midiInput.init()) {
+        // Returns error
+        this->_lastError = midiInput.getLastError();
+        debugMessage(this->_lastError, DEBUG_MIDI_MERGE);
+        return false;
+    }
+    this->_isInitialized                = true;
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MIDI_MERGE);
+    return true;
+}
+
+//     ////////////////////    DATA TRANSFER     ////////////////////     //
+bool_t MidiMerge::sendLocal(cuint8_t *message_p, cuint8_t size_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiMerge::sendLocal(cuint8_t *, cuint8_t)", DEBUG_MIDI_MERGE);
+
+    // Local variables
+    MidiEvent *slot;
+
+    // Checks for errors
+    if(!isPointerValid(message_p)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_POINTER_NULL;
+        debugMessage(Error::ARGUMENT_POINTER_NULL, DEBUG_MIDI_MERGE);
+        return false;
+    }
+    if((size_p == 0) || (size_p > 3)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+        debugMessage(Error::ARGUMENT_VALUE_INVALID, DEBUG_MIDI_MERGE);
+        return false;
+    }
+
+    // Real-Time messages may go anywhere
+    if(message_p[0] >= 0xF8) {
+        if(!midiOutput.sendRealtime(message_p[0])) {
+            this->_addDropped(1);
+            this->_lastError = midiOutput.getLastError();
+            debugMessage(this->_lastError, DEBUG_MIDI_MERGE);
+            return false;
+        }
+        this->_lastError = Error::NONE;
+        debugMessage(Error::NONE, DEBUG_MIDI_MERGE);
+        return true;
+    }
+
+    // Send directly when nothing is held back
+    if(!this->_inSysEx && (this->_backlogCount == 0)) {
+        if(!midiOutput.sendMessage(message_p, size_p, true)) {
+            this->_lastError = midiOutput.getLastError();
+            debugMessage(this->_lastError, DEBUG_MIDI_MERGE);
+            return false;
+        }
+        this->_updateBacklogPeak();
+        this->_lastError = Error::NONE;
+        debugMessage(Error::NONE, DEBUG_MIDI_MERGE);
+        return true;
+    }
+
+    // Hold message until the System Exclusive message ends
+    if(this->_backlogCount == MIDI_MERGE_BACKLOG_SIZE) {
+        // A Note Off is never lost, it becomes an All Notes Off
+        if(this->_isNoteOff(message_p, size_p)) {
+            setBit(this->_pendingNotesOff, (message_p[0] & 0x0F));
+            this->_lastError = Error::NONE;
+            debugMessage(Error::NONE, DEBUG_MIDI_MERGE);
+            return true;
+        }
+
+        // Returns error
+        this->_addDropped(size_p);
+        this->_lastError = Error::BUFFER_NOT_ENOUGH_SPACE;
+        debugMessage(Error::BUFFER_NOT_ENOUGH_SPACE, DEBUG_MIDI_MERGE);
+        return false;
+    }
+    slot = &this->_backlog[(this->_backlogFirst + this->_backlogCount) % MIDI_MERGE_BACKLOG_SIZE];
+    for(uint8_t i = 0; i < size_p; i++) {
+        slot->data[i] = message_p[i];
+    }
+    slot->size = size_p;
+    slot->isSysEx = false;
+    this->_backlogCount++;
+    this->_backlogBytes += size_p;
+    this->_updateBacklogPeak();
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MIDI_MERGE);
+    return true;
+}
+
+void MidiMerge::process(void)
+{
+    // Local variables
+    MidiEvent event;
+    MidiEvent *slot;
+    uint8_t message[3];
+
+    // Checks if initialized
+    if(!this->_isInitialized) {
+        return;
+    }
+
+    // Forward received messages
+    while(midiInput.readEvent(&event)) {
+        if(event.data[0] >= 0xF8) {
+            // Real-Time messages have priority
+            if(!midiOutput.sendRealtime(event.data[0])) {
+                this->_addDropped(1);
+            }
+            continue;
+        }
+        if(event.isSysEx) {
+            // Track System Exclusive boundaries
+            this->_inSysEx = (event.data[event.size - 1] != constEndOfExclusive);
+            this->_sysExTime = systemTick.getMilliseconds();
+        } else {
+            // Any other message ends an interrupted System Exclusive
+            this->_inSysEx = false;
+        }
+        // A System Exclusive chunk waits for room, as dropping it would leave
+        // a hole in the message passing through
+        if(!midiOutput.sendMessage(event.data, event.size, event.isSysEx)) {
+            this->_addDropped(event.size);
+            continue;
+        }
+        if(!event.isSysEx) {
+            midiMergeThruCallback(event.data, event.size);
+        }
+    }
+    this->_updateBacklogPeak();
+
+    // End a System Exclusive message that stopped arriving
+    if(this->_inSysEx &&
+                    (systemTick.getElapsedMilliseconds(this->_sysExTime) >= MIDI_MERGE_SYSEX_TIMEOUT)) {
+        midiOutput.sendMessage(&constEndOfExclusive, 1, true);
+        this->_inSysEx = false;
+    }
+    if(this->_inSysEx) {
+        return;
+    }
+
+    // Release held local messages
+    while(this->_backlogCount > 0) {
+        slot = &this->_backlog[this->_backlogFirst];
+        midiOutput.sendMessage(slot->data, slot->size, true);
+        this->_backlogBytes -= slot->size;
+        this->_backlogFirst = (this->_backlogFirst + 1) % MIDI_MERGE_BACKLOG_SIZE;
+        this->_backlogCount--;
+    }
+
+    // Release the notes whose Note Off did not fit in the backlog
+    for(uint8_t i = 0; (i < 16) && (this->_pendingNotesOff != 0); i++) {
+        if(isBitSet(this->_pendingNotesOff, i)) {
+            message[0] = 0xB0 | i;
+            message[1] = constAllNotesOff;
+            message[2] = 0;
+            midiOutput.sendMessage(message, 3, true);
+            clrBit(this->_pendingNotesOff, i);
+        }
+    }
+
+    return;
+}
+
+//     /////////////////     CONTROL AND STATUS     /////////////////     //
+uint8_t MidiMerge::getBacklog(void)
+{
+    // Returns value
+    return midiOutput.getUsedSpace() + this->_backlogBytes;
+}
+
+uint8_t MidiMerge::getBacklogPeak(void)
+{
+    // Returns value
+    return this->_backlogPeak;
+}
+
+uint16_t MidiMerge::getDroppedBytes(void)
+{
+    // Returns value
+    return this->_droppedBytes;
+}
+
+void MidiMerge::clearCounters(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiMerge::clearCounters(void)", DEBUG_MIDI_MERGE);
+
+    // Reset data members
+    this->_backlogPeak                  = 0;
+    this->_droppedBytes                 = 0;
+
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_MIDI_MERGE);
+    return;
+}
+
+Error MidiMerge::getLastError(void)
+{
+    // Returns last error
+    return this->_lastError;
+}
+
+// =============================================================================
+// Class private methods
+// =============================================================================
+
+//     /////////////////     CONTROL AND STATUS     /////////////////     //
+void MidiMerge::_addDropped(cuint8_t size_p)
+{
+    // Saturating sum
+    this->_droppedBytes = ((uint16_t)(0xFFFF - this->_droppedBytes) < size_p) ?
+            0xFFFF : (this->_droppedBytes + size_p);
+
+    return;
+}
+
+void MidiMerge::_updateBacklogPeak(void)
+{
+    // Local variables
+    uint8_t backlog = this->getBacklog();
+
+    // Update peak
+    if(backlog > this->_backlogPeak) {
+        this->_backlogPeak = backlog;
+    }
+
+    return;
+}
+
+//     ////////////////////    DATA TRANSFER     ////////////////////     //
+bool_t MidiMerge::_isNoteOff(cuint8_t *message_p, cuint8_t size_p)
+{
+    // Note Off, or Note On with zero velocity
+    if(size_p != 3) {
+        return false;
+    }
+    if((message_p[0] & 0xF0) == 0x80) {
+        return true;
+    }
+    return (((message_p[0] & 0xF0) == 0x90) && (message_p[2] == 0));
+}
+
+// =============================================================================
+// Class protected methods
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// General public functions definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+weakened void midiMergeThruCallback(cuint8_t *message_p, cuint8_t size_p)
+{
+    return;
+}
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
@@ -0,0 +1,310 @@
+//!
+//! \file           midiMerge.hpp
+//! \brief          MIDI THRU / merge engine
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Merges the messages received by the MIDI input with the
+//!                     locally generated ones onto the single MIDI output.
+//!                     Messages are always enqueued whole, so they never
+//!                     interleave on the wire; local messages generated while
+//!                     a System Exclusive message is passing through are held
+//!                     back until it ends; Real-Time messages bypass every
+//!                     queue. The status byte of every message is restored
+//!                     by the input parser, and the output running status
+//!                     encoder decides again whether to send it.
+//!
+
+// =============================================================================
+// Include guard (START)
+// =============================================================================
+
+#ifndef __MIDI_MERGE_HPP
+#define __MIDI_MERGE_HPP                        2304
+
+// =============================================================================
+// Dependencies
+// =============================================================================
+
+//     /////////////////     GLOBAL DEFINITIONS FILE    /////////////////     //
+#include "../funsape/globalDefines.hpp"
+#if !defined(__GLOBAL_DEFINES_HPP)
+#   error "Global definitions file is corrupted!"
+#elif __GLOBAL_DEFINES_HPP != __MIDI_MERGE_HPP
+#   error "Version mismatch between file header and global definitions file!"
+#endif
+
+//     //////////////////     LIBRARY DEPENDENCIES     //////////////////     //
+#include "midiInput.hpp"
+#if !defined(__MIDI_INPUT_HPP)
+#   error "Header file (midiInput.hpp) is corrupted!"
+#elif __MIDI_INPUT_HPP != __MIDI_MERGE_HPP
+#   error "Version mismatch between header file and library dependency (midiInput.hpp)!"
+#endif
+
+#include "midiOutput.hpp"
+#if !defined(__MIDI_OUTPUT_HPP)
+#   error "Header file (midiOutput.hpp) is corrupted!"
+#elif __MIDI_OUTPUT_HPP != __MIDI_MERGE_HPP
+#   error "Version mismatch between header file and library dependency (midiOutput.hpp)!"
+#endif
+
+#include "../funsape/util/systemTick.hpp"
+#if !defined(__SYSTEM_TICK_HPP)
+#   error "Header file (systemTick.hpp) is corrupted!"
+#elif __SYSTEM_TICK_HPP != __MIDI_MERGE_HPP
+#   error "Version mismatch between header file and library dependency (systemTick.hpp)!"
+#endif
+
+// =============================================================================
+// Undefining previous definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Constant definitions
+// =============================================================================
+
+#ifndef MIDI_MERGE_BACKLOG_SIZE
+//!
+//! \brief          Number of local messages held during a System Exclusive
+//!
+#   define MIDI_MERGE_BACKLOG_SIZE      8
+#endif
+
+#ifndef MIDI_MERGE_SYSEX_TIMEOUT
+//!
+//! \brief          Time without System Exclusive data that ends the message, in ms
+//!
+#   define MIDI_MERGE_SYSEX_TIMEOUT     200
+#endif
+
+// =============================================================================
+// New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+//!
+//! \brief          Forwarded message callback function
+//! \details        This function is called from MidiMerge::process() for each
+//!                     received message enqueued to the MIDI output, except
+//!                     Real-Time and System Exclusive messages. It is a weak function that can be
+//!                     overwritten by the user.
+//! \param          message_p           Pointer to the message bytes
+//! \param          size_p              Number of bytes of the message
+//!
+void midiMergeThruCallback(
+        cuint8_t *message_p,
+        cuint8_t size_p
+);
+
+// =============================================================================
+// MidiMerge Class
+// =============================================================================
+
+//!
+//! \brief          MidiMerge class
+//! \details        Every local message must be sent through sendLocal(), and
+//!                     process() must be called periodically from the main
+//!                     loop. While the merge is disabled, local messages go
+//!                     straight to the MIDI output and the input is not read.
+//!                     A System Exclusive message that receives no data for
+//!                     MIDI_MERGE_SYSEX_TIMEOUT ms is ended with an End of
+//!                     Exclusive byte, so a truncated message cannot hold the
+//!                     local messages forever. The system timebase must be
+//!                     running.
+//!
+class MidiMerge
+{
+    // -------------------------------------------------------------------------
+    // New data types ----------------------------------------------------------
+public:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Constructors ------------------------------------------------------------
+public:
+    //!
+    //! \brief      MidiMerge class constructor
+    //! \details    Creates a MidiMerge object
+    //!
+    MidiMerge(
+            void
+    );
+
+    //!
+    //! \brief      MidiMerge class destructor
+    //! \details    Destroys a MidiMerge object
+    //!
+    ~MidiMerge(
+            void
+    );
+
+    // -------------------------------------------------------------------------
+    // Methods -----------------------------------------------------------------
+public:
+    //     ///////////////////     CONFIGURATION     ////////////////////     //
+
+    //!
+    //! \brief      Initializes the merge engine
+    //! \details    Initializes the MIDI input and enables the merge. The MIDI
+    //!                 output must be initialized beforehand.
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t init(
+            void
+    );
+
+    //     ////////////////////    DATA TRANSFER     ////////////////////     //
+
+    //!
+    //! \brief      Sends a locally generated message
+    //! \details    Sends the message to the MIDI output, waiting for free
+    //!                 space if needed. While a System Exclusive message is
+    //!                 passing through, the message is held in the backlog
+    //!                 instead; if the backlog is full, the message is dropped,
+    //!                 except Note Off messages, which are replaced by an All
+    //!                 Notes Off message to their channel sent after the
+    //!                 backlog, so no note is left sounding.
+    //! \param      message_p           Pointer to the message bytes
+    //! \param      size_p              Number of bytes of the message (1 to 3)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t sendLocal(
+            cuint8_t *message_p,
+            cuint8_t size_p
+    );
+
+    //!
+    //! \brief      Forwards the received messages
+    //! \details    Forwards every received message to the MIDI output, and
+    //!                 then the held local messages and the pending All Notes
+    //!                 Off messages once no System Exclusive message is
+    //!                 passing through. System Exclusive chunks
+    //!                 wait for free space, so the message is never cut in
+    //!                 the middle; other received messages are dropped if
+    //!                 the output is full, so the input queue keeps being
+    //!                 drained.
+    //!
+    void process(
+            void
+    );
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+
+    //!
+    //! \brief      Returns the number of bytes waiting to be transmitted
+    //! \details    Returns the number of bytes in the MIDI output buffer plus
+    //!                 the bytes of the held local messages.
+    //! \return     uint8_t             Backlog, in bytes
+    //!
+    uint8_t getBacklog(
+            void
+    );
+
+    //!
+    //! \brief      Returns the largest backlog observed
+    //! \details    Returns the largest backlog observed since the last call
+    //!                 to clearCounters().
+    //! \return     uint8_t             Peak backlog, in bytes
+    //!
+    uint8_t getBacklogPeak(
+            void
+    );
+
+    //!
+    //! \brief      Returns the number of dropped bytes
+    //! \details    Returns the number of received or local bytes that could
+    //!                 not be merged. The counter saturates at 0xFFFF.
+    //! \return     uint16_t            Dropped bytes
+    //!
+    uint16_t getDroppedBytes(
+            void
+    );
+
+    //!
+    //! \brief      Clears the counters
+    //! \details    Clears the peak backlog and the dropped bytes counters.
+    //!
+    void clearCounters(
+            void
+    );
+
+    //!
+    //! \brief      Returns the last error
+    //! \details    Returns the last error.
+    //! \return     Error               Error status of the last operation
+    //!
+    Error getLastError(
+            void
+    );
+
+private:
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+    void _addDropped(
+            cuint8_t size_p
+    );
+
+    void _updateBacklogPeak(
+            void
+    );
+
+    //     ////////////////////    DATA TRANSFER     ////////////////////     //
+    bool_t _isNoteOff(
+            cuint8_t *message_p,
+            cuint8_t size_p
+    );
+
+protected:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Properties --------------------------------------------------------------
+private:
+    //     ////////////////////    DATA BUFFERS      ////////////////////     //
+    MidiEvent           _backlog[MIDI_MERGE_BACKLOG_SIZE];
+    uint8_t             _backlogFirst;
+    uint8_t             _backlogCount;
+    uint8_t             _backlogBytes;
+    uint16_t            _pendingNotesOff;       // One bit per channel
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+    bool_t              _isInitialized                  : 1;
+    bool_t              _inSysEx                        : 1;
+    uint32_t            _sysExTime;
+    uint8_t             _backlogPeak;
+    uint16_t            _droppedBytes;
+    Error               _lastError;
+}; // class MidiMerge
+
+// =============================================================================
+// MidiMerge - Class inline function definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// External global variables
+// =============================================================================
+
+//!
+//! \brief          MIDI merge engine handler object
+//! \details        MIDI merge engine handler object
+//!
+extern MidiMerge midiMerge;
+
+// =============================================================================
+// Include guard (END)
+// =============================================================================
+
+#endif  // __MIDI_MERGE_HPP
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
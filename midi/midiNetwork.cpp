@@ -0,0 +1,383 @@
+//!
+//! \file           midiNetwork.cpp
+//! \brief          Addressed MIDI packets over a multi-drop serial backbone
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Addressed MIDI packets over a multi-drop serial backbone
+//!
+
+// =============================================================================
+// System file dependencies
+// =============================================================================
+
+#include "midiNetwork.hpp"
+#if !defined(__MIDI_NETWORK_HPP)
+#    error "Header file is corrupted!"
+#elif __MIDI_NETWORK_HPP != 2304
+#    error "Version mismatch between source and header files!"
+#endif
+
+// =============================================================================
+// File exclusive - Constants
+// =============================================================================
+
+#define DEBUG_MIDI_NETWORK              0x1FFF
+
+// =============================================================================
+// File exclusive - New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// File exclusive - Global variables
+// =============================================================================
+
+MidiNetwork midiNetwork;
+
+// =============================================================================
+// File exclusive - Macro-functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Class constructors
+// =============================================================================
+
+MidiNetwork::MidiNetwork(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiNetwork::MidiNetwork(void)", DEBUG_MIDI_NETWORK);
+
+    // Reset data members
+    this->_queueHead                    = 0;
+    this->_queueTail                    = 0;
+    this->_state                        = State::IDLE;
+    this->_length                       = 0;
+    this->_index                        = 0;
+    this->_checksum                     = 0;
+    this->_isInitialized                = false;
+    this->_errorCount                   = 0;
+    this->_droppedCount                 = 0;
+
+    // Returns successfully
+    this->_lastError                    = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MIDI_NETWORK);
+    return;
+}
+
+MidiNetwork::~MidiNetwork(void)
+{
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_MIDI_NETWORK);
+    return;
+}
+
+// =============================================================================
+// Class public methods
+// =============================================================================
+
+//     ///////////////////     CONFIGURATION     ////////////////////     //
+bool_t MidiNetwork::init(cuint8_t nodeAddress_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiNetwork::init(cuint8_t)", DEBUG_MIDI_NETWORK);
+
+    // Checks for errors
+    if(nodeAddress_p == MIDI_NETWORK_BROADCAST) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+        debugMessage(Error::ARGUMENT_VALUE_INVALID, DEBUG_MIDI_NETWORK);
+        return false;
+    }
+
+    // Stop reception and empty the queue
+    usart0.deactivateReceptionCompleteInterrupt();
+    this->_isInitialized = false;
+    this->_queueHead = 0;
+    this->_queueTail = 0;
+    this->_state = State::IDLE;
+
+    // Configure USART0
+    usart0.setBaudRate<MIDI_NETWORK_BAUD_RATE>();
+    usart0.setFrameFormat(Usart0::FrameFormat::FRAME_FORMAT_9_N_1);
+    if(!usart0.setMultiprocessorMode(true, nodeAddress_p)) {
+        // Returns error
+        this->_lastError = Error::USART_DATA_SIZE_NOT_SUPPORTED;
+        debugMessage(this->_lastError, DEBUG_MIDI_NETWORK);
+        return false;
+    }
+    usart0.init();
+    usart0.enableTransmitter();
+    usart0.enableReceiver();
+    usart0.flushReceptionBuffer();
+    this->_isInitialized = true;
+    usart0.activateReceptionCompleteInterrupt();
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MIDI_NETWORK);
+    return true;
+}
+
+//     ////////////////////    DATA TRANSFER     ////////////////////     //
+bool_t MidiNetwork::sendMessage(cuint8_t nodeAddress_p, cuint8_t *message_p, cuint8_t size_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiNetwork::sendMessage(cuint8_t, cuint8_t *, cuint8_t)", DEBUG_MIDI_NETWORK);
+
+    // Local variables
+    uint8_t checksum = size_p;
+
+    // Checks for errors
+    if(!this->_isInitialized) {
+        // Returns error
+        this->_lastError = Error::NOT_INITIALIZED;
+        debugMessage(Error::NOT_INITIALIZED, DEBUG_MIDI_NETWORK);
+        return false;
+    }
+    if(!isPointerValid(message_p)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_POINTER_NULL;
+        debugMessage(Error::ARGUMENT_POINTER_NULL, DEBUG_MIDI_NETWORK);
+        return false;
+    }
+    if((size_p == 0) || (size_p > MIDI_NETWORK_MAX_PAYLOAD)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+        debugMessage(Error::ARGUMENT_VALUE_INVALID, DEBUG_MIDI_NETWORK);
+        return false;
+    }
+
+    // Send packet
+    usart0.sendAddress(nodeAddress_p);
+    usart0.sendData(size_p);
+    for(uint8_t i = 0; i < size_p; i++) {
+        usart0.sendData(message_p[i]);
+        checksum += message_p[i];
+    }
+    usart0.sendData((uint8_t)(-checksum));
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MIDI_NETWORK);
+    return true;
+}
+
+bool_t MidiNetwork::sendNote(cuint8_t nodeAddress_p, cuint8_t channel_p, cuint8_t pitch_p, cuint8_t velocity_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiNetwork::sendNote(cuint8_t, cuint8_t, cuint8_t, cuint8_t)", DEBUG_MIDI_NETWORK);
+
+    // Local variables
+    uint8_t message[3];
+
+    // Checks for errors
+    if((channel_p > 15) || (pitch_p > 127) || (velocity_p > 127)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+        debugMessage(Error::ARGUMENT_VALUE_INVALID, DEBUG_MIDI_NETWORK);
+        return false;
+    }
+
+    // Send message
+    message[0] = 0x90 | channel_p;
+    message[1] = pitch_p;
+    message[2] = velocity_p;
+    return this->sendMessage(nodeAddress_p, message, 3);
+}
+
+bool_t MidiNetwork::sendControl(cuint8_t nodeAddress_p, cuint8_t channel_p, cuint8_t controller_p,
+        cuint8_t value_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiNetwork::sendControl(cuint8_t, cuint8_t, cuint8_t, cuint8_t)", DEBUG_MIDI_NETWORK);
+
+    // Local variables
+    uint8_t message[3];
+
+    // Checks for errors
+    if((channel_p > 15) || (controller_p > 127) || (value_p > 127)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+        debugMessage(Error::ARGUMENT_VALUE_INVALID, DEBUG_MIDI_NETWORK);
+        return false;
+    }
+
+    // Send message
+    message[0] = 0xB0 | channel_p;
+    message[1] = controller_p;
+    message[2] = value_p;
+    return this->sendMessage(nodeAddress_p, message, 3);
+}
+
+void MidiNetwork::process(void)
+{
+    // Deliver received packets, oldest first
+    while(this->_queueTail != this->_queueHead) {
+        midiNetworkMessageCallback(this->_packetData[this->_queueTail], this->_packetSize[this->_queueTail]);
+        this->_queueTail = (this->_queueTail + 1) & (MIDI_NETWORK_QUEUE_SIZE - 1);
+    }
+
+    return;
+}
+
+//     /////////////////     CONTROL AND STATUS     /////////////////     //
+uint16_t MidiNetwork::getErrorCount(void)
+{
+    // Local variables
+    uint16_t aux16;
+
+    // Read atomically
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        aux16 = this->_errorCount;
+    }
+
+    // Returns value
+    return aux16;
+}
+
+uint16_t MidiNetwork::getDroppedCount(void)
+{
+    // Local variables
+    uint16_t aux16;
+
+    // Read atomically
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        aux16 = this->_droppedCount;
+    }
+
+    // Returns value
+    return aux16;
+}
+
+void MidiNetwork::clearCounters(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiNetwork::clearCounters(void)", DEBUG_MIDI_NETWORK);
+
+    // Reset data members
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        this->_errorCount               = 0;
+        this->_droppedCount             = 0;
+    }
+
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_MIDI_NETWORK);
+    return;
+}
+
+Error MidiNetwork::getLastError(void)
+{
+    // Returns last error
+    return this->_lastError;
+}
+
+//     /////////////////////     INTERRUPTS    //////////////////////     //
+void MidiNetwork::receptionHandler(cuint16_t frame_p)
+{
+    // Local variables
+    uint8_t data = (uint8_t)frame_p;
+
+    // Address frame - a new packet starts (an unfinished one is lost)
+    if(isBitSet(frame_p, 8)) {
+        if((this->_state != State::IDLE) && (this->_errorCount != 0xFFFF)) {
+            this->_errorCount++;
+        }
+        if(((this->_queueHead + 1) & (MIDI_NETWORK_QUEUE_SIZE - 1)) == this->_queueTail) {
+            if(this->_droppedCount != 0xFFFF) {
+                this->_droppedCount++;
+            }
+            this->_abortReception(false);
+            return;
+        }
+        this->_state = State::LENGTH;
+        return;
+    }
+
+    // Data frames
+    switch(this->_state) {
+    case State::LENGTH:
+        if((data == 0) || (data > MIDI_NETWORK_MAX_PAYLOAD)) {
+            this->_abortReception(true);
+            return;
+        }
+        this->_length = data;
+        this->_index = 0;
+        this->_checksum = data;
+        this->_state = State::PAYLOAD;
+        break;
+    case State::PAYLOAD:
+        this->_packetData[this->_queueHead][this->_index++] = data;
+        this->_checksum += data;
+        if(this->_index == this->_length) {
+            this->_state = State::CHECKSUM;
+        }
+        break;
+    case State::CHECKSUM:
+        if((uint8_t)(this->_checksum + data) != 0) {
+            this->_abortReception(true);
+            return;
+        }
+        this->_packetSize[this->_queueHead] = this->_length;
+        this->_queueHead = (this->_queueHead + 1) & (MIDI_NETWORK_QUEUE_SIZE - 1);
+        this->_abortReception(false);
+        break;
+    default:                // Stray data - wait for the next address
+        this->_abortReception(false);
+        break;
+    }
+
+    return;
+}
+
+// =============================================================================
+// Class private methods
+// =============================================================================
+
+//     /////////////////////     INTERRUPTS    //////////////////////     //
+void MidiNetwork::_abortReception(cbool_t isError_p)
+{
+    // Count error
+    if(isError_p && (this->_errorCount != 0xFFFF)) {
+        this->_errorCount++;
+    }
+
+    // Ignore data frames until the next matching address
+    this->_state = State::IDLE;
+    usart0.activateAddressFilter();
+
+    return;
+}
+
+// =============================================================================
+// Class protected methods
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// General public functions definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+void usartAddressedReceptionCallback(uint16_t frame_p)
+{
+    midiNetwork.receptionHandler(frame_p);
+}
+
+weakened void midiNetworkMessageCallback(cuint8_t *message_p, cuint8_t size_p)
+{
+    return;
+}
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
@@ -0,0 +1,348 @@
+//!
+//! \file           midiNetwork.hpp
+//! \brief          Addressed MIDI packets over a multi-drop serial backbone
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Sends and receives MIDI messages between several boards
+//!                     sharing one serial line, using the USART0
+//!                     multiprocessor mode (9-bit frames). Each packet is
+//!                     framed as:
+//!
+//!                     | Frame    | Bit 8 | Content                        |
+//!                     |----------|-------|--------------------------------|
+//!                     | Address  | 1     | Node address, or broadcast     |
+//!                     | Length   | 0     | Payload size (1 to 8)          |
+//!                     | Payload  | 0     | MIDI message bytes             |
+//!                     | Checksum | 0     | Makes the sum of length,       |
+//!                     |          |       | payload and checksum zero      |
+//!
+//!                     The nodes not addressed by a packet ignore its data
+//!                     frames in hardware, so they take a single interrupt
+//!                     per packet. The backbone uses USART0 exclusively: it
+//!                     cannot be used together with the MIDI output and
+//!                     input drivers.
+//!
+
+// =============================================================================
+// Include guard (START)
+// =============================================================================
+
+#ifndef __MIDI_NETWORK_HPP
+#define __MIDI_NETWORK_HPP                      2304
+
+// =============================================================================
+// Dependencies
+// =============================================================================
+
+//     /////////////////     GLOBAL DEFINITIONS FILE    /////////////////     //
+#include "../funsape/globalDefines.hpp"
+#if !defined(__GLOBAL_DEFINES_HPP)
+#   error "Global definitions file is corrupted!"
+#elif __GLOBAL_DEFINES_HPP != __MIDI_NETWORK_HPP
+#   error "Version mismatch between file header and global definitions file!"
+#endif
+
+//     //////////////////     LIBRARY DEPENDENCIES     //////////////////     //
+#include "../funsape/peripheral/usart0.hpp"
+#if !defined(__USART0_HPP)
+#   error "Header file (usart0.hpp) is corrupted!"
+#elif __USART0_HPP != __MIDI_NETWORK_HPP
+#   error "Version mismatch between header file and library dependency (usart0.hpp)!"
+#endif
+
+// =============================================================================
+// Undefining previous definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Constant definitions
+// =============================================================================
+
+#ifndef MIDI_NETWORK_BAUD_RATE
+//!
+//! \brief          Backbone baud rate
+//!
+#   define MIDI_NETWORK_BAUD_RATE       Usart0::BaudRate::BAUD_RATE_31250
+#endif
+
+#ifndef MIDI_NETWORK_MAX_PAYLOAD
+//!
+//! \brief          Largest packet payload, in bytes
+//!
+#   define MIDI_NETWORK_MAX_PAYLOAD     8
+#endif
+
+#ifndef MIDI_NETWORK_QUEUE_SIZE
+//!
+//! \brief          Number of received packets held until process() is called
+//!                     (must be a power of two)
+//!
+#   define MIDI_NETWORK_QUEUE_SIZE      4
+#endif
+
+#if (MIDI_NETWORK_QUEUE_SIZE & (MIDI_NETWORK_QUEUE_SIZE - 1)) != 0
+#   error "MIDI_NETWORK_QUEUE_SIZE must be a power of two!"
+#endif
+
+//!
+//! \brief          Address of the packets received by every node
+//!
+#define MIDI_NETWORK_BROADCAST          USART0_BROADCAST_ADDRESS
+
+// =============================================================================
+// New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+//!
+//! \brief          Received message callback function
+//! \details        This function is called from MidiNetwork::process() for the
+//!                     payload of each valid packet addressed to this node. It
+//!                     is a weak function that can be overwritten by the
+//!                     user.
+//! \param          message_p           Pointer to the message bytes
+//! \param          size_p              Number of bytes of the message
+//!
+void midiNetworkMessageCallback(
+        cuint8_t *message_p,
+        cuint8_t size_p
+);
+
+// =============================================================================
+// MidiNetwork Class
+// =============================================================================
+
+//!
+//! \brief          MidiNetwork class
+//! \details        Packets are sent in blocking mode; reception is interrupt
+//!                     driven, and process() must be called periodically from
+//!                     the main loop. Global interrupts must be enabled by the
+//!                     user.
+//!
+class MidiNetwork
+{
+    // -------------------------------------------------------------------------
+    // New data types ----------------------------------------------------------
+private:
+    //!
+    //! \brief      Reception state
+    //!
+    enum class State : uint8_t {
+        IDLE                            = 0,
+        LENGTH                          = 1,
+        PAYLOAD                         = 2,
+        CHECKSUM                        = 3
+    };
+
+    // -------------------------------------------------------------------------
+    // Constructors ------------------------------------------------------------
+public:
+    //!
+    //! \brief      MidiNetwork class constructor
+    //! \details    Creates a MidiNetwork object
+    //!
+    MidiNetwork(
+            void
+    );
+
+    //!
+    //! \brief      MidiNetwork class destructor
+    //! \details    Destroys a MidiNetwork object
+    //!
+    ~MidiNetwork(
+            void
+    );
+
+    // -------------------------------------------------------------------------
+    // Methods -----------------------------------------------------------------
+public:
+    //     ///////////////////     CONFIGURATION     ////////////////////     //
+
+    //!
+    //! \brief      Initializes the node
+    //! \details    Configures USART0 with 9-bit frames at
+    //!                 MIDI_NETWORK_BAUD_RATE, in multiprocessor mode, and
+    //!                 starts listening to the packets sent to the node
+    //!                 address and to MIDI_NETWORK_BROADCAST.
+    //! \param      nodeAddress_p       Node address (0 to 254)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t init(
+            cuint8_t nodeAddress_p
+    );
+
+    //     ////////////////////    DATA TRANSFER     ////////////////////     //
+
+    //!
+    //! \brief      Sends a MIDI message to a node
+    //! \details    Sends a packet with the message as payload. The function
+    //!                 returns when the last frame is handed to the USART.
+    //! \param      nodeAddress_p       Destination node (0 to 254, or
+    //!                                     MIDI_NETWORK_BROADCAST)
+    //! \param      message_p           Pointer to the message bytes
+    //! \param      size_p              Number of bytes (1 to
+    //!                                     MIDI_NETWORK_MAX_PAYLOAD)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t sendMessage(
+            cuint8_t nodeAddress_p,
+            cuint8_t *message_p,
+            cuint8_t size_p
+    );
+
+    //!
+    //! \brief      Sends a note to a node
+    //! \details    Sends a Note On message; a zero velocity switches the
+    //!                 note off.
+    //! \param      nodeAddress_p       Destination node
+    //! \param      channel_p           MIDI channel (0 to 15)
+    //! \param      pitch_p             MIDI note number (0 to 127)
+    //! \param      velocity_p          Velocity (0 to 127)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t sendNote(
+            cuint8_t nodeAddress_p,
+            cuint8_t channel_p,
+            cuint8_t pitch_p,
+            cuint8_t velocity_p
+    );
+
+    //!
+    //! \brief      Sends a controller change to a node
+    //! \details    Sends a Control Change message.
+    //! \param      nodeAddress_p       Destination node
+    //! \param      channel_p           MIDI channel (0 to 15)
+    //! \param      controller_p        Controller number (0 to 127)
+    //! \param      value_p             Controller value (0 to 127)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t sendControl(
+            cuint8_t nodeAddress_p,
+            cuint8_t channel_p,
+            cuint8_t controller_p,
+            cuint8_t value_p
+    );
+
+    //!
+    //! \brief      Delivers the received packets
+    //! \details    Calls \ref{midiNetworkMessageCallback} for each packet
+    //!                 received since the last call.
+    //!
+    void process(
+            void
+    );
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+
+    //!
+    //! \brief      Returns the number of invalid packets
+    //! \details    Returns the number of packets discarded because of an
+    //!                 invalid length or checksum. The counter saturates at
+    //!                 0xFFFF.
+    //! \return     uint16_t            Invalid packets
+    //!
+    uint16_t getErrorCount(
+            void
+    );
+
+    //!
+    //! \brief      Returns the number of dropped packets
+    //! \details    Returns the number of packets lost because the reception
+    //!                 queue was full. The counter saturates at 0xFFFF.
+    //! \return     uint16_t            Dropped packets
+    //!
+    uint16_t getDroppedCount(
+            void
+    );
+
+    //!
+    //! \brief      Clears the counters
+    //! \details    Clears the invalid and dropped packets counters.
+    //!
+    void clearCounters(
+            void
+    );
+
+    //!
+    //! \brief      Returns the last error
+    //! \details    Returns the last error.
+    //! \return     Error               Error status of the last operation
+    //!
+    Error getLastError(
+            void
+    );
+
+    //     /////////////////////     INTERRUPTS    //////////////////////     //
+
+    //!
+    //! \brief      Frame reception handler
+    //! \details    Assembles the packets. Called from the USART Reception
+    //!                 Complete interrupt.
+    //! \param      frame_p             Received frame (9 bits)
+    //!
+    void receptionHandler(
+            cuint16_t frame_p
+    );
+
+private:
+    //     /////////////////////     INTERRUPTS    //////////////////////     //
+    void _abortReception(
+            cbool_t isError_p
+    );
+
+protected:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Properties --------------------------------------------------------------
+private:
+    //     ////////////////////    DATA TRANSFER     ////////////////////     //
+    uint8_t             _packetData[MIDI_NETWORK_QUEUE_SIZE][MIDI_NETWORK_MAX_PAYLOAD];
+    uint8_t             _packetSize[MIDI_NETWORK_QUEUE_SIZE];
+    vuint8_t            _queueHead;
+    vuint8_t            _queueTail;
+    State               _state;         // Used only by the interrupt
+    uint8_t             _length;        // Used only by the interrupt
+    uint8_t             _index;         // Used only by the interrupt
+    uint8_t             _checksum;      // Used only by the interrupt
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+    bool_t              _isInitialized                  : 1;
+    vuint16_t           _errorCount;
+    vuint16_t           _droppedCount;
+    Error               _lastError;
+}; // class MidiNetwork
+
+// =============================================================================
+// MidiNetwork - Class inline function definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// External global variables
+// =============================================================================
+
+//!
+//! \brief          MIDI network handler object
+//! \details        MIDI network handler object
+//!
+extern MidiNetwork midiNetwork;
+
+// =============================================================================
+// Include guard (END)
+// =============================================================================
+
+#endif  // __MIDI_NETWORK_HPP
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
@@ -0,0 +1,581 @@
+//!
+//! \file           midiOutput.cpp
+//! \brief          Interrupt-driven MIDI output stream
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        MIDI output stream fed from the main loop and drained by the
+//!                     USART0 Transmission Buffer Empty interrupt, or by the
+//!                     main loop through the VS1053 SDI port.
+//!
+
+// =============================================================================
+// System file dependencies
+// =============================================================================
+
+#include "midiOutput.hpp"
+#if !defined(__MIDI_OUTPUT_HPP)
+#    error "Header file is corrupted!"
+#elif __MIDI_OUTPUT_HPP != 2304
+#    error "Version mismatch between source and header files!"
+#endif
+
+// =============================================================================
+// File exclusive - Constants
+// =============================================================================
+
+#define DEBUG_MIDI_OUTPUT               0x1FFF
+
+static_assert((MIDI_OUTPUT_BUFFER_SIZE & (MIDI_OUTPUT_BUFFER_SIZE - 1)) == 0,
+        "MIDI_OUTPUT_BUFFER_SIZE must be a power of two!");
+static_assert((MIDI_OUTPUT_BUFFER_SIZE >= 4) && (MIDI_OUTPUT_BUFFER_SIZE <= 128),
+        "MIDI_OUTPUT_BUFFER_SIZE must be between 4 and 128!");
+
+static_assert((MIDI_OUTPUT_REALTIME_SIZE & (MIDI_OUTPUT_REALTIME_SIZE - 1)) == 0,
+        "MIDI_OUTPUT_REALTIME_SIZE must be a power of two!");
+
+static_assert((MIDI_OUTPUT_SDI_BURST_SIZE >= 2) && ((MIDI_OUTPUT_SDI_BURST_SIZE & 1) == 0),
+        "MIDI_OUTPUT_SDI_BURST_SIZE must be an even number!");
+
+cuint8_t constBufferMask                = (MIDI_OUTPUT_BUFFER_SIZE - 1);    //!< Ring buffer index mask
+cuint8_t constRealtimeMask              = (MIDI_OUTPUT_REALTIME_SIZE - 1);  //!< Real-Time buffer index mask
+
+// =============================================================================
+// File exclusive - New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// File exclusive - Global variables
+// =============================================================================
+
+MidiOutput midiOutput;
+
+// =============================================================================
+// File exclusive - Macro-functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Class constructors
+// =============================================================================
+
+MidiOutput::MidiOutput(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiOutput::MidiOutput(void)", DEBUG_MIDI_OUTPUT);
+
+    // Reset data members
+    this->_backend                      = Backend::UART;
+    this->_bus                          = nullptr;
+    this->_activateDevice               = nullptr;
+    this->_deactivateDevice             = nullptr;
+    this->_isDeviceReady                = nullptr;
+    this->_head                         = 0;
+    this->_tail                         = 0;
+    this->_realtimeHead                 = 0;
+    this->_realtimeTail                 = 0;
+    this->_overflowCount                = 0;
+    this->_droppedBytes                 = 0;
+    this->_runningStatus                = 0;
+    this->_refreshInterval              = 0;
+    this->_omittedCount                 = 0;
+    this->_isInitialized                = false;
+    this->_runningStatusEnabled         = false;
+
+    // Returns successfully
+    this->_lastError                    = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MIDI_OUTPUT);
+    return;
+}
+
+MidiOutput::~MidiOutput(void)
+{
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_MIDI_OUTPUT);
+    return;
+}
+
+// =============================================================================
+// Class public methods
+// =============================================================================
+
+//     ///////////////////     CONFIGURATION     ////////////////////     //
+bool_t MidiOutput::init(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiOutput::init(void)", DEBUG_MIDI_OUTPUT);
+
+    // Stop the consumer before touching the indexes
+    usart0.deactivateTransmissionBufferEmptyInterrupt();
+    this->_isInitialized                = false;
+
+    // Reset data members
+    this->_backend                      = Backend::UART;
+    this->_head                         = 0;
+    this->_tail                         = 0;
+    this->_realtimeHead                 = 0;
+    this->_realtimeTail                 = 0;
+    this->_overflowCount                = 0;
+    this->_droppedBytes                 = 0;
+    this->_runningStatus                = 0;
+    this->_omittedCount                 = 0;
+
+    // Enable transmitter
+    usart0.enableTransmitter();
+    this->_isInitialized                = true;
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MIDI_OUTPUT);
+    return true;
+}
+
+bool_t MidiOutput::init(Bus *bus_p, void (* actFunc_p)(void), void (* deactFunc_p)(void),
+        bool_t (* isReadyFunc_p)(void))
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiOutput::init(Bus *, void *(void), void *(void), bool_t *(void))", DEBUG_MIDI_OUTPUT);
+
+    // Checks for errors
+    if(!isPointerValid(bus_p)) {
+        // Returns error
+        this->_lastError = Error::BUS_HANDLER_POINTER_NULL;
+        debugMessage(Error::BUS_HANDLER_POINTER_NULL, DEBUG_MIDI_OUTPUT);
+        return false;
+    }
+    if(bus_p->getBusType() != Bus::BusType::SPI) {
+        // Returns error
+        this->_lastError = Error::BUS_HANDLER_NOT_SUPPORTED;
+        debugMessage(Error::BUS_HANDLER_NOT_SUPPORTED, DEBUG_MIDI_OUTPUT);
+        return false;
+    }
+    if((actFunc_p == nullptr) || (deactFunc_p == nullptr) || (isReadyFunc_p == nullptr)) {
+        // Returns error
+        this->_lastError = Error::FUNCTION_POINTER_NULL;
+        debugMessage(Error::FUNCTION_POINTER_NULL, DEBUG_MIDI_OUTPUT);
+        return false;
+    }
+
+    // Stop the UART consumer before touching the indexes
+    usart0.deactivateTransmissionBufferEmptyInterrupt();
+    this->_isInitialized                = false;
+
+    // Reset data members
+    this->_backend                      = Backend::VS1053_SDI;
+    this->_bus                          = bus_p;
+    this->_activateDevice               = actFunc_p;
+    this->_deactivateDevice             = deactFunc_p;
+    this->_isDeviceReady                = isReadyFunc_p;
+    this->_head                         = 0;
+    this->_tail                         = 0;
+    this->_realtimeHead                 = 0;
+    this->_realtimeTail                 = 0;
+    this->_overflowCount                = 0;
+    this->_droppedBytes                 = 0;
+    this->_runningStatus                = 0;
+    this->_omittedCount                 = 0;
+    this->_isInitialized                = true;
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MIDI_OUTPUT);
+    return true;
+}
+
+void MidiOutput::setRunningStatus(cbool_t enable_p, cuint8_t refreshInterval_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiOutput::setRunningStatus(cbool_t, cuint8_t)", DEBUG_MIDI_OUTPUT);
+
+    // Update data members
+    this->_runningStatusEnabled         = enable_p;
+    this->_refreshInterval              = refreshInterval_p;
+    this->resetRunningStatus();
+
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_MIDI_OUTPUT);
+    return;
+}
+
+void MidiOutput::resetRunningStatus(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiOutput::resetRunningStatus(void)", DEBUG_MIDI_OUTPUT);
+
+    // Reset data members
+    this->_runningStatus                = 0;
+    this->_omittedCount                 = 0;
+
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_MIDI_OUTPUT);
+    return;
+}
+
+//     ////////////////////    DATA TRANSFER     ////////////////////     //
+bool_t MidiOutput::sendMessage(cuint8_t *message_p, cuint8_t size_p, cbool_t wait_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiOutput::sendMessage(cuint8_t *, cuint8_t, cbool_t)", DEBUG_MIDI_OUTPUT);
+
+    // Local variables
+    uint8_t auxHead = this->_head;
+    uint8_t skip = 0;
+
+    // Checks for errors
+    if(!this->_isInitialized) {
+        // Returns error
+        this->_lastError = Error::NOT_INITIALIZED;
+        debugMessage(Error::NOT_INITIALIZED, DEBUG_MIDI_OUTPUT);
+        return false;
+    }
+    if(!isPointerValid(message_p)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_POINTER_NULL;
+        debugMessage(Error::ARGUMENT_POINTER_NULL, DEBUG_MIDI_OUTPUT);
+        return false;
+    }
+    if(size_p == 0) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_CANNOT_BE_ZERO;
+        debugMessage(Error::ARGUMENT_CANNOT_BE_ZERO, DEBUG_MIDI_OUTPUT);
+        return false;
+    }
+    if(size_p > (MIDI_OUTPUT_BUFFER_SIZE - 1)) {
+        // Returns error
+        this->_lastError = Error::BUFFER_SIZE_TOO_SMALL;
+        debugMessage(Error::BUFFER_SIZE_TOO_SMALL, DEBUG_MIDI_OUTPUT);
+        return false;
+    }
+
+    // Running status - omit repeated channel status bytes; data-only chunks
+    // (System Exclusive continuations) are never compared
+    if(this->_runningStatusEnabled && (message_p[0] >= 0x80) && (message_p[0] < 0xF0) &&
+            (message_p[0] == this->_runningStatus) && (size_p > 1)) {
+        if((this->_refreshInterval == 0) || (this->_omittedCount < this->_refreshInterval)) {
+            skip = 1;
+        }
+    }
+
+    // Checks for free space
+    if(this->getFreeSpace() < (size_p - skip)) {
+        // Update counters
+        if(this->_overflowCount < 0xFFFF) {
+            this->_overflowCount++;
+        }
+        if(!wait_p) {
+            this->_droppedBytes = ((uint16_t)(0xFFFF - this->_droppedBytes) < (size_p - skip)) ?
+                    0xFFFF : (this->_droppedBytes + size_p - skip);
+
+            // Returns error
+            this->_lastError = Error::BUFFER_NOT_ENOUGH_SPACE;
+            debugMessage(Error::BUFFER_NOT_ENOUGH_SPACE, DEBUG_MIDI_OUTPUT);
+            return false;
+        }
+        // Wait for the consumer to free enough space
+        while(this->getFreeSpace() < (size_p - skip)) {
+            this->_startTransmission();
+        }
+    }
+
+    // Copy message, publishing the new head only after all bytes are stored
+    for(uint8_t i = skip; i < size_p; i++) {
+        this->_buffer[auxHead] = message_p[i];
+        auxHead = (auxHead + 1) & constBufferMask;
+    }
+    this->_head = auxHead;
+
+    // Update running status
+    if(skip) {
+        this->_omittedCount++;
+    } else if((message_p[0] >= 0x80) && (message_p[0] < 0xF0)) {
+        this->_runningStatus = message_p[0];
+        this->_omittedCount = 0;
+    } else if((message_p[0] >= 0xF0) && (message_p[0] < 0xF8)) {
+        // System Common and System Exclusive messages restart running status;
+        // Real-Time messages leave it untouched, as in sendRealtime()
+        this->_runningStatus = 0;
+        this->_omittedCount = 0;
+    }
+
+    // Wake up consumer
+    this->_startTransmission();
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MIDI_OUTPUT);
+    return true;
+}
+
+bool_t MidiOutput::sendRealtime(cuint8_t message_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiOutput::sendRealtime(cuint8_t)", DEBUG_MIDI_OUTPUT);
+
+    // Local variables
+    bool_t queued = false;
+
+    // Checks for errors
+    if(!this->_isInitialized) {
+        // Returns error
+        this->_lastError = Error::NOT_INITIALIZED;
+        debugMessage(Error::NOT_INITIALIZED, DEBUG_MIDI_OUTPUT);
+        return false;
+    }
+    if(message_p < 0xF8) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+        debugMessage(Error::ARGUMENT_VALUE_INVALID, DEBUG_MIDI_OUTPUT);
+        return false;
+    }
+
+    // Store byte; interrupt handlers may also enqueue Real-Time bytes
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        queued = this->pushRealtime(message_p);
+    }
+    if(!queued) {
+        // Update counters
+        if(this->_overflowCount < 0xFFFF) {
+            this->_overflowCount++;
+        }
+        if(this->_droppedBytes < 0xFFFF) {
+            this->_droppedBytes++;
+        }
+
+        // Returns error
+        this->_lastError = Error::BUFFER_NOT_ENOUGH_SPACE;
+        debugMessage(Error::BUFFER_NOT_ENOUGH_SPACE, DEBUG_MIDI_OUTPUT);
+        return false;
+    }
+
+    // Send it right away through SDI
+    if(this->_backend == Backend::VS1053_SDI) {
+        this->_sendSdi();
+    }
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MIDI_OUTPUT);
+    return true;
+}
+
+bool_t MidiOutput::pushRealtime(cuint8_t message_p)
+{
+    // Local variables
+    uint8_t auxHead = this->_realtimeHead;
+    uint8_t nextHead = (auxHead + 1) & constRealtimeMask;
+
+    // Checks for errors
+    if((!this->_isInitialized) || (message_p < 0xF8) || (nextHead == this->_realtimeTail)) {
+        return false;
+    }
+
+    // Store byte and wake up consumer (the SDI consumer is the main loop)
+    this->_realtimeBuffer[auxHead] = message_p;
+    this->_realtimeHead = nextHead;
+    if(this->_backend == Backend::UART) {
+        usart0.activateTransmissionBufferEmptyInterrupt();
+    }
+
+    return true;
+}
+
+void MidiOutput::flush(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiOutput::flush(void)", DEBUG_MIDI_OUTPUT);
+
+    // Wait until consumer empties the buffers
+    while((this->_head != this->_tail) || (this->_realtimeHead != this->_realtimeTail)) {
+        if(this->_backend == Backend::VS1053_SDI) {
+            this->_sendSdi();
+        }
+    }
+
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_MIDI_OUTPUT);
+    return;
+}
+
+void MidiOutput::process(void)
+{
+    // Send pending bytes
+    if(this->_isInitialized && (this->_backend == Backend::VS1053_SDI)) {
+        this->_sendSdi();
+    }
+
+    return;
+}
+
+//     /////////////////     CONTROL AND STATUS     /////////////////     //
+uint16_t MidiOutput::getOverflowCount(void)
+{
+    // Returns successfully
+    return this->_overflowCount;
+}
+
+uint16_t MidiOutput::getDroppedBytes(void)
+{
+    // Returns successfully
+    return this->_droppedBytes;
+}
+
+void MidiOutput::clearCounters(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiOutput::clearCounters(void)", DEBUG_MIDI_OUTPUT);
+
+    // Reset data members
+    this->_overflowCount                = 0;
+    this->_droppedBytes                 = 0;
+
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_MIDI_OUTPUT);
+    return;
+}
+
+MidiOutput::Backend MidiOutput::getBackend(void)
+{
+    // Returns backend
+    return this->_backend;
+}
+
+Error MidiOutput::getLastError(void)
+{
+    // Returns last error
+    return this->_lastError;
+}
+
+//     /////////////////////     INTERRUPTS    //////////////////////     //
+void MidiOutput::transmissionBufferEmptyHandler(void)
+{
+    // Local variables
+    uint8_t auxTail = this->_realtimeTail;
+
+    // Real-Time bytes have priority
+    if(auxTail != this->_realtimeHead) {
+        UDR0 = this->_realtimeBuffer[auxTail];
+        this->_realtimeTail = (auxTail + 1) & constRealtimeMask;
+        midiOutputRealtimeSentCallback(this->_realtimeBuffer[auxTail]);
+        return;
+    }
+
+    // Nothing left to send
+    auxTail = this->_tail;
+    if(auxTail == this->_head) {
+        usart0.deactivateTransmissionBufferEmptyInterrupt();
+        return;
+    }
+
+    // Send next byte
+    UDR0 = this->_buffer[auxTail];
+    this->_tail = (auxTail + 1) & constBufferMask;
+
+    return;
+}
+
+// =============================================================================
+// Class private methods
+// =============================================================================
+
+//     ////////////////////    DATA TRANSFER     ////////////////////     //
+void MidiOutput::_startTransmission(void)
+{
+    // Wake up the consumer
+    if(this->_backend == Backend::UART) {
+        usart0.activateTransmissionBufferEmptyInterrupt();
+    } else {
+        this->_sendSdi();
+    }
+
+    return;
+}
+
+void MidiOutput::_sendSdi(void)
+{
+    // Local variables
+    uint8_t burst[MIDI_OUTPUT_SDI_BURST_SIZE];
+    uint8_t size;
+    uint8_t auxTail;
+    uint8_t realtimeSent;
+
+    while((this->_head != this->_tail) || (this->_realtimeHead != this->_realtimeTail)) {
+        // DREQ low - the VS1053 FIFO is full, try again later
+        if(!this->_isDeviceReady()) {
+            break;
+        }
+
+        // Real-Time bytes first, each MIDI byte padded to a 16-bit word
+        size = 0;
+        realtimeSent = 0;
+        auxTail = this->_realtimeTail;
+        while((auxTail != this->_realtimeHead) && (size < MIDI_OUTPUT_SDI_BURST_SIZE)) {
+            burst[size++] = 0x00;
+            burst[size++] = this->_realtimeBuffer[auxTail];
+            auxTail = (auxTail + 1) & constRealtimeMask;
+            realtimeSent++;
+        }
+        this->_realtimeTail = auxTail;
+        auxTail = this->_tail;
+        while((auxTail != this->_head) && (size < MIDI_OUTPUT_SDI_BURST_SIZE)) {
+            burst[size++] = 0x00;
+            burst[size++] = this->_buffer[auxTail];
+            auxTail = (auxTail + 1) & constBufferMask;
+        }
+        this->_tail = auxTail;
+
+        // Send the whole burst in a single transfer
+        this->_bus->setDevice(this->_activateDevice, this->_deactivateDevice);
+        if(!this->_bus->sendData(burst, nullptr, size)) {
+            this->_lastError = this->_bus->getLastError();
+            debugMessage(this->_lastError, DEBUG_MIDI_OUTPUT);
+            break;
+        }
+
+        // Real-Time bytes leave the buffer in the interrupt with the UART
+        // backend; keep the callback in the same context
+        for(uint8_t i = 1; i < size; i += 2) {
+            if(realtimeSent == 0) {
+                break;
+            }
+            realtimeSent--;
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                midiOutputRealtimeSentCallback(burst[i]);
+            }
+        }
+    }
+
+    return;
+}
+
+// =============================================================================
+// Class protected methods
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// General public functions definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+weakened void midiOutputRealtimeSentCallback(uint8_t message_p)
+{
+    return;
+}
+
+void usartTransmissionBufferEmptyCallback(void)
+{
+    midiOutput.transmissionBufferEmptyHandler();
+}
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
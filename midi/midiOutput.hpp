@@ -0,0 +1,457 @@
+//!
+//! \file           midiOutput.hpp
+//! \brief          Interrupt-driven MIDI output stream
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        MIDI output stream fed from the main loop and drained by the
+//!                     USART0 Transmission Buffer Empty interrupt. The bytes
+//!                     are stored in a lock-free single-producer /
+//!                     single-consumer ring buffer. Repeated channel status
+//!                     bytes can be omitted (running status). The stream can
+//!                     also be sent to the VS1053 real-time MIDI decoder
+//!                     through its SDI port, over any SPI bus handler.
+//!
+
+// =============================================================================
+// Include guard (START)
+// =============================================================================
+
+#ifndef __MIDI_OUTPUT_HPP
+#define __MIDI_OUTPUT_HPP                       2304
+
+// =============================================================================
+// Dependencies
+// =============================================================================
+
+//     /////////////////     GLOBAL DEFINITIONS FILE    /////////////////     //
+#include "../funsape/globalDefines.hpp"
+#if !defined(__GLOBAL_DEFINES_HPP)
+#   error "Global definitions file is corrupted!"
+#elif __GLOBAL_DEFINES_HPP != __MIDI_OUTPUT_HPP
+#   error "Version mismatch between file header and global definitions file!"
+#endif
+
+//     //////////////////     LIBRARY DEPENDENCIES     //////////////////     //
+#include "../funsape/peripheral/usart0.hpp"
+#if !defined(__USART0_HPP)
+#   error "Header file (usart0.hpp) is corrupted!"
+#elif __USART0_HPP != __MIDI_OUTPUT_HPP
+#   error "Version mismatch between header file and library dependency (usart0.hpp)!"
+#endif
+
+#include "../funsape/util/bus.hpp"
+#if !defined(__BUS_HPP)
+#   error "Header file (bus.hpp) is corrupted!"
+#elif __BUS_HPP != __MIDI_OUTPUT_HPP
+#   error "Version mismatch between header file and library dependency (bus.hpp)!"
+#endif
+
+// =============================================================================
+// Undefining previous definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Constant definitions
+// =============================================================================
+
+#ifndef MIDI_OUTPUT_BUFFER_SIZE
+//!
+//! \brief          Size of the transmission ring buffer, in bytes
+//! \details        Must be a power of two no larger than 128, so that the
+//!                     indexes can be wrapped with a single mask operation.
+//!
+#   define MIDI_OUTPUT_BUFFER_SIZE      64
+#endif
+
+#ifndef MIDI_OUTPUT_REALTIME_SIZE
+//!
+//! \brief          Size of the System Real-Time ring buffer, in bytes
+//! \details        Must be a power of two.
+//!
+#   define MIDI_OUTPUT_REALTIME_SIZE    4
+#endif
+
+#ifndef MIDI_OUTPUT_SDI_BURST_SIZE
+//!
+//! \brief          Largest SDI burst, in bytes
+//! \details        Each MIDI byte takes two SDI bytes. The VS1053 accepts at
+//!                     least 32 bytes each time DREQ is high.
+//!
+#   define MIDI_OUTPUT_SDI_BURST_SIZE   32
+#endif
+
+// =============================================================================
+// New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+//!
+//! \brief          Real-Time byte sent callback function
+//! \details        This function is called from the USART Data Register Empty
+//!                     interrupt each time a Real-Time byte is handed to the
+//!                     USART, or with the interrupts disabled right after a
+//!                     Real-Time byte is sent through SDI. It is a weak
+//!                     function that can be overwritten by the user.
+//! \param          message_p           Real-Time status byte
+//!
+void midiOutputRealtimeSentCallback(
+        uint8_t message_p
+);
+
+// =============================================================================
+// MidiOutput Class
+// =============================================================================
+
+//!
+//! \brief          MidiOutput class
+//! \details        Buffers outgoing MIDI messages and transmits them through
+//!                     USART0, one byte per Transmission Buffer Empty
+//!                     interrupt. Only the main loop may enqueue messages and
+//!                     only the interrupt may dequeue bytes, so no locking is
+//!                     needed between them. With the SDI backend the buffers
+//!                     are drained from the main loop instead, in bursts
+//!                     clocked at the SPI speed.
+//!                     As the MIDI specification requires of every receiver,
+//!                     System Real-Time bytes never change the running
+//!                     status, whichever path sends them (sendRealtime(),
+//!                     pushRealtime() or sendMessage()): they may be sent
+//!                     between the bytes of any message, so there is no point
+//!                     where they could restart it. System Common and System
+//!                     Exclusive messages do restart it.
+//!
+class MidiOutput
+{
+    // -------------------------------------------------------------------------
+    // New data types ----------------------------------------------------------
+public:
+    //!
+    //! \brief      Output backend
+    //!
+    enum class Backend : uint8_t {
+        UART                            = 0,    //!< USART0 at the MIDI baud rate
+        VS1053_SDI                      = 1     //!< VS1053 real-time MIDI through SDI
+    };
+
+    // -------------------------------------------------------------------------
+    // Constructors ------------------------------------------------------------
+public:
+    //!
+    //! \brief      MidiOutput class constructor
+    //! \details    Creates a MidiOutput object
+    //!
+    MidiOutput(
+            void
+    );
+
+    //!
+    //! \brief      MidiOutput class destructor
+    //! \details    Destroys a MidiOutput object
+    //!
+    ~MidiOutput(
+            void
+    );
+
+    // -------------------------------------------------------------------------
+    // Methods -----------------------------------------------------------------
+public:
+    //     ///////////////////     CONFIGURATION     ////////////////////     //
+
+    //!
+    //! \brief      Initializes the MIDI output stream
+    //! \details    Empties the ring buffer, clears the counters and enables
+    //!                 the USART0 transmitter. The USART0 frame format and
+    //!                 baud rate must be configured beforehand.
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t init(
+            void
+    );
+
+    //!
+    //! \brief      Initializes the MIDI output stream on the VS1053 SDI port
+    //! \details    Empties the ring buffer and clears the counters. The
+    //!                 stream is sent to the VS1053 data port (each MIDI byte
+    //!                 padded to a 16-bit word, as required by the real-time
+    //!                 MIDI mode) whenever the VS1053 requests data. The bus
+    //!                 must be initialized beforehand, with a clock up to
+    //!                 CLKI/4, and the VS1053 must boot in real-time MIDI
+    //!                 mode (GPIO0 low and GPIO1 high at reset, or the
+    //!                 real-time MIDI plugin loaded). The USART0 is not used.
+    //! \param      bus_p               Pointer to the SPI bus handler
+    //! \param      actFunc_p           Pointer to the XDCS activate function
+    //! \param      deactFunc_p         Pointer to the XDCS release function
+    //! \param      isReadyFunc_p       Pointer to the function that returns
+    //!                                     the DREQ pin state
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t init(
+            Bus *bus_p,
+            void (* actFunc_p)(void),
+            void (* deactFunc_p)(void),
+            bool_t (* isReadyFunc_p)(void)
+    );
+
+    //!
+    //! \brief      Configures the running status encoder
+    //! \details    When enabled, the status byte of a channel message is left
+    //!                 out if it is equal to the last status byte sent. The
+    //!                 status byte is sent again after refreshInterval_p
+    //!                 consecutive messages without it, so that a receiver
+    //!                 connected in the middle of the stream can resynchronize.
+    //!                 A refresh interval of zero never forces the status byte.
+    //! \param      enable_p            Enables or disables running status
+    //! \param      refreshInterval_p   Maximum number of messages sent without
+    //!                                     the status byte
+    //!
+    void setRunningStatus(
+            cbool_t enable_p,
+            cuint8_t refreshInterval_p  = 0
+    );
+
+    //!
+    //! \brief      Forgets the last status byte sent
+    //! \details    Forces the next channel message to be sent with its status
+    //!                 byte. Called automatically when a System Common or
+    //!                 System Exclusive message is sent.
+    //!
+    void resetRunningStatus(
+            void
+    );
+
+    //     ////////////////////    DATA TRANSFER     ////////////////////     //
+
+    //!
+    //! \brief      Enqueues a complete MIDI message
+    //! \details    The message is either stored entirely or not at all, so a
+    //!                 full buffer never splits a message on the wire. When
+    //!                 the message does not fit, the overflow counter is
+    //!                 incremented; then, if wait_p is set, the function spins
+    //!                 until the interrupt frees enough space, otherwise the
+    //!                 message is dropped and the function returns false.
+    //!                 The running status state is updated only when the
+    //!                 message is accepted.
+    //! \param      message_p           Pointer to the message bytes
+    //! \param      size_p              Number of bytes of the message
+    //! \param      wait_p              Wait for free space instead of failing
+    //! \return     bool_t              True on success / False on failure
+    //! \warning    Never set wait_p with interrupts disabled.
+    //!
+    bool_t sendMessage(
+            cuint8_t *message_p,
+            cuint8_t size_p,
+            cbool_t wait_p              = false
+    );
+
+    //!
+    //! \brief      Enqueues a System Real-Time message
+    //! \details    Real-Time bytes are kept in a separate queue that is served
+    //!                 before the message buffer, so they can be sent between
+    //!                 the bytes of any other message with minimum latency.
+    //!                 The running status is kept.
+    //! \param      message_p           Real-Time status byte (0xF8 to 0xFF)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t sendRealtime(
+            cuint8_t message_p
+    );
+
+    //!
+    //! \brief      Enqueues a System Real-Time message from an interrupt
+    //! \details    Interrupt-safe version of sendRealtime(). Neither the
+    //!                 counters nor the last error are changed, so it may
+    //!                 preempt the main loop at any point. As in
+    //!                 sendRealtime(), the running status is kept.
+    //!                 Must be called with the interrupts disabled.
+    //! \param      message_p           Real-Time status byte (0xF8 to 0xFF)
+    //! \return     bool_t              True on success / False if the queue
+    //!                                     is full
+    //!
+    bool_t pushRealtime(
+            cuint8_t message_p
+    );
+
+    //!
+    //! \brief      Waits until every buffered byte was handed to the USART
+    //! \details    Waits until every buffered byte was handed to the USART.
+    //!
+    void flush(
+            void
+    );
+
+    //!
+    //! \brief      Sends the buffered bytes through SDI
+    //! \details    Sends as many buffered bytes as the VS1053 accepts,
+    //!                 Real-Time bytes first. Must be called from the main
+    //!                 loop, since the Real-Time bytes queued by interrupts
+    //!                 are sent only here. Does nothing with the UART
+    //!                 backend.
+    //!
+    void process(
+            void
+    );
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+
+    //!
+    //! \brief      Returns the number of free bytes in the ring buffer
+    //! \details    Returns the number of free bytes in the ring buffer.
+    //! \return     uint8_t             Free space, in bytes
+    //!
+    uint8_t inlined getFreeSpace(
+            void
+    );
+
+    //!
+    //! \brief      Returns the number of bytes waiting to be transmitted
+    //! \details    Returns the number of bytes waiting to be transmitted.
+    //! \return     uint8_t             Used space, in bytes
+    //!
+    uint8_t inlined getUsedSpace(
+            void
+    );
+
+    //!
+    //! \brief      Returns the output backend
+    //! \details    Returns the backend selected by the last init() call.
+    //! \return     Backend             Output backend
+    //!
+    Backend getBackend(
+            void
+    );
+
+    //!
+    //! \brief      Returns the number of overflow events
+    //! \details    Returns the number of messages that found the ring buffer
+    //!                 full, including the ones that waited for free space.
+    //!                 The counter saturates at 0xFFFF.
+    //! \return     uint16_t            Overflow events
+    //!
+    uint16_t getOverflowCount(
+            void
+    );
+
+    //!
+    //! \brief      Returns the number of rejected bytes
+    //! \details    Returns the number of bytes belonging to messages that
+    //!                 were not enqueued. The counter saturates at 0xFFFF.
+    //! \return     uint16_t            Rejected bytes
+    //!
+    uint16_t getDroppedBytes(
+            void
+    );
+
+    //!
+    //! \brief      Clears the overflow counters
+    //! \details    Clears the overflow counters.
+    //!
+    void clearCounters(
+            void
+    );
+
+    //!
+    //! \brief      Returns the last error
+    //! \details    Returns the last error.
+    //! \return     Error               Error status of the last operation
+    //!
+    Error getLastError(
+            void
+    );
+
+    //     /////////////////////     INTERRUPTS    //////////////////////     //
+
+    //!
+    //! \brief      Transmission Buffer Empty interrupt handler
+    //! \details    Moves the next buffered byte to UDR0, Real-Time bytes
+    //!                 first, or disables the interrupt when both buffers are
+    //!                 empty. Must be called
+    //!                 only from USART_UDRE_vect.
+    //!
+    void transmissionBufferEmptyHandler(
+            void
+    );
+
+private:
+    //     ////////////////////    DATA TRANSFER     ////////////////////     //
+    void _startTransmission(
+            void
+    );
+    void _sendSdi(
+            void
+    );
+
+protected:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Properties --------------------------------------------------------------
+private:
+    //     //////////////////////     BACKEND     ///////////////////////     //
+    Backend             _backend;
+    Bus                 *_bus;
+    void (*_activateDevice)(void);
+    void (*_deactivateDevice)(void);
+    bool_t (*_isDeviceReady)(void);
+
+    //     ////////////////////    DATA BUFFERS      ////////////////////     //
+    uint8_t             _buffer[MIDI_OUTPUT_BUFFER_SIZE];
+    vuint8_t            _head;          // Written only by the main loop
+    vuint8_t            _tail;          // Written only by the interrupt
+    uint8_t             _realtimeBuffer[MIDI_OUTPUT_REALTIME_SIZE];
+    vuint8_t            _realtimeHead;  // Written with the interrupts disabled
+    vuint8_t            _realtimeTail;  // Written only by the interrupt
+
+    //     ////////////////////    RUNNING STATUS    ////////////////////     //
+    uint8_t             _runningStatus;
+    uint8_t             _refreshInterval;
+    uint8_t             _omittedCount;
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+    bool_t              _isInitialized                  : 1;
+    bool_t              _runningStatusEnabled           : 1;
+    uint16_t            _overflowCount;
+    uint16_t            _droppedBytes;
+    Error               _lastError;
+}; // class MidiOutput
+
+// =============================================================================
+// MidiOutput - Class inline function definitions
+// =============================================================================
+
+uint8_t inlined MidiOutput::getFreeSpace(void)
+{
+    // One position is always left empty to tell a full buffer from an empty one
+    return (uint8_t)((MIDI_OUTPUT_BUFFER_SIZE - 1) - this->getUsedSpace());
+}
+
+uint8_t inlined MidiOutput::getUsedSpace(void)
+{
+    return (uint8_t)((this->_head - this->_tail) & (MIDI_OUTPUT_BUFFER_SIZE - 1));
+}
+
+// =============================================================================
+// External global variables
+// =============================================================================
+
+//!
+//! \brief          MIDI output stream handler object
+//! \details        MIDI output stream handler object
+//!
+extern MidiOutput midiOutput;
+
+// =============================================================================
+// Include guard (END)
+// =============================================================================
+
+#endif  // __MIDI_OUTPUT_HPP
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
@@ -0,0 +1,238 @@
+//!
+//! \file           midiPeripheral.cpp
+//! \brief          I2C register map to control the board from a host
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        I2C register map to control the board from a host
+//!
+
+// =============================================================================
+// System file dependencies
+// =============================================================================
+
+#include "midiPeripheral.hpp"
+#if !defined(__MIDI_PERIPHERAL_HPP)
+#    error "Header file is corrupted!"
+#elif __MIDI_PERIPHERAL_HPP != 2304
+#    error "Version mismatch between source and header files!"
+#endif
+
+// =============================================================================
+// File exclusive - Constants
+// =============================================================================
+
+#define DEBUG_MIDI_PERIPHERAL           0x1FFF
+
+// =============================================================================
+// File exclusive - New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// File exclusive - Global variables
+// =============================================================================
+
+MidiPeripheral midiPeripheral;
+
+// =============================================================================
+// File exclusive - Macro-functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Class constructors
+// =============================================================================
+
+MidiPeripheral::MidiPeripheral(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiPeripheral::MidiPeripheral(void)", DEBUG_MIDI_PERIPHERAL);
+
+    // Reset data members
+    for(uint8_t i = 0; i < MIDI_PERIPHERAL_REGISTERS; i++) {
+        this->_registers[i]             = 0;
+    }
+    this->_queueHead                    = 0;
+    this->_queueTail                    = 0;
+    this->_isInitialized                = false;
+    this->_rejectedCount                = 0;
+
+    // Returns successfully
+    this->_lastError                    = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MIDI_PERIPHERAL);
+    return;
+}
+
+MidiPeripheral::~MidiPeripheral(void)
+{
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_MIDI_PERIPHERAL);
+    return;
+}
+
+// =============================================================================
+// Class public methods
+// =============================================================================
+
+//     ///////////////////     CONFIGURATION     ////////////////////     //
+bool_t MidiPeripheral::init(cuint8_t address_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("MidiPeripheral::init(cuint8_t)", DEBUG_MIDI_PERIPHERAL);
+
+    // Stop answering and empty the queue
+    twi.disableSlave();
+    this->_isInitialized = false;
+    this->_queueHead = 0;
+    this->_queueTail = 0;
+
+    // Reset register map
+    for(uint8_t i = 0; i < MIDI_PERIPHERAL_REGISTERS; i++) {
+        this->_registers[i] = 0;
+    }
+    this->_registers[MIDI_PERIPHERAL_REG_ID] = MIDI_PERIPHERAL_ID;
+    this->_registers[MIDI_PERIPHERAL_REG_KEY] = 0xFF;
+
+    // Answer as TWI slave; only the channel and command can be written
+    if(!twi.enableSlave(address_p, this->_registers, MIDI_PERIPHERAL_REGISTERS, MIDI_PERIPHERAL_REG_CHANNEL)) {
+        // Returns error
+        this->_lastError = twi.getLastError();
+        debugMessage(this->_lastError, DEBUG_MIDI_PERIPHERAL);
+        return false;
+    }
+    this->_isInitialized = true;
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MIDI_PERIPHERAL);
+    return true;
+}
+
+//     ////////////////////    DATA TRANSFER     ////////////////////     //
+void MidiPeripheral::update(cuint8_t keyPressed_p)
+{
+    // Local variables
+    uint8_t notes[MIDI_PERIPHERAL_REG_CHANNEL - MIDI_PERIPHERAL_REG_NOTES];
+    uint8_t voices;
+
+    // Checks for errors
+    if(!this->_isInitialized) {
+        return;
+    }
+
+    // Build the new values aside
+    voices = voiceTracker.getVoiceCount();
+    voiceTracker.getActiveNotes(this->_registers[MIDI_PERIPHERAL_REG_CHANNEL], notes);
+
+    // Refresh the readable registers only between host transfers; the host
+    // reads them one byte at a time, so a change in the middle of a read
+    // would give it a torn bitmap. A skipped refresh is done on the next call
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if(!twi.isSlaveAddressed()) {
+            this->_registers[MIDI_PERIPHERAL_REG_VOICES] = voices;
+            this->_registers[MIDI_PERIPHERAL_REG_KEY] = keyPressed_p;
+            for(uint8_t i = 0; i < sizeof(notes); i++) {
+                this->_registers[MIDI_PERIPHERAL_REG_NOTES + i] = notes[i];
+            }
+        }
+    }
+
+    return;
+}
+
+void MidiPeripheral::process(void)
+{
+    // Send received commands, oldest first
+    while(this->_queueTail != this->_queueHead) {
+        channelState.sendMessage(this->_commandData[this->_queueTail], 3);
+        this->_queueTail = (this->_queueTail + 1) & (MIDI_PERIPHERAL_QUEUE_SIZE - 1);
+    }
+
+    return;
+}
+
+//     /////////////////     CONTROL AND STATUS     /////////////////     //
+uint16_t MidiPeripheral::getRejectedCount(void)
+{
+    // Local variables
+    uint16_t aux16;
+
+    // Read atomically
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        aux16 = this->_rejectedCount;
+    }
+
+    // Returns value
+    return aux16;
+}
+
+Error MidiPeripheral::getLastError(void)
+{
+    // Returns last error
+    return this->_lastError;
+}
+
+//     /////////////////////     INTERRUPTS    //////////////////////     //
+void MidiPeripheral::receptionHandler(cuint8_t reg_p, cuint8_t size_p)
+{
+    // Local variables
+    uint8_t *command = &this->_registers[MIDI_PERIPHERAL_REG_COMMAND];
+    uint8_t nextHead;
+
+    // Take the command only when its last byte is written
+    if((reg_p + size_p) != MIDI_PERIPHERAL_REGISTERS) {
+        return;
+    }
+
+    // Accept only Note On and Note Off messages
+    nextHead = (this->_queueHead + 1) & (MIDI_PERIPHERAL_QUEUE_SIZE - 1);
+    if(((command[0] & 0xE0) != 0x80) || isBitSet(command[1], 7) || isBitSet(command[2], 7) ||
+            (nextHead == this->_queueTail)) {
+        if(this->_rejectedCount != 0xFFFF) {
+            this->_rejectedCount++;
+        }
+        return;
+    }
+
+    // Queue command
+    this->_commandData[this->_queueHead][0] = command[0];
+    this->_commandData[this->_queueHead][1] = command[1];
+    this->_commandData[this->_queueHead][2] = command[2];
+    this->_queueHead = nextHead;
+
+    return;
+}
+
+// =============================================================================
+// Class private methods
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Class protected methods
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// General public functions definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+void twiSlaveReceptionCallback(cuint8_t reg_p, cuint8_t size_p)
+{
+    midiPeripheral.receptionHandler(reg_p, size_p);
+}
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
@@ -0,0 +1,277 @@
+//!
+//! \file           midiPeripheral.hpp
+//! \brief          I2C register map to control the board from a host
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Makes the board an I2C peripheral: a host controller on the
+//!                     TWI bus reads the sounding notes and the keypad state
+//!                     and writes note commands through a register map. The
+//!                     TWI keeps working as master for the other devices.
+//!
+//!                     | Register    | Size | Access | Content                 |
+//!                     |-------------|------|--------|-------------------------|
+//!                     | 0x00        | 1    | R      | Identification (0x4D)   |
+//!                     | 0x01        | 1    | R      | Number of sounding notes|
+//!                     | 0x02        | 1    | R      | Key pressed, or 0xFF    |
+//!                     | 0x03 - 0x12 | 16   | R      | Sounding notes bitmap   |
+//!                     |             |      |        | of the selected channel |
+//!                     | 0x13        | 1    | R/W    | Selected channel        |
+//!                     | 0x14 - 0x16 | 3    | R/W    | Note command (status,   |
+//!                     |             |      |        | pitch, velocity)        |
+//!
+//!                     A note command is a Note On or Note Off message; it is
+//!                     taken when the write reaches register 0x16, and sent
+//!                     from the main loop. Registers auto-increment, so a
+//!                     whole command is a single 4-byte write.
+//!
+
+// =============================================================================
+// Include guard (START)
+// =============================================================================
+
+#ifndef __MIDI_PERIPHERAL_HPP
+#define __MIDI_PERIPHERAL_HPP                   2304
+
+// =============================================================================
+// Dependencies
+// =============================================================================
+
+//     /////////////////     GLOBAL DEFINITIONS FILE    /////////////////     //
+#include "../funsape/globalDefines.hpp"
+#if !defined(__GLOBAL_DEFINES_HPP)
+#   error "Global definitions file is corrupted!"
+#elif __GLOBAL_DEFINES_HPP != __MIDI_PERIPHERAL_HPP
+#   error "Version mismatch between file header and global definitions file!"
+#endif
+
+//     //////////////////     LIBRARY DEPENDENCIES     //////////////////     //
+#include "../funsape/peripheral/twi.hpp"
+#if !defined(__TWI_HPP)
+#   error "Header file (twi.hpp) is corrupted!"
+#elif __TWI_HPP != __MIDI_PERIPHERAL_HPP
+#   error "Version mismatch between header file and library dependency (twi.hpp)!"
+#endif
+
+#include "channelState.hpp"
+#if !defined(__CHANNEL_STATE_HPP)
+#   error "Header file (channelState.hpp) is corrupted!"
+#elif __CHANNEL_STATE_HPP != __MIDI_PERIPHERAL_HPP
+#   error "Version mismatch between header file and library dependency (channelState.hpp)!"
+#endif
+
+#include "voiceTracker.hpp"
+#if !defined(__VOICE_TRACKER_HPP)
+#   error "Header file (voiceTracker.hpp) is corrupted!"
+#elif __VOICE_TRACKER_HPP != __MIDI_PERIPHERAL_HPP
+#   error "Version mismatch between header file and library dependency (voiceTracker.hpp)!"
+#endif
+
+// =============================================================================
+// Undefining previous definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Constant definitions
+// =============================================================================
+
+#ifndef MIDI_PERIPHERAL_ADDRESS
+//!
+//! \brief          Default 7-bit address of the peripheral
+//!
+#   define MIDI_PERIPHERAL_ADDRESS      0x30
+#endif
+
+#ifndef MIDI_PERIPHERAL_QUEUE_SIZE
+//!
+//! \brief          Number of note commands held until process() is called
+//!                     (must be a power of two)
+//!
+#   define MIDI_PERIPHERAL_QUEUE_SIZE   4
+#endif
+
+#if (MIDI_PERIPHERAL_QUEUE_SIZE & (MIDI_PERIPHERAL_QUEUE_SIZE - 1)) != 0
+#   error "MIDI_PERIPHERAL_QUEUE_SIZE must be a power of two!"
+#endif
+
+//!
+//! \brief          Register map layout
+//!
+#define MIDI_PERIPHERAL_REG_ID          0x00
+#define MIDI_PERIPHERAL_REG_VOICES      0x01
+#define MIDI_PERIPHERAL_REG_KEY         0x02
+#define MIDI_PERIPHERAL_REG_NOTES       0x03
+#define MIDI_PERIPHERAL_REG_CHANNEL     0x13
+#define MIDI_PERIPHERAL_REG_COMMAND     0x14
+#define MIDI_PERIPHERAL_REGISTERS       0x17
+
+//!
+//! \brief          Value of the identification register
+//!
+#define MIDI_PERIPHERAL_ID              0x4D
+
+// =============================================================================
+// New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// MidiPeripheral Class
+// =============================================================================
+
+//!
+//! \brief          MidiPeripheral class
+//! \details        The register map is answered by the TWI interrupt. The
+//!                     readable registers are refreshed by update(), and the
+//!                     note commands are sent by process(); both must be
+//!                     called periodically from the main loop. The TWI must
+//!                     be initialized before init() is called, and global
+//!                     interrupts must be enabled by the user.
+//!
+class MidiPeripheral
+{
+    // -------------------------------------------------------------------------
+    // Constructors ------------------------------------------------------------
+public:
+    //!
+    //! \brief      MidiPeripheral class constructor
+    //! \details    Creates a MidiPeripheral object
+    //!
+    MidiPeripheral(
+            void
+    );
+
+    //!
+    //! \brief      MidiPeripheral class destructor
+    //! \details    Destroys a MidiPeripheral object
+    //!
+    ~MidiPeripheral(
+            void
+    );
+
+    // -------------------------------------------------------------------------
+    // Methods -----------------------------------------------------------------
+public:
+    //     ///////////////////     CONFIGURATION     ////////////////////     //
+
+    //!
+    //! \brief      Initializes the peripheral
+    //! \details    Clears the register map and enables the TWI slave mode.
+    //! \param      address_p           Own 7-bit address (0x08 to 0x77)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t init(
+            cuint8_t address_p          = MIDI_PERIPHERAL_ADDRESS
+    );
+
+    //     ////////////////////    DATA TRANSFER     ////////////////////     //
+
+    //!
+    //! \brief      Refreshes the readable registers
+    //! \details    Copies the sounding notes of the selected channel and the
+    //!                 key state to the register map. The copy is skipped
+    //!                 while the host is addressing the peripheral, so that
+    //!                 a read never returns a partly updated bitmap.
+    //! \param      keyPressed_p        Key pressed, or 0xFF if none
+    //!
+    void update(
+            cuint8_t keyPressed_p
+    );
+
+    //!
+    //! \brief      Sends the received note commands
+    //! \details    Sends each note command written by the host since the
+    //!                 last call, through the channel state table.
+    //!
+    void process(
+            void
+    );
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+
+    //!
+    //! \brief      Returns the number of rejected commands
+    //! \details    Returns the number of commands discarded because they
+    //!                 were not a valid note message or the queue was full.
+    //!                 The counter saturates at 0xFFFF.
+    //! \return     uint16_t            Rejected commands
+    //!
+    uint16_t getRejectedCount(
+            void
+    );
+
+    //!
+    //! \brief      Returns the last error
+    //! \details    Returns the last error.
+    //! \return     Error               Error status of the last operation
+    //!
+    Error getLastError(
+            void
+    );
+
+    //     /////////////////////     INTERRUPTS    //////////////////////     //
+
+    //!
+    //! \brief      Register write handler
+    //! \details    Queues the note command when the host writes it. Called
+    //!                 from the TWI interrupt.
+    //! \param      reg_p               First register written
+    //! \param      size_p              Number of registers written
+    //!
+    void receptionHandler(
+            cuint8_t reg_p,
+            cuint8_t size_p
+    );
+
+protected:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Properties --------------------------------------------------------------
+private:
+    //     ////////////////////    DATA TRANSFER     ////////////////////     //
+    uint8_t             _registers[MIDI_PERIPHERAL_REGISTERS];
+    uint8_t             _commandData[MIDI_PERIPHERAL_QUEUE_SIZE][3];
+    vuint8_t            _queueHead;
+    vuint8_t            _queueTail;
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+    bool_t              _isInitialized                  : 1;
+    vuint16_t           _rejectedCount;
+    Error               _lastError;
+}; // class MidiPeripheral
+
+// =============================================================================
+// MidiPeripheral - Class inline function definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// External global variables
+// =============================================================================
+
+//!
+//! \brief          MIDI peripheral handler object
+//! \details        MIDI peripheral handler object
+//!
+extern MidiPeripheral midiPeripheral;
+
+// =============================================================================
+// Include guard (END)
+// =============================================================================
+
+#endif  // __MIDI_PERIPHERAL_HPP
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
@@ -0,0 +1,419 @@
+//!
+//! \file           motionMapper.cpp
+//! \brief          Accelerometer to MIDI controller mapper
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Accelerometer to MIDI controller mapper
+//!
+
+// =============================================================================
+// System file dependencies
+// =============================================================================
+
+#include "motionMapper.hpp"
+#if !defined(__MOTION_MAPPER_HPP)
+#    error "Header file is corrupted!"
+#elif __MOTION_MAPPER_HPP != 2304
+#    error "Version mismatch between source and header files!"
+#endif
+
+// =============================================================================
+// File exclusive - Constants
+// =============================================================================
+
+#define DEBUG_MOTION_MAPPER             0x1FFF
+
+cuint16_t constNoValue                  = 0xFFFF;   //!< Nothing sent yet
+cuint16_t constBendCenter               = 8192;
+cuint16_t constBendMaximum              = 16383;
+cuint16_t constWindowLength             = 1000;     //!< Byte rate window, in ms
+cuint8_t constMessageSize               = 3;
+cint16_t constOneG                      = 16384;    //!< 1 g, in LSB
+
+// =============================================================================
+// File exclusive - New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// File exclusive - Global variables
+// =============================================================================
+
+MotionMapper motionMapper;
+
+// =============================================================================
+// File exclusive - Macro-functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Class constructors
+// =============================================================================
+
+MotionMapper::MotionMapper(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("MotionMapper::MotionMapper(void)", DEBUG_MOTION_MAPPER);
+
+    // Reset data members
+    this->_channel                      = 0;
+    for(uint8_t i = 0; i < MOTION_MAPPER_TARGETS; i++) {
+        this->_source[i]                = Source::NONE;
+        this->_deadBand[i]              = 0;
+        this->_minInterval[i]           = 0;
+        this->_lastValue[i]             = constNoValue;
+        this->_lastTime[i]              = 0;
+    }
+    this->_inverted                     = 0;
+    this->_windowStart                  = 0;
+    this->_windowBytes                  = 0;
+    this->_restOrientation              = MotionTracker::Orientation::Z_UP;
+    this->_rest[0]                      = 0;
+    this->_rest[1]                      = 0;
+    this->_rest[2]                      = constOneG;
+    this->_isInitialized                = false;
+    this->_byteRate                     = 0;
+    this->_throttledCount               = 0;
+
+    // Returns successfully
+    this->_lastError                    = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MOTION_MAPPER);
+    return;
+}
+
+MotionMapper::~MotionMapper(void)
+{
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_MOTION_MAPPER);
+    return;
+}
+
+// =============================================================================
+// Class public methods
+// =============================================================================
+
+//     ///////////////////     CONFIGURATION     ////////////////////     //
+bool_t MotionMapper::init(cuint8_t channel_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("MotionMapper::init(cuint8_t)", DEBUG_MOTION_MAPPER);
+
+    // Checks for errors
+    if(channel_p > 15) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+        debugMessage(Error::ARGUMENT_VALUE_INVALID, DEBUG_MOTION_MAPPER);
+        return false;
+    }
+
+    // Default mapping
+    this->_channel = channel_p;
+    this->_inverted = 0;
+    this->_source[(uint8_t)Target::MODULATION] = Source::ACCEL_Y;
+    this->_source[(uint8_t)Target::EXPRESSION] = Source::ACCEL_Z;
+    this->_source[(uint8_t)Target::PITCH_BEND] = Source::ACCEL_X;
+    for(uint8_t i = 0; i < MOTION_MAPPER_TARGETS; i++) {
+        this->_deadBand[i] = (i == (uint8_t)Target::PITCH_BEND) ? MOTION_MAPPER_BEND_DEAD_BAND :
+                MOTION_MAPPER_CC_DEAD_BAND;
+        this->_minInterval[i] = MOTION_MAPPER_MIN_INTERVAL;
+        this->_lastValue[i] = constNoValue;
+    }
+    this->_setRest(MotionTracker::Orientation::Z_UP);
+    this->_windowStart = (uint16_t)systemTick.getMilliseconds();
+    this->_windowBytes = 0;
+    this->_byteRate = 0;
+    this->_isInitialized = true;
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MOTION_MAPPER);
+    return true;
+}
+
+bool_t MotionMapper::setMapping(const Target target_p, const Source source_p, cbool_t invert_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("MotionMapper::setMapping(const Target, const Source, cbool_t)", DEBUG_MOTION_MAPPER);
+
+    // Local variables
+    uint8_t index = (uint8_t)target_p;
+
+    // Checks for errors
+    if((index >= MOTION_MAPPER_TARGETS) || ((uint8_t)source_p > (uint8_t)Source::ACCEL_Z)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+        debugMessage(Error::ARGUMENT_VALUE_INVALID, DEBUG_MOTION_MAPPER);
+        return false;
+    }
+
+    // Update data members
+    this->_source[index] = source_p;
+    if(invert_p) {
+        setBit(this->_inverted, index);
+    } else {
+        clrBit(this->_inverted, index);
+    }
+    this->_lastValue[index] = constNoValue;
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MOTION_MAPPER);
+    return true;
+}
+
+bool_t MotionMapper::setLimits(const Target target_p, cuint16_t deadBand_p, cuint16_t minInterval_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("MotionMapper::setLimits(const Target, cuint16_t, cuint16_t)", DEBUG_MOTION_MAPPER);
+
+    // Local variables
+    uint8_t index = (uint8_t)target_p;
+
+    // Checks for errors
+    if((index >= MOTION_MAPPER_TARGETS) || (minInterval_p > 0x7FFF)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+        debugMessage(Error::ARGUMENT_VALUE_INVALID, DEBUG_MOTION_MAPPER);
+        return false;
+    }
+
+    // Update data members
+    this->_deadBand[index] = deadBand_p;
+    this->_minInterval[index] = minInterval_p;
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_MOTION_MAPPER);
+    return true;
+}
+
+//     ////////////////////    DATA TRANSFER     ////////////////////     //
+void MotionMapper::update(void)
+{
+    // Local variables
+    int16_t acceleration[3];
+    MotionTracker::Orientation orientation;
+    uint8_t axis;
+    uint16_t now;
+    uint16_t value;
+    uint16_t last;
+    uint16_t maximum;
+    uint16_t difference;
+
+    // Checks for errors
+    if(!this->_isInitialized) {
+        return;
+    }
+
+    // Close the byte rate window
+    now = (uint16_t)systemTick.getMilliseconds();
+    if((uint16_t)(now - this->_windowStart) >= constWindowLength) {
+        this->_byteRate = this->_windowBytes;
+        this->_windowBytes = 0;
+        this->_windowStart += constWindowLength;
+        if((uint16_t)(now - this->_windowStart) >= constWindowLength) {
+            // Idle for more than a window
+            this->_byteRate = 0;
+            this->_windowStart = now;
+        }
+    }
+
+    // Follow the rest position (kept while the orientation is unknown)
+    orientation = motionTracker.getOrientation();
+    if((orientation != MotionTracker::Orientation::UNKNOWN) && (orientation != this->_restOrientation)) {
+        this->_setRest(orientation);
+    }
+
+    // Update targets, relative to the rest position
+    motionTracker.getFiltered(&acceleration[0], &acceleration[1], &acceleration[2]);
+    for(uint8_t i = 0; i < MOTION_MAPPER_TARGETS; i++) {
+        if(this->_source[i] == Source::NONE) {
+            continue;
+        }
+        axis = (uint8_t)this->_source[i] - 1;
+        value = this->_mapValue(i, (int32_t)acceleration[axis] - this->_rest[axis]);
+        last = this->_lastValue[i];
+
+        // Change-only, outside the dead-band or reaching an end point
+        if(value == last) {
+            continue;
+        }
+        if(last != constNoValue) {
+            maximum = (i == (uint8_t)Target::PITCH_BEND) ? constBendMaximum : 127;
+            difference = (value > last) ? (value - last) : (last - value);
+            if((difference <= this->_deadBand[i]) && (value != 0) && (value != maximum) &&
+                            ((i != (uint8_t)Target::PITCH_BEND) || (value != constBendCenter))) {
+                continue;
+            }
+            if((uint16_t)(now - this->_lastTime[i]) < this->_minInterval[i]) {
+                continue;
+            }
+        }
+
+        // Byte budget
+        if((this->_windowBytes + constMessageSize) > MOTION_MAPPER_MAX_BYTE_RATE) {
+            if(this->_throttledCount != 0xFFFF) {
+                this->_throttledCount++;
+            }
+            continue;
+        }
+
+        // Send message
+        if(this->_send(i, value)) {
+            this->_lastValue[i] = value;
+            this->_lastTime[i] = now;
+            this->_windowBytes += constMessageSize;
+        }
+    }
+
+    return;
+}
+
+//     /////////////////     CONTROL AND STATUS     /////////////////     //
+uint16_t MotionMapper::getByteRate(void)
+{
+    // Returns value
+    return this->_byteRate;
+}
+
+uint16_t MotionMapper::getThrottledCount(void)
+{
+    // Returns value
+    return this->_throttledCount;
+}
+
+void MotionMapper::clearCounters(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("MotionMapper::clearCounters(void)", DEBUG_MOTION_MAPPER);
+
+    // Reset data members
+    this->_throttledCount               = 0;
+
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_MOTION_MAPPER);
+    return;
+}
+
+Error MotionMapper::getLastError(void)
+{
+    // Returns last error
+    return this->_lastError;
+}
+
+// =============================================================================
+// Class private methods
+// =============================================================================
+
+//     ////////////////////    DATA TRANSFER     ////////////////////     //
+void MotionMapper::_setRest(const MotionTracker::Orientation orientation_p)
+{
+    // Gravity along the axis pointing up
+    this->_rest[0] = 0;
+    this->_rest[1] = 0;
+    this->_rest[2] = 0;
+    switch(orientation_p) {
+    case MotionTracker::Orientation::X_UP:      this->_rest[0] = constOneG;     break;
+    case MotionTracker::Orientation::X_DOWN:    this->_rest[0] = -constOneG;    break;
+    case MotionTracker::Orientation::Y_UP:      this->_rest[1] = constOneG;     break;
+    case MotionTracker::Orientation::Y_DOWN:    this->_rest[1] = -constOneG;    break;
+    case MotionTracker::Orientation::Z_DOWN:    this->_rest[2] = -constOneG;    break;
+    default:                                    this->_rest[2] = constOneG;     break;
+    }
+    this->_restOrientation = orientation_p;
+
+    return;
+}
+
+uint16_t MotionMapper::_mapValue(cuint8_t target_p, cint32_t acceleration_p)
+{
+    // Local variables
+    int32_t value = acceleration_p;
+
+    // Scale 1 g (16384 LSB) from the rest position to the target range
+    if(isBitSet(this->_inverted, target_p)) {
+        value = -value;
+    }
+    if(target_p == (uint8_t)Target::PITCH_BEND) {
+        value = (value + 16384) >> 1;
+        if(value < 0) {
+            value = 0;
+        } else if(value > constBendMaximum) {
+            value = constBendMaximum;
+        }
+        // Snap to the center inside the dead-band
+        if((value > (int32_t)constBendCenter - this->_deadBand[target_p]) &&
+                        (value < (int32_t)constBendCenter + this->_deadBand[target_p])) {
+            value = constBendCenter;
+        }
+    } else if(target_p == (uint8_t)Target::EXPRESSION) {
+        // Full at rest, down to the floor when tilted
+        value = 127 + (value >> 7);
+        if(value < MOTION_MAPPER_EXPRESSION_FLOOR) {
+            value = MOTION_MAPPER_EXPRESSION_FLOOR;
+        } else if(value > 127) {
+            value = 127;
+        }
+    } else {
+        value >>= 7;
+        if(value < 0) {
+            value = 0;
+        } else if(value > 127) {
+            value = 127;
+        }
+    }
+
+    return (uint16_t)value;
+}
+
+bool_t MotionMapper::_send(cuint8_t target_p, cuint16_t value_p)
+{
+    // Local variables
+    bool_t result;
+
+    // Send message
+    switch((Target)target_p) {
+    case Target::MODULATION:
+        result = channelState.setController(this->_channel, (uint8_t)ChannelState::Controller::MODULATION,
+                        (uint8_t)value_p);
+        break;
+    case Target::EXPRESSION:
+        result = channelState.setController(this->_channel, (uint8_t)ChannelState::Controller::EXPRESSION,
+                        (uint8_t)value_p);
+        break;
+    default:
+        result = channelState.setPitchBend(this->_channel, value_p);
+        break;
+    }
+    if(!result) {
+        this->_lastError = channelState.getLastError();
+        debugMessage(this->_lastError, DEBUG_MOTION_MAPPER);
+    }
+
+    return result;
+}
+
+// =============================================================================
+// Class protected methods
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// General public functions definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
@@ -0,0 +1,358 @@
+//!
+//! \file           motionMapper.hpp
+//! \brief          Accelerometer to MIDI controller mapper
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Maps the filtered acceleration of the motion tracker to
+//!                     Modulation (CC1), Expression (CC11) and 14-bit Pitch
+//!                     Bend messages. Each target has a dead-band and a
+//!                     minimum interval between messages, and only values
+//!                     that changed are sent. The whole stream is also capped
+//!                     at MOTION_MAPPER_MAX_BYTE_RATE bytes per second, so the
+//!                     continuous controllers always leave most of the
+//!                     31250 baud link (3125 bytes per second) to the notes.
+//!
+
+// =============================================================================
+// Include guard (START)
+// =============================================================================
+
+#ifndef __MOTION_MAPPER_HPP
+#define __MOTION_MAPPER_HPP                     2304
+
+// =============================================================================
+// Dependencies
+// =============================================================================
+
+//     /////////////////     GLOBAL DEFINITIONS FILE    /////////////////     //
+#include "../funsape/globalDefines.hpp"
+#if !defined(__GLOBAL_DEFINES_HPP)
+#   error "Global definitions file is corrupted!"
+#elif __GLOBAL_DEFINES_HPP != __MOTION_MAPPER_HPP
+#   error "Version mismatch between file header and global definitions file!"
+#endif
+
+//     //////////////////     LIBRARY DEPENDENCIES     //////////////////     //
+#include "channelState.hpp"
+#if !defined(__CHANNEL_STATE_HPP)
+#   error "Header file (channelState.hpp) is corrupted!"
+#elif __CHANNEL_STATE_HPP != __MOTION_MAPPER_HPP
+#   error "Version mismatch between header file and library dependency (channelState.hpp)!"
+#endif
+
+#include "motionTracker.hpp"
+#if !defined(__MOTION_TRACKER_HPP)
+#   error "Header file (motionTracker.hpp) is corrupted!"
+#elif __MOTION_TRACKER_HPP != __MOTION_MAPPER_HPP
+#   error "Version mismatch between header file and library dependency (motionTracker.hpp)!"
+#endif
+
+#include "../funsape/util/systemTick.hpp"
+#if !defined(__SYSTEM_TICK_HPP)
+#   error "Header file (systemTick.hpp) is corrupted!"
+#elif __SYSTEM_TICK_HPP != __MOTION_MAPPER_HPP
+#   error "Version mismatch between header file and library dependency (systemTick.hpp)!"
+#endif
+
+// =============================================================================
+// Undefining previous definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Constant definitions
+// =============================================================================
+
+#ifndef MOTION_MAPPER_CC_DEAD_BAND
+//!
+//! \brief          Default dead-band of the controllers (0 to 127)
+//!
+#   define MOTION_MAPPER_CC_DEAD_BAND           2
+#endif
+
+#ifndef MOTION_MAPPER_BEND_DEAD_BAND
+//!
+//! \brief          Default dead-band of the pitch bend (0 to 16383)
+//!
+#   define MOTION_MAPPER_BEND_DEAD_BAND         64
+#endif
+
+#ifndef MOTION_MAPPER_MIN_INTERVAL
+//!
+//! \brief          Default minimum interval between messages of a target, in ms
+//!
+#   define MOTION_MAPPER_MIN_INTERVAL           20
+#endif
+
+#ifndef MOTION_MAPPER_MAX_BYTE_RATE
+//!
+//! \brief          Maximum number of bytes sent per second by the mapper
+//!
+#   define MOTION_MAPPER_MAX_BYTE_RATE          300
+#endif
+
+#ifndef MOTION_MAPPER_EXPRESSION_FLOOR
+//!
+//! \brief          Lowest expression value sent by the mapper (0 to 127)
+//!
+#   define MOTION_MAPPER_EXPRESSION_FLOOR       32
+#endif
+
+#if MOTION_MAPPER_EXPRESSION_FLOOR > 127
+#   error "MOTION_MAPPER_EXPRESSION_FLOOR must be between 0 and 127!"
+#endif
+
+//!
+//! \brief          Number of mapping targets
+//!
+#define MOTION_MAPPER_TARGETS           3
+
+// =============================================================================
+// New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// MotionMapper Class
+// =============================================================================
+
+//!
+//! \brief          MotionMapper class
+//! \details        The sources are taken relative to the rest position, that
+//!                     is, with the gravity of the last known orientation
+//!                     removed, so every orientation starts from the same
+//!                     sound. From the rest position, the modulation uses the
+//!                     positive half of the source axis (0 g to 1 g gives 0
+//!                     to 127), the expression starts at 127 and follows the
+//!                     negative half down to MOTION_MAPPER_EXPRESSION_FLOOR,
+//!                     so the instrument is never silenced, and the pitch
+//!                     bend uses the whole axis (-1 g to 1 g gives 0 to
+//!                     16383) and snaps to the center inside the dead-band.
+//!                     Values held back by the interval or the byte budget
+//!                     are sent as soon as allowed. The messages go through
+//!                     the channel state table; the system timebase provides
+//!                     the time base.
+//!
+class MotionMapper
+{
+    // -------------------------------------------------------------------------
+    // New data types ----------------------------------------------------------
+public:
+    //!
+    //! \brief      Mapping targets
+    //!
+    enum class Target : uint8_t {
+        MODULATION                      = 0,    //!< Control Change 1
+        EXPRESSION                      = 1,    //!< Control Change 11
+        PITCH_BEND                      = 2     //!< Pitch Bend
+    };
+
+    //!
+    //! \brief      Mapping sources
+    //!
+    enum class Source : uint8_t {
+        NONE                            = 0,    //!< Target disabled
+        ACCEL_X                         = 1,    //!< Filtered X axis acceleration
+        ACCEL_Y                         = 2,    //!< Filtered Y axis acceleration
+        ACCEL_Z                         = 3     //!< Filtered Z axis acceleration
+    };
+
+    // -------------------------------------------------------------------------
+    // Constructors ------------------------------------------------------------
+public:
+    //!
+    //! \brief      MotionMapper class constructor
+    //! \details    Creates a MotionMapper object
+    //!
+    MotionMapper(
+            void
+    );
+
+    //!
+    //! \brief      MotionMapper class destructor
+    //! \details    Destroys a MotionMapper object
+    //!
+    ~MotionMapper(
+            void
+    );
+
+    // -------------------------------------------------------------------------
+    // Methods -----------------------------------------------------------------
+public:
+    //     ///////////////////     CONFIGURATION     ////////////////////     //
+
+    //!
+    //! \brief      Initializes the mapper
+    //! \details    Sets the MIDI channel and restores the default mapping:
+    //!                 Y axis to modulation, Z axis to expression and X axis
+    //!                 to pitch bend, with the default dead-bands and
+    //!                 intervals. The rest position is Z axis up until the
+    //!                 motion tracker reports another orientation.
+    //! \param      channel_p           MIDI channel (0 to 15)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t init(
+            cuint8_t channel_p
+    );
+
+    //!
+    //! \brief      Sets the source of a target
+    //! \details    Sets the source of a target. The target is sent again on
+    //!                 the next update.
+    //! \param      target_p            Mapping target
+    //! \param      source_p            Mapping source (Source::NONE disables
+    //!                                     the target)
+    //! \param      invert_p            Inverts the source axis
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t setMapping(
+            const Target target_p,
+            const Source source_p,
+            cbool_t invert_p = false
+    );
+
+    //!
+    //! \brief      Sets the rate limits of a target
+    //! \details    Sets the rate limits of a target.
+    //! \param      target_p            Mapping target
+    //! \param      deadBand_p          Smallest change sent, in units of the
+    //!                                     target (the end points are always
+    //!                                     reached)
+    //! \param      minInterval_p       Minimum interval between messages, in
+    //!                                     ms
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t setLimits(
+            const Target target_p,
+            cuint16_t deadBand_p,
+            cuint16_t minInterval_p
+    );
+
+    //     ////////////////////    DATA TRANSFER     ////////////////////     //
+
+    //!
+    //! \brief      Updates the controllers
+    //! \details    Maps the current motion tracker output and sends the
+    //!                 targets allowed by the dead-band, the interval and the
+    //!                 byte budget. Must be called after every motion tracker
+    //!                 update.
+    //!
+    void update(
+            void
+    );
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+
+    //!
+    //! \brief      Returns the generated byte rate
+    //! \details    Returns the number of bytes sent by the mapper during the
+    //!                 last complete second.
+    //! \return     uint16_t            Bytes per second
+    //!
+    uint16_t getByteRate(
+            void
+    );
+
+    //!
+    //! \brief      Returns the number of throttled messages
+    //! \details    Returns the number of messages delayed because the byte
+    //!                 budget was used up. The counter saturates at 0xFFFF.
+    //! \return     uint16_t            Throttled messages
+    //!
+    uint16_t getThrottledCount(
+            void
+    );
+
+    //!
+    //! \brief      Clears the counters
+    //! \details    Clears the throttled messages counter.
+    //!
+    void clearCounters(
+            void
+    );
+
+    //!
+    //! \brief      Returns the last error
+    //! \details    Returns the last error.
+    //! \return     Error               Error status of the last operation
+    //!
+    Error getLastError(
+            void
+    );
+
+private:
+    //     ////////////////////    DATA TRANSFER     ////////////////////     //
+    void _setRest(
+            const MotionTracker::Orientation orientation_p
+    );
+    uint16_t _mapValue(
+            cuint8_t target_p,
+            cint32_t acceleration_p
+    );
+    bool_t _send(
+            cuint8_t target_p,
+            cuint16_t value_p
+    );
+
+protected:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Properties --------------------------------------------------------------
+private:
+    //     ///////////////////     CONFIGURATION     ////////////////////     //
+    uint8_t             _channel;
+    Source              _source[MOTION_MAPPER_TARGETS];
+    uint8_t             _inverted;              // One bit per target
+    uint16_t            _deadBand[MOTION_MAPPER_TARGETS];
+    uint16_t            _minInterval[MOTION_MAPPER_TARGETS];
+
+    //     ////////////////////    DATA TRANSFER     ////////////////////     //
+    uint16_t            _lastValue[MOTION_MAPPER_TARGETS];
+    uint16_t            _lastTime[MOTION_MAPPER_TARGETS];
+    uint16_t            _windowStart;
+    uint16_t            _windowBytes;
+    MotionTracker::Orientation _restOrientation;
+    int16_t             _rest[3];               // Gravity at rest, per axis
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+    bool_t              _isInitialized                  : 1;
+    uint16_t            _byteRate;
+    uint16_t            _throttledCount;
+    Error               _lastError;
+}; // class MotionMapper
+
+// =============================================================================
+// MotionMapper - Class inline function definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// External global variables
+// =============================================================================
+
+//!
+//! \brief          Motion mapper handler object
+//! \details        Motion mapper handler object
+//!
+extern MotionMapper motionMapper;
+
+// =============================================================================
+// Include guard (END)
+// =============================================================================
+
+#endif  // __MOTION_MAPPER_HPP
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
@@ -0,0 +1,422 @@
+//!
+//! \file           motionTracker.cpp
+//! \brief          Accelerometer filtering and tilt/gesture detection
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Accelerometer filtering and tilt/gesture detection
+//!
+
+// =============================================================================
+// System file dependencies
+// =============================================================================
+
+#include "motionTracker.hpp"
+#if !defined(__MOTION_TRACKER_HPP)
+#    error "Header file is corrupted!"
+#elif __MOTION_TRACKER_HPP != 2304
+#    error "Version mismatch between source and header files!"
+#endif
+
+#include <avr/pgmspace.h>
+
+// =============================================================================
+// File exclusive - Constants
+// =============================================================================
+
+#define DEBUG_MOTION_TRACKER            0x1FFF
+
+//!
+//! \brief          Arc tangent of i/16, for i from 0 to 16, in tenths of degree
+//!
+const uint16_t constAtanTable[17] PROGMEM = {
+    0, 36, 71, 106, 140, 174, 206, 236, 266, 294, 320, 345, 369, 391, 412, 432, 450
+};
+
+// =============================================================================
+// File exclusive - New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// File exclusive - Global variables
+// =============================================================================
+
+MotionTracker motionTracker;
+
+// =============================================================================
+// File exclusive - Macro-functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Class constructors
+// =============================================================================
+
+MotionTracker::MotionTracker(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("MotionTracker::MotionTracker(void)", DEBUG_MOTION_TRACKER);
+
+    // Reset data members
+    this->_nextSample                   = 0;
+    this->_missedCount                  = 0;
+    this->reset();
+
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_MOTION_TRACKER);
+    return;
+}
+
+MotionTracker::~MotionTracker(void)
+{
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_MOTION_TRACKER);
+    return;
+}
+
+// =============================================================================
+// Class public methods
+// =============================================================================
+
+//     ///////////////////     CONFIGURATION     ////////////////////     //
+void MotionTracker::reset(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("MotionTracker::reset(void)", DEBUG_MOTION_TRACKER);
+
+    // Reset data members
+    for(uint8_t i = 0; i < 3; i++) {
+        this->_state[i]                 = 0;
+        this->_filtered[i]              = 0;
+    }
+    this->_isPrimed                     = false;
+    this->_orientation                  = Orientation::UNKNOWN;
+    this->_peakLength                   = 0;
+    this->_peakDirection                = 0;
+    this->_peakCount                    = 0;
+    this->_windowLength                 = 0;
+    this->_holdoff                      = 0;
+    this->_isTapCandidate               = false;
+    this->_eventHead                    = 0;
+    this->_eventTail                    = 0;
+
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_MOTION_TRACKER);
+    return;
+}
+
+//     ////////////////////    DATA TRANSFER     ////////////////////     //
+bool_t MotionTracker::isSampleDue(void)
+{
+    // Local variables
+    uint16_t now = (uint16_t)systemTick.getMilliseconds();
+
+    // Wait for the sample instant
+    if((int16_t)(now - this->_nextSample) < 0) {
+        return false;
+    }
+
+    // Schedule the next sample
+    this->_nextSample += MOTION_TRACKER_SAMPLE_PERIOD;
+    if((int16_t)(now - this->_nextSample) >= 0) {
+        // Fell behind - restart the schedule
+        if(this->_missedCount != 0xFFFF) {
+            this->_missedCount++;
+        }
+        this->_nextSample = now + MOTION_TRACKER_SAMPLE_PERIOD;
+    }
+
+    return true;
+}
+
+void MotionTracker::update(cint16_t x_p, cint16_t y_p, cint16_t z_p)
+{
+    // Local variables
+    int16_t sample[3] = {x_p, y_p, z_p};
+    int16_t highPass;
+    uint16_t magnitude = 0;
+    uint16_t largest = 0;
+    uint8_t direction = 0;
+
+    // Seed the filters with the first sample
+    if(!this->_isPrimed) {
+        for(uint8_t i = 0; i < 3; i++) {
+            this->_state[i] = (int32_t)sample[i] << MOTION_TRACKER_FILTER_SHIFT;
+            this->_filtered[i] = sample[i];
+        }
+        this->_isPrimed = true;
+    }
+
+    // Low-pass filter; high-pass magnitude in units of 16 LSB
+    for(uint8_t i = 0; i < 3; i++) {
+        this->_state[i] += (int32_t)sample[i] - this->_filtered[i];
+        this->_filtered[i] = (int16_t)(this->_state[i] >> MOTION_TRACKER_FILTER_SHIFT);
+        highPass = (int16_t)(((int32_t)sample[i] - this->_filtered[i]) >> 4);
+        if(highPass < 0) {
+            highPass = -highPass;
+            if((uint16_t)highPass > largest) {
+                direction = 2 * i + 1;
+            }
+        } else if((uint16_t)highPass > largest) {
+            direction = 2 * i;
+        }
+        if((uint16_t)highPass > largest) {
+            largest = (uint16_t)highPass;
+        }
+        magnitude += (uint16_t)highPass;
+    }
+
+    // Detectors
+    this->_updateOrientation();
+    this->_updateGestures(magnitude, direction);
+
+    return;
+}
+
+bool_t MotionTracker::getEvent(Event *event_p)
+{
+    // Checks for errors
+    if(this->_eventHead == this->_eventTail) {
+        return false;
+    }
+
+    // Pop event
+    *event_p = this->_eventQueue[this->_eventTail];
+    this->_eventTail = (this->_eventTail + 1) & (MOTION_TRACKER_EVENT_QUEUE_SIZE - 1);
+
+    return true;
+}
+
+//     /////////////////     CONTROL AND STATUS     /////////////////     //
+void MotionTracker::getFiltered(int16_t *x_p, int16_t *y_p, int16_t *z_p)
+{
+    // Returns values
+    *x_p = this->_filtered[0];
+    *y_p = this->_filtered[1];
+    *z_p = this->_filtered[2];
+
+    return;
+}
+
+void MotionTracker::getTilt(int16_t *roll_p, int16_t *pitch_p)
+{
+    // Local variables
+    int32_t y = this->_filtered[1];
+    int32_t z = this->_filtered[2];
+    uint32_t square = (uint32_t)(y * y) + (uint32_t)(z * z);
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+
+    // Integer square root of y^2 + z^2
+    while(bit > square) {
+        bit >>= 2;
+    }
+    while(bit != 0) {
+        if(square >= root + bit) {
+            square -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    // Returns values
+    *roll_p = this->_atan2(y, z);
+    *pitch_p = this->_atan2(-(int32_t)this->_filtered[0], (int32_t)root);
+
+    return;
+}
+
+uint16_t MotionTracker::getMissedCount(void)
+{
+    // Returns value
+    return this->_missedCount;
+}
+
+// =============================================================================
+// Class private methods
+// =============================================================================
+
+//     ////////////////////    DATA TRANSFER     ////////////////////     //
+void MotionTracker::_updateOrientation(void)
+{
+    // Local variables
+    Orientation orientation = Orientation::UNKNOWN;
+    int16_t value;
+    int16_t largest = MOTION_TRACKER_ENTER_THRESHOLD - 1;
+
+    // Keep the current orientation while its axis is above the exit threshold
+    switch(this->_orientation) {
+    case Orientation::Z_UP:     value = this->_filtered[2];     break;
+    case Orientation::Z_DOWN:   value = -this->_filtered[2];    break;
+    case Orientation::Y_UP:     value = this->_filtered[1];     break;
+    case Orientation::Y_DOWN:   value = -this->_filtered[1];    break;
+    case Orientation::X_UP:     value = this->_filtered[0];     break;
+    case Orientation::X_DOWN:   value = -this->_filtered[0];    break;
+    default:                    value = 0;                      break;
+    }
+    if(value >= MOTION_TRACKER_EXIT_THRESHOLD) {
+        return;
+    }
+
+    // Look for the axis closest to the gravity above the enter threshold
+    for(uint8_t i = 0; i < 3; i++) {
+        value = this->_filtered[i];
+        if(value > largest) {
+            largest = value;
+            orientation = (Orientation)(5 - 2 * i);
+        } else if(value < -largest) {
+            largest = -value;
+            orientation = (Orientation)(6 - 2 * i);
+        }
+    }
+
+    // Queue event only on change
+    if((orientation != Orientation::UNKNOWN) && (orientation != this->_orientation)) {
+        this->_orientation = orientation;
+        this->_pushEvent(Event::ORIENTATION_CHANGED);
+    }
+
+    return;
+}
+
+void MotionTracker::_updateGestures(cuint16_t magnitude_p, cuint8_t direction_p)
+{
+    // Ignore the ringing after a gesture
+    if(this->_holdoff != 0) {
+        this->_holdoff--;
+        return;
+    }
+
+    // Peaks above the shake threshold; a reversal starts a new peak
+    if(magnitude_p >= MOTION_TRACKER_SHAKE_THRESHOLD) {
+        if((this->_peakLength == 0) || (direction_p != this->_peakDirection)) {
+            this->_peakDirection = direction_p;
+            this->_peakLength = 0;
+            if(this->_peakCount == 0) {
+                this->_windowLength = 0;
+            }
+            this->_peakCount++;
+            this->_isTapCandidate = false;
+        }
+        if(this->_peakLength != 0xFF) {
+            this->_peakLength++;
+        }
+        if((this->_peakCount == 1) && (magnitude_p >= MOTION_TRACKER_TAP_THRESHOLD)) {
+            this->_isTapCandidate = true;
+        }
+    } else if(this->_peakLength != 0) {
+        // End of peak - a single short and strong peak may be a tap
+        if(this->_peakLength > MOTION_TRACKER_TAP_LENGTH) {
+            this->_isTapCandidate = false;
+        }
+        this->_peakLength = 0;
+    }
+    if(this->_peakCount == 0) {
+        return;
+    }
+
+    // Classify the peaks in the window
+    this->_windowLength++;
+    if(this->_peakCount >= MOTION_TRACKER_SHAKE_COUNT) {
+        this->_pushEvent(Event::SHAKE);
+    } else if(this->_isTapCandidate && (this->_peakLength == 0) &&
+                    (this->_windowLength >= MOTION_TRACKER_TAP_QUIET)) {
+        this->_pushEvent(Event::TAP);
+    } else {
+        if(this->_windowLength >= MOTION_TRACKER_SHAKE_WINDOW) {
+            this->_peakCount = 0;
+            this->_isTapCandidate = false;
+        }
+        return;
+    }
+
+    // Gesture found - restart detector
+    this->_peakCount = 0;
+    this->_peakLength = 0;
+    this->_isTapCandidate = false;
+    this->_holdoff = MOTION_TRACKER_HOLDOFF;
+
+    return;
+}
+
+void MotionTracker::_pushEvent(const Event event_p)
+{
+    // Local variables
+    uint8_t next = (this->_eventHead + 1) & (MOTION_TRACKER_EVENT_QUEUE_SIZE - 1);
+
+    // Drop event if the queue is full
+    if(next == this->_eventTail) {
+        return;
+    }
+    this->_eventQueue[this->_eventHead] = event_p;
+    this->_eventHead = next;
+
+    return;
+}
+
+int16_t MotionTracker::_atan2(int32_t y_p, int32_t x_p)
+{
+    // Local variables
+    uint32_t absY = (y_p < 0) ? -y_p : y_p;
+    uint32_t absX = (x_p < 0) ? -x_p : x_p;
+    uint16_t ratio;
+    uint8_t index;
+    uint16_t low;
+    uint16_t high;
+    int16_t angle;
+
+    // Checks for errors
+    if((absX == 0) && (absY == 0)) {
+        return 0;
+    }
+
+    // Arc tangent of the smaller over the larger value (0 to 45 degrees)
+    ratio = (absY <= absX) ? (uint16_t)((absY << 8) / absX) : (uint16_t)((absX << 8) / absY);
+    index = ratio >> 4;
+    low = pgm_read_word(&constAtanTable[index]);
+    if(index < 16) {
+        high = pgm_read_word(&constAtanTable[index + 1]);
+        low += ((high - low) * (ratio & 0x0F)) >> 4;
+    }
+    angle = (int16_t)low;
+
+    // Unfold octants
+    if(absY > absX) {
+        angle = 900 - angle;
+    }
+    if(x_p < 0) {
+        angle = 1800 - angle;
+    }
+    if(y_p < 0) {
+        angle = -angle;
+    }
+
+    return angle;
+}
+
+// =============================================================================
+// Class protected methods
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// General public functions definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
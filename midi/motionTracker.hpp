@@ -0,0 +1,415 @@
+//!
+//! \file           motionTracker.hpp
+//! \brief          Accelerometer filtering and tilt/gesture detection
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Fixed-point signal chain for the accelerometer samples.
+//!                     Each axis goes through a one-pole IIR low-pass filter
+//!                     (y += (x - y) / 2^MOTION_TRACKER_FILTER_SHIFT). The
+//!                     low-pass output gives the orientation, with
+//!                     hysteresis, and the tilt angles; the difference
+//!                     between the raw and the filtered samples (high-pass)
+//!                     is used to detect shakes (several peaks, or
+//!                     reversals of the strongest axis, in a short window)
+//!                     and taps (a single short peak). Every sample costs
+//!                     the same small number of additions and shifts, with no
+//!                     division and no floating point.
+//!
+//!                     The thresholds are given in raw accelerometer LSB for
+//!                     the +-2 g range (16384 LSB/g).
+//!
+
+// =============================================================================
+// Include guard (START)
+// =============================================================================
+
+#ifndef __MOTION_TRACKER_HPP
+#define __MOTION_TRACKER_HPP                    2304
+
+// =============================================================================
+// Dependencies
+// =============================================================================
+
+//     /////////////////     GLOBAL DEFINITIONS FILE    /////////////////     //
+#include "../funsape/globalDefines.hpp"
+#if !defined(__GLOBAL_DEFINES_HPP)
+#   error "Global definitions file is corrupted!"
+#elif __GLOBAL_DEFINES_HPP != __MOTION_TRACKER_HPP
+#   error "Version mismatch between file header and global definitions file!"
+#endif
+
+//     //////////////////     LIBRARY DEPENDENCIES     //////////////////     //
+#include "../funsape/util/systemTick.hpp"
+#if !defined(__SYSTEM_TICK_HPP)
+#   error "Header file (systemTick.hpp) is corrupted!"
+#elif __SYSTEM_TICK_HPP != __MOTION_TRACKER_HPP
+#   error "Version mismatch between header file and library dependency (systemTick.hpp)!"
+#endif
+
+// =============================================================================
+// Undefining previous definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Constant definitions
+// =============================================================================
+
+#ifndef MOTION_TRACKER_SAMPLE_PERIOD
+//!
+//! \brief          Sample period, in ms
+//!
+#   define MOTION_TRACKER_SAMPLE_PERIOD         10
+#endif
+
+#ifndef MOTION_TRACKER_FILTER_SHIFT
+//!
+//! \brief          Low-pass filter coefficient, as a power of two divisor
+//! \details        The time constant is about
+//!                     MOTION_TRACKER_SAMPLE_PERIOD * 2^MOTION_TRACKER_FILTER_SHIFT
+//!                     milliseconds.
+//!
+#   define MOTION_TRACKER_FILTER_SHIFT          3
+#endif
+
+#ifndef MOTION_TRACKER_ENTER_THRESHOLD
+//!
+//! \brief          Filtered acceleration needed to enter an orientation
+//!
+#   define MOTION_TRACKER_ENTER_THRESHOLD       12544
+#endif
+
+#ifndef MOTION_TRACKER_EXIT_THRESHOLD
+//!
+//! \brief          Filtered acceleration below which an orientation is left
+//!
+#   define MOTION_TRACKER_EXIT_THRESHOLD        8192
+#endif
+
+#ifndef MOTION_TRACKER_SHAKE_THRESHOLD
+//!
+//! \brief          High-pass magnitude of a shake peak, in units of 16 LSB
+//! \details        The magnitude is the sum of the absolute values of the
+//!                     three axes.
+//!
+#   define MOTION_TRACKER_SHAKE_THRESHOLD       512
+#endif
+
+#ifndef MOTION_TRACKER_TAP_THRESHOLD
+//!
+//! \brief          High-pass magnitude of a tap peak, in units of 16 LSB
+//!
+#   define MOTION_TRACKER_TAP_THRESHOLD         1024
+#endif
+
+#ifndef MOTION_TRACKER_TAP_LENGTH
+//!
+//! \brief          Longest peak taken as a tap, in samples
+//!
+#   define MOTION_TRACKER_TAP_LENGTH            3
+#endif
+
+#ifndef MOTION_TRACKER_TAP_QUIET
+//!
+//! \brief          Samples without a new peak needed to confirm a tap
+//!
+#   define MOTION_TRACKER_TAP_QUIET             15
+#endif
+
+#ifndef MOTION_TRACKER_SHAKE_COUNT
+//!
+//! \brief          Number of peaks that make a shake
+//!
+#   define MOTION_TRACKER_SHAKE_COUNT           4
+#endif
+
+#ifndef MOTION_TRACKER_SHAKE_WINDOW
+//!
+//! \brief          Window in which the shake peaks must happen, in samples
+//!
+#   define MOTION_TRACKER_SHAKE_WINDOW          80
+#endif
+
+#ifndef MOTION_TRACKER_HOLDOFF
+//!
+//! \brief          Samples ignored by the gesture detector after a gesture
+//!
+#   define MOTION_TRACKER_HOLDOFF               50
+#endif
+
+#ifndef MOTION_TRACKER_EVENT_QUEUE_SIZE
+//!
+//! \brief          Event queue size (must be a power of two)
+//!
+#   define MOTION_TRACKER_EVENT_QUEUE_SIZE      4
+#endif
+
+#if (MOTION_TRACKER_EVENT_QUEUE_SIZE & (MOTION_TRACKER_EVENT_QUEUE_SIZE - 1)) != 0
+#   error "MOTION_TRACKER_EVENT_QUEUE_SIZE must be a power of two!"
+#endif
+
+#if MOTION_TRACKER_EXIT_THRESHOLD >= MOTION_TRACKER_ENTER_THRESHOLD
+#   error "MOTION_TRACKER_EXIT_THRESHOLD must be smaller than MOTION_TRACKER_ENTER_THRESHOLD!"
+#endif
+
+// =============================================================================
+// New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// MotionTracker Class
+// =============================================================================
+
+//!
+//! \brief          MotionTracker class
+//! \details        The samples must be given at a fixed rate; the user asks
+//!                     \ref{isSampleDue} when to start reading the sensor and
+//!                     hands the result to \ref{update}. The time base is the
+//!                     system timebase, which must be running beforehand.
+//!                     Events are queued only when something actually
+//!                     changes.
+//!
+class MotionTracker
+{
+    // -------------------------------------------------------------------------
+    // New data types ----------------------------------------------------------
+public:
+    //!
+    //! \brief      Device orientation
+    //! \details    Axis pointing up, as given by the gravity.
+    //!
+    enum class Orientation : uint8_t {
+        UNKNOWN                         = 0,
+        Z_UP                            = 1,
+        Z_DOWN                          = 2,
+        Y_UP                            = 3,
+        Y_DOWN                          = 4,
+        X_UP                            = 5,
+        X_DOWN                          = 6
+    };
+
+    //!
+    //! \brief      Motion events
+    //!
+    enum class Event : uint8_t {
+        NONE                            = 0,    //!< No event
+        ORIENTATION_CHANGED             = 1,    //!< See \ref{getOrientation}
+        SHAKE                           = 2,    //!< Device shaken
+        TAP                             = 3     //!< Device tapped once
+    };
+
+    // -------------------------------------------------------------------------
+    // Constructors ------------------------------------------------------------
+public:
+    //!
+    //! \brief      MotionTracker class constructor
+    //! \details    Creates a MotionTracker object
+    //!
+    MotionTracker(
+            void
+    );
+
+    //!
+    //! \brief      MotionTracker class destructor
+    //! \details    Destroys a MotionTracker object
+    //!
+    ~MotionTracker(
+            void
+    );
+
+    // -------------------------------------------------------------------------
+    // Methods -----------------------------------------------------------------
+public:
+    //     ///////////////////     CONFIGURATION     ////////////////////     //
+
+    //!
+    //! \brief      Resets the signal chain
+    //! \details    Clears the filters, the orientation, the gesture detector
+    //!                 and the event queue. The next sample seeds the
+    //!                 filters.
+    //!
+    void reset(
+            void
+    );
+
+    //     ////////////////////    DATA TRANSFER     ////////////////////     //
+
+    //!
+    //! \brief      Checks if a new sample must be taken
+    //! \details    Returns true once every MOTION_TRACKER_SAMPLE_PERIOD ms.
+    //!                 The sample instants do not drift; if the caller falls
+    //!                 more than one period behind, the missed samples are
+    //!                 counted and the schedule restarts from now.
+    //! \return     bool_t              True if a sample is due / False
+    //!                                     otherwise
+    //!
+    bool_t isSampleDue(
+            void
+    );
+
+    //!
+    //! \brief      Processes one sample
+    //! \details    Runs the sample through the filters and the detectors,
+    //!                 and queues the resulting events.
+    //! \param      x_p                 X axis acceleration, in LSB
+    //! \param      y_p                 Y axis acceleration, in LSB
+    //! \param      z_p                 Z axis acceleration, in LSB
+    //!
+    void update(
+            cint16_t x_p,
+            cint16_t y_p,
+            cint16_t z_p
+    );
+
+    //!
+    //! \brief      Gets the oldest pending event
+    //! \details    Gets the oldest pending event. If the queue is full, new
+    //!                 events are dropped.
+    //! \param      event_p             Pointer to the event
+    //! \return     bool_t              True if an event was read / False if
+    //!                                     the queue is empty
+    //!
+    bool_t getEvent(
+            Event *event_p
+    );
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+
+    //!
+    //! \brief      Returns the orientation
+    //! \details    Returns the orientation. It stays the same until another
+    //!                 axis goes beyond MOTION_TRACKER_ENTER_THRESHOLD while
+    //!                 the current one is below MOTION_TRACKER_EXIT_THRESHOLD.
+    //! \return     Orientation         Current orientation
+    //!
+    Orientation inlined getOrientation(
+            void
+    );
+
+    //!
+    //! \brief      Returns the filtered acceleration
+    //! \details    Returns the low-pass filtered acceleration.
+    //! \param      x_p                 Pointer to the X axis value, in LSB
+    //! \param      y_p                 Pointer to the Y axis value, in LSB
+    //! \param      z_p                 Pointer to the Z axis value, in LSB
+    //!
+    void getFiltered(
+            int16_t *x_p,
+            int16_t *y_p,
+            int16_t *z_p
+    );
+
+    //!
+    //! \brief      Returns the tilt angles
+    //! \details    Computes the tilt angles from the filtered acceleration.
+    //!                 The roll is the rotation around the X axis, from -1800
+    //!                 to 1800; the pitch is the rotation around the Y axis,
+    //!                 from -900 to 900. Both are zero with the Z axis
+    //!                 pointing up. This function is not called from
+    //!                 \ref{update}, so its cost is paid only when needed.
+    //! \param      roll_p              Pointer to the roll, in tenths of
+    //!                                     degree
+    //! \param      pitch_p             Pointer to the pitch, in tenths of
+    //!                                     degree
+    //!
+    void getTilt(
+            int16_t *roll_p,
+            int16_t *pitch_p
+    );
+
+    //!
+    //! \brief      Returns the number of missed samples
+    //! \details    Returns the number of sample periods skipped because
+    //!                 \ref{isSampleDue} was called too late. The counter
+    //!                 saturates at 0xFFFF.
+    //! \return     uint16_t            Missed samples
+    //!
+    uint16_t getMissedCount(
+            void
+    );
+
+private:
+    //     ////////////////////    DATA TRANSFER     ////////////////////     //
+    void _updateOrientation(
+            void
+    );
+    void _updateGestures(
+            cuint16_t magnitude_p,
+            cuint8_t direction_p
+    );
+    void _pushEvent(
+            const Event event_p
+    );
+    int16_t _atan2(
+            int32_t y_p,
+            int32_t x_p
+    );
+
+protected:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Properties --------------------------------------------------------------
+private:
+    //     ///////////////////////     FILTER     ////////////////////////     //
+    int32_t             _state[3];              // Filtered value << MOTION_TRACKER_FILTER_SHIFT
+    int16_t             _filtered[3];
+    bool_t              _isPrimed                       : 1;
+
+    //     ////////////////////////     TIME     /////////////////////////     //
+    uint16_t            _nextSample;
+    uint16_t            _missedCount;
+
+    //     /////////////////////     DETECTORS     //////////////////////     //
+    Orientation         _orientation;
+    uint8_t             _peakLength;
+    uint8_t             _peakDirection;         // Axis * 2 + negative
+    uint8_t             _peakCount;
+    uint8_t             _windowLength;
+    uint8_t             _holdoff;
+    bool_t              _isTapCandidate                 : 1;
+
+    //     ///////////////////////     EVENTS     ////////////////////////     //
+    Event               _eventQueue[MOTION_TRACKER_EVENT_QUEUE_SIZE];
+    uint8_t             _eventHead;
+    uint8_t             _eventTail;
+}; // class MotionTracker
+
+// =============================================================================
+// MotionTracker - Class inline function definitions
+// =============================================================================
+
+MotionTracker::Orientation inlined MotionTracker::getOrientation(void)
+{
+    return this->_orientation;
+}
+
+// =============================================================================
+// External global variables
+// =============================================================================
+
+//!
+//! \brief          Motion tracker handler object
+//! \details        Motion tracker handler object
+//!
+extern MotionTracker motionTracker;
+
+// =============================================================================
+// Include guard (END)
+// =============================================================================
+
+#endif  // __MOTION_TRACKER_HPP
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
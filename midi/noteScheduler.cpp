@@ -0,0 +1,312 @@
+//!
+//! \file           noteScheduler.cpp
+//! \brief          Timer-driven MIDI note-off scheduler
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Timer-driven MIDI note-off scheduler
+//!
+
+// =============================================================================
+// System file dependencies
+// =============================================================================
+
+#include "noteScheduler.hpp"
+#if !defined(__NOTE_SCHEDULER_HPP)
+#    error "Header file is corrupted!"
+#elif __NOTE_SCHEDULER_HPP != 2304
+#    error "Version mismatch between source and header files!"
+#endif
+
+// =============================================================================
+// File exclusive - Constants
+// =============================================================================
+
+#define DEBUG_NOTE_SCHEDULER            0x1FFF
+
+cuint16_t constMaximumDuration          = 0x7FFF;                       //!< Longest schedulable duration
+
+// =============================================================================
+// File exclusive - New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// File exclusive - Global variables
+// =============================================================================
+
+NoteScheduler noteScheduler;
+
+// =============================================================================
+// File exclusive - Macro-functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Class constructors
+// =============================================================================
+
+NoteScheduler::NoteScheduler(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("NoteScheduler::NoteScheduler(void)", DEBUG_NOTE_SCHEDULER);
+
+    // Reset data members
+    this->_count                        = 0;
+    this->_isInitialized                = false;
+
+    // Returns successfully
+    this->_lastError                    = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_NOTE_SCHEDULER);
+    return;
+}
+
+NoteScheduler::~NoteScheduler(void)
+{
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_NOTE_SCHEDULER);
+    return;
+}
+
+// =============================================================================
+// Class public methods
+// =============================================================================
+
+//     ///////////////////     CONFIGURATION     ////////////////////     //
+bool_t NoteScheduler::init(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("NoteScheduler::init(void)", DEBUG_NOTE_SCHEDULER);
+
+    // Reset data members
+    this->_count                        = 0;
+    this->_isInitialized                = true;
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_NOTE_SCHEDULER);
+    return true;
+}
+
+//     //////////////////////    SCHEDULING    //////////////////////     //
+bool_t NoteScheduler::scheduleNoteOff(cuint8_t channel_p, cuint8_t pitch_p, cuint16_t duration_p, cuint8_t tag_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("NoteScheduler::scheduleNoteOff(cuint8_t, cuint8_t, cuint16_t, cuint8_t)", DEBUG_NOTE_SCHEDULER);
+
+    // Checks for errors
+    if(!this->_isInitialized) {
+        // Returns error
+        this->_lastError = Error::NOT_INITIALIZED;
+        debugMessage(Error::NOT_INITIALIZED, DEBUG_NOTE_SCHEDULER);
+        return false;
+    }
+    if((channel_p > 15) || (pitch_p > 127) || (duration_p > constMaximumDuration) || (tag_p > 15)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+        debugMessage(Error::ARGUMENT_VALUE_INVALID, DEBUG_NOTE_SCHEDULER);
+        return false;
+    }
+
+    // Retriggered note - drop the old deadline
+    for(uint8_t i = 0; i < this->_count; i++) {
+        if((this->_heap[i].channel == channel_p) && (this->_heap[i].pitch == pitch_p)) {
+            this->_removeAt(i);
+            break;
+        }
+    }
+
+    // Checks for free space
+    if(this->_count == NOTE_SCHEDULER_CAPACITY) {
+        // Returns error
+        this->_lastError = Error::BUFFER_NOT_ENOUGH_SPACE;
+        debugMessage(Error::BUFFER_NOT_ENOUGH_SPACE, DEBUG_NOTE_SCHEDULER);
+        return false;
+    }
+
+    // Insert note at the bottom of the heap
+    this->_heap[this->_count].deadline  = this->getTick() + duration_p;
+    this->_heap[this->_count].channel   = channel_p;
+    this->_heap[this->_count].tag       = tag_p;
+    this->_heap[this->_count].pitch     = pitch_p;
+    this->_count++;
+    this->_siftUp(this->_count - 1);
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_NOTE_SCHEDULER);
+    return true;
+}
+
+void NoteScheduler::process(void)
+{
+    // Local variables
+    uint16_t now = this->getTick();
+    uint8_t channel;
+    uint8_t pitch;
+
+    // Release expired notes, earliest first
+    while((this->_count > 0) && !this->_isBefore(now, this->_heap[0].deadline)) {
+        channel = this->_heap[0].channel;
+        pitch = this->_heap[0].pitch;
+        this->_removeAt(0);
+        noteSchedulerNoteOffCallback(channel, pitch);
+    }
+
+    return;
+}
+
+void NoteScheduler::releaseAll(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("NoteScheduler::releaseAll(void)", DEBUG_NOTE_SCHEDULER);
+
+    // Release every pending note
+    while(this->_count > 0) {
+        this->_count--;
+        noteSchedulerNoteOffCallback(this->_heap[this->_count].channel, this->_heap[this->_count].pitch);
+    }
+
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_NOTE_SCHEDULER);
+    return;
+}
+
+void NoteScheduler::release(cuint8_t tag_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("NoteScheduler::release(cuint8_t)", DEBUG_NOTE_SCHEDULER);
+
+    // Local variables
+    uint8_t kept = 0;
+
+    // Release the notes of the tag, compacting the others
+    for(uint8_t i = 0; i < this->_count; i++) {
+        if(this->_heap[i].tag == tag_p) {
+            noteSchedulerNoteOffCallback(this->_heap[i].channel, this->_heap[i].pitch);
+        } else {
+            this->_heap[kept++] = this->_heap[i];
+        }
+    }
+    this->_count = kept;
+
+    // Restore heap property
+    for(uint8_t i = this->_count / 2; i > 0; i--) {
+        this->_siftDown(i - 1);
+    }
+
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_NOTE_SCHEDULER);
+    return;
+}
+
+//     /////////////////     CONTROL AND STATUS     /////////////////     //
+uint16_t NoteScheduler::getTick(void)
+{
+    // Returns value (the system timebase reads atomically)
+    return (uint16_t)systemTick.getMilliseconds();
+}
+
+Error NoteScheduler::getLastError(void)
+{
+    // Returns last error
+    return this->_lastError;
+}
+
+// =============================================================================
+// Class private methods
+// =============================================================================
+
+//     //////////////////////    SCHEDULING    //////////////////////     //
+bool_t NoteScheduler::_isBefore(cuint16_t first_p, cuint16_t second_p)
+{
+    // Wrap-safe comparison
+    return ((int16_t)(first_p - second_p) < 0);
+}
+
+void NoteScheduler::_removeAt(cuint8_t index_p)
+{
+    // Move last element to the hole and restore heap property
+    this->_count--;
+    if(index_p == this->_count) {
+        return;
+    }
+    this->_heap[index_p] = this->_heap[this->_count];
+    if((index_p > 0) && this->_isBefore(this->_heap[index_p].deadline, this->_heap[(index_p - 1) / 2].deadline)) {
+        this->_siftUp(index_p);
+    } else {
+        this->_siftDown(index_p);
+    }
+
+    return;
+}
+
+void NoteScheduler::_siftUp(uint8_t index_p)
+{
+    // Local variables
+    PendingNote aux = this->_heap[index_p];
+    uint8_t parent;
+
+    // Move parents down until the slot is found
+    while(index_p > 0) {
+        parent = (index_p - 1) / 2;
+        if(!this->_isBefore(aux.deadline, this->_heap[parent].deadline)) {
+            break;
+        }
+        this->_heap[index_p] = this->_heap[parent];
+        index_p = parent;
+    }
+    this->_heap[index_p] = aux;
+
+    return;
+}
+
+void NoteScheduler::_siftDown(uint8_t index_p)
+{
+    // Local variables
+    PendingNote aux = this->_heap[index_p];
+    uint8_t child;
+
+    // Move earliest children up until the slot is found
+    while((child = (2 * index_p) + 1) < this->_count) {
+        if(((child + 1) < this->_count) &&
+                this->_isBefore(this->_heap[child + 1].deadline, this->_heap[child].deadline)) {
+            child++;
+        }
+        if(!this->_isBefore(this->_heap[child].deadline, aux.deadline)) {
+            break;
+        }
+        this->_heap[index_p] = this->_heap[child];
+        index_p = child;
+    }
+    this->_heap[index_p] = aux;
+
+    return;
+}
+
+// =============================================================================
+// Class protected methods
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// General public functions definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+weakened void noteSchedulerNoteOffCallback(uint8_t channel_p, uint8_t pitch_p)
+{
+    return;
+}
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
@@ -0,0 +1,285 @@
+//!
+//! \file           noteScheduler.hpp
+//! \brief          MIDI note-off scheduler
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Keeps the pending note-off events in a fixed-capacity
+//!                     priority queue (binary min-heap ordered by deadline),
+//!                     using the 1 ms system timebase (TIMER0). Expired
+//!                     notes are released from the main loop, so that the
+//!                     MIDI output stream keeps a single producer.
+//!
+
+// =============================================================================
+// Include guard (START)
+// =============================================================================
+
+#ifndef __NOTE_SCHEDULER_HPP
+#define __NOTE_SCHEDULER_HPP                    2304
+
+// =============================================================================
+// Dependencies
+// =============================================================================
+
+//     /////////////////     GLOBAL DEFINITIONS FILE    /////////////////     //
+#include "../funsape/globalDefines.hpp"
+#if !defined(__GLOBAL_DEFINES_HPP)
+#   error "Global definitions file is corrupted!"
+#elif __GLOBAL_DEFINES_HPP != __NOTE_SCHEDULER_HPP
+#   error "Version mismatch between file header and global definitions file!"
+#endif
+
+//     //////////////////     LIBRARY DEPENDENCIES     //////////////////     //
+#include "../funsape/util/systemTick.hpp"
+#if !defined(__SYSTEM_TICK_HPP)
+#   error "Header file (systemTick.hpp) is corrupted!"
+#elif __SYSTEM_TICK_HPP != __NOTE_SCHEDULER_HPP
+#   error "Version mismatch between header file and library dependency (systemTick.hpp)!"
+#endif
+
+// =============================================================================
+// Undefining previous definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Constant definitions
+// =============================================================================
+
+#ifndef NOTE_SCHEDULER_CAPACITY
+//!
+//! \brief          Maximum number of pending note-off events
+//!
+#   define NOTE_SCHEDULER_CAPACITY      16
+#endif
+
+// =============================================================================
+// New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+//!
+//! \brief          Note-off callback function
+//! \details        This function is called from NoteScheduler::process() for
+//!                     each note whose duration expired. It is a weak
+//!                     function that can be overwritten by the user.
+//! \param          channel_p           MIDI channel of the note (0 to 15)
+//! \param          pitch_p             MIDI note number (0 to 127)
+//!
+void noteSchedulerNoteOffCallback(
+        uint8_t channel_p,
+        uint8_t pitch_p
+);
+
+// =============================================================================
+// NoteScheduler Class
+// =============================================================================
+
+//!
+//! \brief          NoteScheduler class
+//! \details        Schedules note-off events. Deadlines are kept as 16-bit
+//!                     millisecond timestamps compared through signed
+//!                     differences, so the counter may wrap freely as long as
+//!                     no duration exceeds 32767 ms.
+//!
+class NoteScheduler
+{
+    // -------------------------------------------------------------------------
+    // New data types ----------------------------------------------------------
+private:
+    //!
+    //! \brief      Pending note-off event
+    //!
+    typedef struct {
+        uint16_t    deadline;           //!< Tick at which the note expires
+        uint8_t     channel     : 4;    //!< MIDI channel
+        uint8_t     tag         : 4;    //!< Module that scheduled the note
+        uint8_t     pitch;              //!< MIDI note number
+    } PendingNote;
+
+    // -------------------------------------------------------------------------
+    // Constructors ------------------------------------------------------------
+public:
+    //!
+    //! \brief      NoteScheduler class constructor
+    //! \details    Creates a NoteScheduler object
+    //!
+    NoteScheduler(
+            void
+    );
+
+    //!
+    //! \brief      NoteScheduler class destructor
+    //! \details    Destroys a NoteScheduler object
+    //!
+    ~NoteScheduler(
+            void
+    );
+
+    // -------------------------------------------------------------------------
+    // Methods -----------------------------------------------------------------
+public:
+    //     ///////////////////     CONFIGURATION     ////////////////////     //
+
+    //!
+    //! \brief      Initializes the scheduler
+    //! \details    Empties the queue. The system timebase must be running.
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t init(
+            void
+    );
+
+    //     //////////////////////    SCHEDULING    //////////////////////     //
+
+    //!
+    //! \brief      Schedules a note-off event
+    //! \details    Schedules the release of the note after duration_p
+    //!                 milliseconds. If the same note is already pending, its
+    //!                 deadline is replaced, so a retriggered note sounds for
+    //!                 the full new duration. The tag identifies the module
+    //!                 that scheduled the note, so it can release its own
+    //!                 notes with release().
+    //! \param      channel_p           MIDI channel of the note (0 to 15)
+    //! \param      pitch_p             MIDI note number (0 to 127)
+    //! \param      duration_p          Note duration, in milliseconds (up to
+    //!                                     32767 ms)
+    //! \param      tag_p               Tag of the note (0 to 15)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t scheduleNoteOff(
+            cuint8_t channel_p,
+            cuint8_t pitch_p,
+            cuint16_t duration_p,
+            cuint8_t tag_p              = 0
+    );
+
+    //!
+    //! \brief      Releases every expired note
+    //! \details    Calls noteSchedulerNoteOffCallback() for each note whose
+    //!                 deadline has passed, in deadline order. Must be called
+    //!                 periodically from the main loop.
+    //!
+    void process(
+            void
+    );
+
+    //!
+    //! \brief      Releases every pending note immediately
+    //! \details    Calls noteSchedulerNoteOffCallback() for every pending
+    //!                 note and empties the queue.
+    //!
+    void releaseAll(
+            void
+    );
+
+    //!
+    //! \brief      Releases the pending notes of a tag immediately
+    //! \details    Calls noteSchedulerNoteOffCallback() for every pending
+    //!                 note scheduled with the tag and removes them from the
+    //!                 queue. The notes of other tags are kept.
+    //! \param      tag_p               Tag of the notes (0 to 15)
+    //!
+    void release(
+            cuint8_t tag_p
+    );
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+
+    //!
+    //! \brief      Returns the number of pending notes
+    //! \details    Returns the number of pending notes.
+    //! \return     uint8_t             Number of pending notes
+    //!
+    uint8_t inlined getPendingCount(
+            void
+    );
+
+    //!
+    //! \brief      Returns the millisecond counter
+    //! \details    Returns the low 16 bits of the system timebase
+    //!                 millisecond counter, which wrap every 65536 ms.
+    //! \return     uint16_t            Current tick
+    //!
+    uint16_t getTick(
+            void
+    );
+
+    //!
+    //! \brief      Returns the last error
+    //! \details    Returns the last error.
+    //! \return     Error               Error status of the last operation
+    //!
+    Error getLastError(
+            void
+    );
+
+private:
+    //     //////////////////////    SCHEDULING    //////////////////////     //
+    bool_t _isBefore(
+            cuint16_t first_p,
+            cuint16_t second_p
+    );
+
+    void _removeAt(
+            cuint8_t index_p
+    );
+
+    void _siftUp(
+            uint8_t index_p
+    );
+
+    void _siftDown(
+            uint8_t index_p
+    );
+
+protected:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Properties --------------------------------------------------------------
+private:
+    //     ////////////////////    DATA BUFFERS      ////////////////////     //
+    PendingNote         _heap[NOTE_SCHEDULER_CAPACITY];
+    uint8_t             _count;
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+    bool_t              _isInitialized                  : 1;
+    Error               _lastError;
+}; // class NoteScheduler
+
+// =============================================================================
+// NoteScheduler - Class inline function definitions
+// =============================================================================
+
+uint8_t inlined NoteScheduler::getPendingCount(void)
+{
+    return this->_count;
+}
+
+// =============================================================================
+// External global variables
+// =============================================================================
+
+//!
+//! \brief          Note scheduler handler object
+//! \details        Note scheduler handler object
+//!
+extern NoteScheduler noteScheduler;
+
+// =============================================================================
+// Include guard (END)
+// =============================================================================
+
+#endif  // __NOTE_SCHEDULER_HPP
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
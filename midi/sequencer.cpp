@@ -0,0 +1,204 @@
+//!
+//! \file           sequencer.cpp
+//! \brief          Flash-resident song sequencer
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Flash-resident song sequencer
+//!
+
+// =============================================================================
+// System file dependencies
+// =============================================================================
+
+#include "sequencer.hpp"
+#if !defined(__SEQUENCER_HPP)
+#    error "Header file is corrupted!"
+#elif __SEQUENCER_HPP != 2304
+#    error "Version mismatch between source and header files!"
+#endif
+
+// =============================================================================
+// File exclusive - Constants
+// =============================================================================
+
+#define DEBUG_SEQUENCER                 0x1FFF
+
+// =============================================================================
+// File exclusive - New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// File exclusive - Global variables
+// =============================================================================
+
+Sequencer sequencer;
+
+// =============================================================================
+// File exclusive - Macro-functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Class constructors
+// =============================================================================
+
+Sequencer::Sequencer(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("Sequencer::Sequencer(void)", DEBUG_SEQUENCER);
+
+    // Reset data members
+    this->_song                         = nullptr;
+    this->_length                       = 0;
+    this->_index                        = 0;
+    this->_nextEventTime                = 0;
+    this->_channel                      = 0;
+    this->_isPlaying                    = false;
+
+    // Returns successfully
+    this->_lastError                    = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_SEQUENCER);
+    return;
+}
+
+Sequencer::~Sequencer(void)
+{
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_SEQUENCER);
+    return;
+}
+
+// =============================================================================
+// Class public methods
+// =============================================================================
+
+//     ////////////////////     PLAYBACK     ////////////////////////     //
+bool_t Sequencer::play(const SongEvent *song_p, cuint16_t length_p, cuint8_t channel_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("Sequencer::play(const SongEvent *, cuint16_t, cuint8_t)", DEBUG_SEQUENCER);
+
+    // Checks for errors
+    if(!isPointerValid(song_p)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_POINTER_NULL;
+        debugMessage(Error::ARGUMENT_POINTER_NULL, DEBUG_SEQUENCER);
+        return false;
+    }
+    if(length_p == 0) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_CANNOT_BE_ZERO;
+        debugMessage(Error::ARGUMENT_CANNOT_BE_ZERO, DEBUG_SEQUENCER);
+        return false;
+    }
+    if(channel_p > 15) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+        debugMessage(Error::ARGUMENT_VALUE_INVALID, DEBUG_SEQUENCER);
+        return false;
+    }
+
+    // Stop current song
+    if(this->_isPlaying) {
+        this->stop();
+    }
+
+    // Update data members
+    this->_song                         = song_p;
+    this->_length                       = length_p;
+    this->_index                        = 0;
+    this->_channel                      = channel_p;
+    this->_nextEventTime                = (uint16_t)systemTick.getMilliseconds();
+    this->_isPlaying                    = true;
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_SEQUENCER);
+    return true;
+}
+
+void Sequencer::stop(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("Sequencer::stop(void)", DEBUG_SEQUENCER);
+
+    // Stop playback and silence the song notes only
+    this->_isPlaying                    = false;
+    noteScheduler.release(SEQUENCER_NOTE_TAG);
+
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_SEQUENCER);
+    return;
+}
+
+void Sequencer::process(void)
+{
+    // Local variables
+    const SongEvent *event;
+    uint8_t message[3];
+    uint8_t duration;
+
+    // Play every due event
+    while(this->_isPlaying && ((int16_t)((uint16_t)systemTick.getMilliseconds() - this->_nextEventTime) >= 0)) {
+        event = &this->_song[this->_index];
+        message[0] = 0x90 | this->_channel;
+        message[1] = pgm_read_byte(&event->pitch);
+        message[2] = pgm_read_byte(&event->velocity);
+        duration = pgm_read_byte(&event->duration);
+        if(message[2] != 0) {
+            voiceTracker.sendMessage(message, 3);
+            if(!noteScheduler.scheduleNoteOff(this->_channel, message[1],
+                            (uint16_t)duration * SEQUENCER_TIME_UNIT_MS, SEQUENCER_NOTE_TAG)) {
+                // Queue is full - do not leave the note hanging
+                message[2] = 0;
+                voiceTracker.sendMessage(message, 3);
+            }
+        }
+        this->_nextEventTime += (uint16_t)pgm_read_byte(&event->delta) * SEQUENCER_TIME_UNIT_MS;
+        if(++this->_index == this->_length) {
+            // Last notes are released by the scheduler
+            this->_isPlaying = false;
+        }
+    }
+
+    return;
+}
+
+//     /////////////////     CONTROL AND STATUS     /////////////////     //
+Error Sequencer::getLastError(void)
+{
+    // Returns last error
+    return this->_lastError;
+}
+
+// =============================================================================
+// Class private methods
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Class protected methods
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// General public functions definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
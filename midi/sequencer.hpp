@@ -0,0 +1,250 @@
+//!
+//! \file           sequencer.hpp
+//! \brief          Flash-resident song sequencer
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Plays songs stored in program memory as arrays of
+//!                     SongEvent, one event at a time, using the system
+//!                     timebase millisecond tick. Note-offs are
+//!                     handed to the note scheduler, so playback never blocks
+//!                     the main loop.
+//!
+
+// =============================================================================
+// Include guard (START)
+// =============================================================================
+
+#ifndef __SEQUENCER_HPP
+#define __SEQUENCER_HPP                         2304
+
+// =============================================================================
+// Dependencies
+// =============================================================================
+
+//     /////////////////     GLOBAL DEFINITIONS FILE    /////////////////     //
+#include "../funsape/globalDefines.hpp"
+#if !defined(__GLOBAL_DEFINES_HPP)
+#   error "Global definitions file is corrupted!"
+#elif __GLOBAL_DEFINES_HPP != __SEQUENCER_HPP
+#   error "Version mismatch between file header and global definitions file!"
+#endif
+
+//     //////////////////     LIBRARY DEPENDENCIES     //////////////////     //
+#include "voiceTracker.hpp"
+#if !defined(__VOICE_TRACKER_HPP)
+#   error "Header file (voiceTracker.hpp) is corrupted!"
+#elif __VOICE_TRACKER_HPP != __SEQUENCER_HPP
+#   error "Version mismatch between header file and library dependency (voiceTracker.hpp)!"
+#endif
+
+#include "noteScheduler.hpp"
+#if !defined(__NOTE_SCHEDULER_HPP)
+#   error "Header file (noteScheduler.hpp) is corrupted!"
+#elif __NOTE_SCHEDULER_HPP != __SEQUENCER_HPP
+#   error "Version mismatch between header file and library dependency (noteScheduler.hpp)!"
+#endif
+
+#include "../funsape/util/systemTick.hpp"
+#if !defined(__SYSTEM_TICK_HPP)
+#   error "Header file (systemTick.hpp) is corrupted!"
+#elif __SYSTEM_TICK_HPP != __SEQUENCER_HPP
+#   error "Version mismatch between header file and library dependency (systemTick.hpp)!"
+#endif
+
+#include <avr/pgmspace.h>
+
+// =============================================================================
+// Undefining previous definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Constant definitions
+// =============================================================================
+
+//!
+//! \brief          Duration of one song time unit, in milliseconds
+//!
+#define SEQUENCER_TIME_UNIT_MS          10
+
+//!
+//! \brief          Note scheduler tag of the notes played by the sequencer
+//!
+#define SEQUENCER_NOTE_TAG              1
+
+//!
+//! \brief          Number of events of a song array
+//!
+#define songLength(song)                (sizeof(song) / sizeof(SongEvent))
+
+// =============================================================================
+// New data types
+// =============================================================================
+
+//!
+//! \brief          Song event
+//! \details        One note of a song, stored in program memory. Times are
+//!                     expressed in units of SEQUENCER_TIME_UNIT_MS. An event
+//!                     with velocity zero is a rest.
+//!
+typedef struct {
+    uint8_t     pitch;                  //!< MIDI note number (0 to 127)
+    uint8_t     velocity;               //!< Note velocity (0 = rest)
+    uint8_t     duration;               //!< Time until the note-off
+    uint8_t     delta;                  //!< Time until the next event
+} SongEvent;
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Sequencer Class
+// =============================================================================
+
+//!
+//! \brief          Sequencer class
+//! \details        Plays one song at a time. The system timebase must be
+//!                     running and the note scheduler initialized before
+//!                     use.
+//!
+class Sequencer
+{
+    // -------------------------------------------------------------------------
+    // New data types ----------------------------------------------------------
+public:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Constructors ------------------------------------------------------------
+public:
+    //!
+    //! \brief      Sequencer class constructor
+    //! \details    Creates a Sequencer object
+    //!
+    Sequencer(
+            void
+    );
+
+    //!
+    //! \brief      Sequencer class destructor
+    //! \details    Destroys a Sequencer object
+    //!
+    ~Sequencer(
+            void
+    );
+
+    // -------------------------------------------------------------------------
+    // Methods -----------------------------------------------------------------
+public:
+    //     ////////////////////     PLAYBACK     ////////////////////////     //
+
+    //!
+    //! \brief      Starts playing a song
+    //! \details    Stops the current song, if any, and starts the new one.
+    //!                 The first event is played on the next call to
+    //!                 process().
+    //! \param      song_p              Pointer to the song in program memory
+    //! \param      length_p            Number of events of the song
+    //! \param      channel_p           MIDI channel (0 to 15)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t play(
+            const SongEvent *song_p,
+            cuint16_t length_p,
+            cuint8_t channel_p
+    );
+
+    //!
+    //! \brief      Stops the current song
+    //! \details    Stops the current song and releases its pending notes;
+    //!                 notes scheduled by other modules keep their duration.
+    //!
+    void stop(
+            void
+    );
+
+    //!
+    //! \brief      Plays every due event
+    //! \details    Plays every event whose time has come. Must be called
+    //!                 periodically from the main loop, after
+    //!                 NoteScheduler::process(), so a repeated pitch is
+    //!                 released before it is played again.
+    //!
+    void process(
+            void
+    );
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+
+    //!
+    //! \brief      Checks if a song is playing
+    //! \details    Checks if a song is playing.
+    //! \return     bool_t              True if playing / False otherwise
+    //!
+    bool_t inlined isPlaying(
+            void
+    );
+
+    //!
+    //! \brief      Returns the last error
+    //! \details    Returns the last error.
+    //! \return     Error               Error status of the last operation
+    //!
+    Error getLastError(
+            void
+    );
+
+private:
+    // NONE
+
+protected:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Properties --------------------------------------------------------------
+private:
+    //     ////////////////////     PLAYBACK     ////////////////////////     //
+    const SongEvent     *_song;
+    uint16_t            _length;
+    uint16_t            _index;
+    uint16_t            _nextEventTime;
+    uint8_t             _channel;
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+    bool_t              _isPlaying                      : 1;
+    Error               _lastError;
+}; // class Sequencer
+
+// =============================================================================
+// Sequencer - Class inline function definitions
+// =============================================================================
+
+bool_t inlined Sequencer::isPlaying(void)
+{
+    return this->_isPlaying;
+}
+
+// =============================================================================
+// External global variables
+// =============================================================================
+
+//!
+//! \brief          Song sequencer handler object
+//! \details        Song sequencer handler object
+//!
+extern Sequencer sequencer;
+
+// =============================================================================
+// Include guard (END)
+// =============================================================================
+
+#endif  // __SEQUENCER_HPP
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
@@ -0,0 +1,494 @@
+//!
+//! \file           smfParser.cpp
+//! \brief          Streaming Standard MIDI File parser
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Streaming Standard MIDI File parser
+//!
+
+// =============================================================================
+// System file dependencies
+// =============================================================================
+
+#include "smfParser.hpp"
+#if !defined(__SMF_PARSER_HPP)
+#    error "Header file is corrupted!"
+#elif __SMF_PARSER_HPP != 2304
+#    error "Version mismatch between source and header files!"
+#endif
+
+// =============================================================================
+// File exclusive - Constants
+// =============================================================================
+
+#define DEBUG_SMF_PARSER                0x1FFF
+
+static_assert((SMF_CACHE_LINE_SIZE & (SMF_CACHE_LINE_SIZE - 1)) == 0,
+        "SMF_CACHE_LINE_SIZE must be a power of two!");
+
+cuint32_t constHeaderChunkId            = 0x4D546864;   //!< "MThd"
+cuint32_t constTrackChunkId             = 0x4D54726B;   //!< "MTrk"
+cuint32_t constCacheInvalid             = 0xFFFFFFFF;   //!< Empty cache line tag
+cuint32_t constDefaultTempo             = 500000;       //!< 120 BPM, in us per quarter note
+cuint8_t constMetaEndOfTrack            = 0x2F;         //!< End of track meta event
+cuint8_t constMetaSetTempo              = 0x51;         //!< Set tempo meta event
+cuint8_t constTimeChunkTicks            = 250;          //!< Keeps ticks * tempo within 32 bits
+
+// =============================================================================
+// File exclusive - New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// File exclusive - Global variables
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// File exclusive - Macro-functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Class constructors
+// =============================================================================
+
+SmfParser::SmfParser(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("SmfParser::SmfParser(void)", DEBUG_SMF_PARSER);
+
+    // Reset data members
+    this->_read                         = nullptr;
+    this->_handle                       = nullptr;
+    for(uint8_t i = 0; i < SMF_MAX_TRACKS; i++) {
+        this->_cacheOffset[i]           = constCacheInvalid;
+        this->_cacheLength[i]           = 0;
+    }
+    this->_trackCount                   = 0;
+    this->_format                       = 0;
+    this->_currentTick                  = 0;
+    this->_timeMs                       = 0;
+    this->_timeRemainder                = 0;
+    this->_tempo                        = constDefaultTempo;
+    this->_ticksPerQuarter              = 0;
+    this->_isOpen                       = false;
+    this->_isFinished                   = true;
+    this->_isTimecodeBased              = false;
+
+    // Returns successfully
+    this->_lastError                    = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_SMF_PARSER);
+    return;
+}
+
+SmfParser::~SmfParser(void)
+{
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_SMF_PARSER);
+    return;
+}
+
+// =============================================================================
+// Class public methods
+// =============================================================================
+
+//     ///////////////////     CONFIGURATION     ////////////////////     //
+bool_t SmfParser::open(SmfReadFunction read_p, void *handle_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("SmfParser::open(SmfReadFunction, void *)", DEBUG_SMF_PARSER);
+
+    // Local variables
+    uint32_t offset = 0;
+    uint32_t chunkId = 0;
+    uint32_t chunkSize = 0;
+    uint32_t aux32 = 0;
+    uint16_t declaredTracks = 0;
+    uint8_t framesPerSecond = 0;
+    Track *track;
+
+    // Checks for errors
+    if(!isPointerValid(read_p)) {
+        // Returns error
+        this->_lastError = Error::FUNCTION_POINTER_NULL;
+        debugMessage(Error::FUNCTION_POINTER_NULL, DEBUG_SMF_PARSER);
+        return false;
+    }
+
+    // Reset data members
+    this->_read                         = read_p;
+    this->_handle                       = handle_p;
+    for(uint8_t i = 0; i < SMF_MAX_TRACKS; i++) {
+        this->_cacheOffset[i]           = constCacheInvalid;
+    }
+    this->_trackCount                   = 0;
+    this->_currentTick                  = 0;
+    this->_timeMs                       = 0;
+    this->_timeRemainder                = 0;
+    this->_tempo                        = constDefaultTempo;
+    this->_isOpen                       = false;
+    this->_isFinished                   = true;
+    this->_isTimecodeBased              = false;
+
+    // Read header chunk
+    if(!this->_readBigEndian(0, &offset, 4, &chunkId) || !this->_readBigEndian(0, &offset, 4, &chunkSize)) {
+        // Returns error
+        debugMessage(this->_lastError, DEBUG_SMF_PARSER);
+        return false;
+    }
+    if((chunkId != constHeaderChunkId) || (chunkSize < 6)) {
+        // Returns error
+        this->_lastError = Error::VALID_DATA_NOT_AVAILABLE;
+        debugMessage(Error::VALID_DATA_NOT_AVAILABLE, DEBUG_SMF_PARSER);
+        return false;
+    }
+    if(!this->_readBigEndian(0, &offset, 2, &aux32)) {
+        // Returns error
+        debugMessage(this->_lastError, DEBUG_SMF_PARSER);
+        return false;
+    }
+    this->_format = (uint8_t)aux32;
+    if(!this->_readBigEndian(0, &offset, 2, &aux32)) {
+        // Returns error
+        debugMessage(this->_lastError, DEBUG_SMF_PARSER);
+        return false;
+    }
+    declaredTracks = (uint16_t)aux32;
+    if((this->_format > 1) || (declaredTracks == 0) || ((this->_format == 0) && (declaredTracks != 1))) {
+        // Returns error
+        this->_lastError = Error::FEATURE_NOT_SUPPORTED;
+        debugMessage(Error::FEATURE_NOT_SUPPORTED, DEBUG_SMF_PARSER);
+        return false;
+    }
+    if(declaredTracks > SMF_MAX_TRACKS) {
+        // Returns error
+        this->_lastError = Error::BUFFER_SIZE_TOO_SMALL;
+        debugMessage(Error::BUFFER_SIZE_TOO_SMALL, DEBUG_SMF_PARSER);
+        return false;
+    }
+
+    // Division - ticks per quarter note or SMPTE frames
+    if(!this->_readBigEndian(0, &offset, 2, &aux32)) {
+        // Returns error
+        debugMessage(this->_lastError, DEBUG_SMF_PARSER);
+        return false;
+    }
+    if(isBitSet(aux32, 15)) {
+        // Timecode based time: 1 s every (fps * ticks per frame) ticks
+        framesPerSecond = (uint8_t)(-(int8_t)(aux32 >> 8));
+        if(framesPerSecond == 29) {
+            framesPerSecond = 30;
+        }
+        this->_ticksPerQuarter = (uint16_t)framesPerSecond * (uint8_t)aux32;
+        this->_tempo = 1000000;
+        this->_isTimecodeBased = true;
+    } else {
+        this->_ticksPerQuarter = (uint16_t)aux32;
+    }
+    if(this->_ticksPerQuarter == 0) {
+        // Returns error
+        this->_lastError = Error::VALID_DATA_NOT_AVAILABLE;
+        debugMessage(Error::VALID_DATA_NOT_AVAILABLE, DEBUG_SMF_PARSER);
+        return false;
+    }
+
+    // Locate track chunks, skipping unknown chunks
+    offset = 8 + chunkSize;
+    while(this->_trackCount < declaredTracks) {
+        if(!this->_readBigEndian(0, &offset, 4, &chunkId) || !this->_readBigEndian(0, &offset, 4, &chunkSize)) {
+            // Returns error
+            debugMessage(this->_lastError, DEBUG_SMF_PARSER);
+            return false;
+        }
+        if(chunkId == constTrackChunkId) {
+            track = &this->_track[this->_trackCount];
+            track->position = offset;
+            track->end = offset + chunkSize;
+            track->runningStatus = 0;
+            track->isFinished = (chunkSize == 0);
+            if(!track->isFinished) {
+                if(!this->_readVariableLength(this->_trackCount, &track->position, &track->nextTick)) {
+                    // Returns error
+                    debugMessage(this->_lastError, DEBUG_SMF_PARSER);
+                    return false;
+                }
+            }
+            this->_trackCount++;
+        }
+        offset += chunkSize;
+    }
+
+    // Update data members
+    this->_isOpen                       = true;
+    this->_isFinished                   = false;
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_SMF_PARSER);
+    return true;
+}
+
+//     ////////////////////    DATA TRANSFER     ////////////////////     //
+bool_t SmfParser::getNextEvent(SmfEvent *event_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("SmfParser::getNextEvent(SmfEvent *)", DEBUG_SMF_PARSER);
+
+    // Local variables
+    Track *track;
+    uint8_t line = 0;
+    uint8_t status;
+    uint8_t metaType;
+    uint32_t length;
+    uint32_t delta;
+    bool_t eventFound;
+
+    // Checks for errors
+    if(!this->_isOpen) {
+        // Returns error
+        this->_lastError = Error::NOT_INITIALIZED;
+        debugMessage(Error::NOT_INITIALIZED, DEBUG_SMF_PARSER);
+        return false;
+    }
+    if(!isPointerValid(event_p)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_POINTER_NULL;
+        debugMessage(Error::ARGUMENT_POINTER_NULL, DEBUG_SMF_PARSER);
+        return false;
+    }
+
+    do {
+        // Select the track with the earliest event
+        track = nullptr;
+        for(uint8_t i = 0; i < this->_trackCount; i++) {
+            if(!this->_track[i].isFinished &&
+                    ((track == nullptr) || (this->_track[i].nextTick < track->nextTick))) {
+                track = &this->_track[i];
+                line = i;
+            }
+        }
+        if(track == nullptr) {
+            // End of file
+            this->_isFinished = true;
+            this->_lastError = Error::NONE;
+            debugMessage(Error::NONE, DEBUG_SMF_PARSER);
+            return false;
+        }
+        this->_advanceTime(track->nextTick - this->_currentTick);
+        this->_currentTick = track->nextTick;
+
+        // Status byte or running status
+        eventFound = false;
+        if(!this->_readByte(line, &track->position, &status)) {
+            // Returns error
+            debugMessage(this->_lastError, DEBUG_SMF_PARSER);
+            return false;
+        }
+        if(status < 0x80) {
+            if(track->runningStatus == 0) {
+                // Returns error
+                this->_lastError = Error::VALID_DATA_NOT_AVAILABLE;
+                debugMessage(Error::VALID_DATA_NOT_AVAILABLE, DEBUG_SMF_PARSER);
+                return false;
+            }
+            event_p->data[1] = status;
+            status = track->runningStatus;
+            event_p->size = 2;
+        } else {
+            event_p->size = 1;
+        }
+
+        if(status < 0xF0) {
+            // Channel message
+            track->runningStatus = status;
+            event_p->data[0] = status;
+            while(event_p->size < ((((status & 0xE0) == 0xC0)) ? 2 : 3)) {
+                if(!this->_readByte(line, &track->position, &event_p->data[event_p->size])) {
+                    // Returns error
+                    debugMessage(this->_lastError, DEBUG_SMF_PARSER);
+                    return false;
+                }
+                event_p->size++;
+            }
+            eventFound = true;
+        } else if((status == 0xFF) || (status == 0xF0) || (status == 0xF7)) {
+            // Meta and System Exclusive events cancel running status
+            track->runningStatus = 0;
+            metaType = 0;
+            if(status == 0xFF) {
+                if(!this->_readByte(line, &track->position, &metaType)) {
+                    // Returns error
+                    debugMessage(this->_lastError, DEBUG_SMF_PARSER);
+                    return false;
+                }
+            }
+            if(!this->_readVariableLength(line, &track->position, &length)) {
+                // Returns error
+                debugMessage(this->_lastError, DEBUG_SMF_PARSER);
+                return false;
+            }
+            if((metaType == constMetaSetTempo) && (length == 3) && !this->_isTimecodeBased) {
+                if(!this->_readBigEndian(line, &track->position, 3, &this->_tempo)) {
+                    // Returns error
+                    debugMessage(this->_lastError, DEBUG_SMF_PARSER);
+                    return false;
+                }
+            } else {
+                track->position += length;
+            }
+            if(metaType == constMetaEndOfTrack) {
+                track->isFinished = true;
+            }
+        } else {
+            // Returns error
+            this->_lastError = Error::VALID_DATA_NOT_AVAILABLE;
+            debugMessage(Error::VALID_DATA_NOT_AVAILABLE, DEBUG_SMF_PARSER);
+            return false;
+        }
+
+        // Schedule the next event of the track
+        if(track->position >= track->end) {
+            track->isFinished = true;
+        }
+        if(!track->isFinished) {
+            if(!this->_readVariableLength(line, &track->position, &delta)) {
+                // Returns error
+                debugMessage(this->_lastError, DEBUG_SMF_PARSER);
+                return false;
+            }
+            track->nextTick += delta;
+        }
+    } while(!eventFound);
+
+    // Update function arguments
+    event_p->time = this->_timeMs;
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_SMF_PARSER);
+    return true;
+}
+
+//     /////////////////     CONTROL AND STATUS     /////////////////     //
+Error SmfParser::getLastError(void)
+{
+    // Returns last error
+    return this->_lastError;
+}
+
+// =============================================================================
+// Class private methods
+// =============================================================================
+
+//     //////////////////////     STORAGE     ///////////////////////     //
+bool_t SmfParser::_readByte(cuint8_t line_p, uint32_t *offset_p, uint8_t *value_p)
+{
+    // Local variables
+    uint8_t *cache = this->_cache[line_p];
+
+    // Cache miss - refill the line of the track
+    if((this->_cacheOffset[line_p] == constCacheInvalid) ||
+            ((*offset_p - this->_cacheOffset[line_p]) >= this->_cacheLength[line_p])) {
+        this->_cacheOffset[line_p] = *offset_p & ~((uint32_t)(SMF_CACHE_LINE_SIZE - 1));
+        this->_cacheLength[line_p] = this->_read(this->_handle, this->_cacheOffset[line_p],
+                        cache, SMF_CACHE_LINE_SIZE);
+        if((*offset_p - this->_cacheOffset[line_p]) >= this->_cacheLength[line_p]) {
+            // Returns error
+            this->_cacheOffset[line_p] = constCacheInvalid;
+            this->_lastError = Error::VALID_DATA_NOT_AVAILABLE;
+            return false;
+        }
+    }
+
+    // Cache hit
+    *value_p = cache[*offset_p - this->_cacheOffset[line_p]];
+    (*offset_p)++;
+
+    return true;
+}
+
+bool_t SmfParser::_readBigEndian(cuint8_t line_p, uint32_t *offset_p, cuint8_t size_p, uint32_t *value_p)
+{
+    // Local variables
+    uint8_t aux8;
+
+    *value_p = 0;
+    for(uint8_t i = 0; i < size_p; i++) {
+        if(!this->_readByte(line_p, offset_p, &aux8)) {
+            return false;
+        }
+        *value_p = (*value_p << 8) | aux8;
+    }
+
+    return true;
+}
+
+bool_t SmfParser::_readVariableLength(cuint8_t line_p, uint32_t *offset_p, uint32_t *value_p)
+{
+    // Local variables
+    uint8_t aux8;
+
+    // Up to four bytes, seven bits each
+    *value_p = 0;
+    for(uint8_t i = 0; i < 4; i++) {
+        if(!this->_readByte(line_p, offset_p, &aux8)) {
+            return false;
+        }
+        *value_p = (*value_p << 7) | (aux8 & 0x7F);
+        if(isBitClr(aux8, 7)) {
+            return true;
+        }
+    }
+
+    // Returns error
+    this->_lastError = Error::VALID_DATA_NOT_AVAILABLE;
+    return false;
+}
+
+//     ///////////////////////     TIMING     ///////////////////////     //
+void SmfParser::_advanceTime(uint32_t ticks_p)
+{
+    // Local variables
+    uint32_t divisor = (uint32_t)this->_ticksPerQuarter * 1000;
+    uint32_t numerator;
+    uint8_t chunk;
+
+    // ms = ticks * tempo / (ticksPerQuarter * 1000), keeping the remainder so
+    // that rounding errors never accumulate
+    while(ticks_p > 0) {
+        chunk = (ticks_p > constTimeChunkTicks) ? constTimeChunkTicks : (uint8_t)ticks_p;
+        ticks_p -= chunk;
+        numerator = ((uint32_t)chunk * this->_tempo) + this->_timeRemainder;
+        this->_timeMs += numerator / divisor;
+        this->_timeRemainder = numerator % divisor;
+    }
+
+    return;
+}
+
+// =============================================================================
+// Class protected methods
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// General public functions definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
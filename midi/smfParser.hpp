@@ -0,0 +1,318 @@
+//!
+//! \file           smfParser.hpp
+//! \brief          Streaming Standard MIDI File parser
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Parses type 0 and type 1 Standard MIDI Files directly from
+//!                     storage, through a small read cache line per track,
+//!                     merging the tracks by time. The file is accessed only
+//!                     through a user-supplied read function, and the parser
+//!                     depends only on smfPortability.hpp, so it builds and
+//!                     is tested on the host (see test/smfParserTest.cpp).
+//!                     With FatFs, the read function is:
+//!
+//!                     uint16_t fatFsRead(void *file_p, cuint32_t offset_p,
+//!                             uint8_t *buffer_p, cuint16_t size_p)
+//!                     {
+//!                         UINT bytesRead = 0;
+//!                         if(f_lseek((FIL *)file_p, offset_p) != FR_OK) {
+//!                             return 0;
+//!                         }
+//!                         if(f_read((FIL *)file_p, buffer_p, size_p, &bytesRead) != FR_OK) {
+//!                             return 0;
+//!                         }
+//!                         return (uint16_t)bytesRead;
+//!                     }
+//!
+
+// =============================================================================
+// Include guard (START)
+// =============================================================================
+
+#ifndef __SMF_PARSER_HPP
+#define __SMF_PARSER_HPP                        2304
+
+// =============================================================================
+// Dependencies
+// =============================================================================
+
+//     //////////////////     LIBRARY DEPENDENCIES     //////////////////     //
+#include "smfPortability.hpp"
+#if !defined(__SMF_PORTABILITY_HPP)
+#   error "Header file (smfPortability.hpp) is corrupted!"
+#elif __SMF_PORTABILITY_HPP != __SMF_PARSER_HPP
+#   error "Version mismatch between header file and library dependency (smfPortability.hpp)!"
+#endif
+
+// =============================================================================
+// Undefining previous definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Constant definitions
+// =============================================================================
+
+#ifndef SMF_CACHE_LINE_SIZE
+//!
+//! \brief          Size of the cache line of each track, in bytes
+//! \details        Must be a power of two. Each track reads from its own
+//!                     region of the file, so each one has its own line; a
+//!                     line is refilled only when its track crosses it.
+//!
+#   define SMF_CACHE_LINE_SIZE          16
+#endif
+
+#ifndef SMF_MAX_TRACKS
+//!
+//! \brief          Maximum number of tracks merged by the parser
+//!
+#   define SMF_MAX_TRACKS               8
+#endif
+
+// =============================================================================
+// New data types
+// =============================================================================
+
+//!
+//! \brief          Storage read function
+//! \details        Reads up to size_p bytes starting at offset_p.
+//! \param          handle_p            Opaque file handle given to open()
+//! \param          offset_p            Offset from the beginning of the file
+//! \param          buffer_p            Destination buffer
+//! \param          size_p              Number of bytes requested
+//! \return         uint16_t            Number of bytes read (0 on error or at
+//!                                         the end of the file)
+//!
+typedef uint16_t (*SmfReadFunction)(
+        void *handle_p,
+        cuint32_t offset_p,
+        uint8_t *buffer_p,
+        cuint16_t size_p
+);
+
+//!
+//! \brief          MIDI channel event read from the file
+//!
+typedef struct {
+    uint32_t    time;                   //!< Time since the beginning, in ms
+    uint8_t     data[3];                //!< Status byte and data bytes
+    uint8_t     size;                   //!< Number of valid bytes in data
+} SmfEvent;
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// SmfParser Class
+// =============================================================================
+
+//!
+//! \brief          SmfParser class
+//! \details        Returns the channel events of the file in time order.
+//!                     Tempo changes are applied while parsing; other meta
+//!                     events and System Exclusive events are skipped.
+//!
+class SmfParser
+{
+    // -------------------------------------------------------------------------
+    // New data types ----------------------------------------------------------
+private:
+    //!
+    //! \brief      Track parsing state
+    //!
+    typedef struct {
+        uint32_t    position;           //!< Offset of the next event
+        uint32_t    end;                //!< Offset of the end of the chunk
+        uint32_t    nextTick;           //!< Absolute tick of the next event
+        uint8_t     runningStatus;      //!< Running status of the track
+        bool_t      isFinished;         //!< End of track reached
+    } Track;
+
+    // -------------------------------------------------------------------------
+    // Constructors ------------------------------------------------------------
+public:
+    //!
+    //! \brief      SmfParser class constructor
+    //! \details    Creates a SmfParser object
+    //!
+    SmfParser(
+            void
+    );
+
+    //!
+    //! \brief      SmfParser class destructor
+    //! \details    Destroys a SmfParser object
+    //!
+    ~SmfParser(
+            void
+    );
+
+    // -------------------------------------------------------------------------
+    // Methods -----------------------------------------------------------------
+public:
+    //     ///////////////////     CONFIGURATION     ////////////////////     //
+
+    //!
+    //! \brief      Opens a file
+    //! \details    Reads the file header and locates the track chunks. Type 2
+    //!                 files are not supported.
+    //! \param      read_p              Storage read function
+    //! \param      handle_p            Opaque file handle passed to read_p
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t open(
+            SmfReadFunction read_p,
+            void *handle_p
+    );
+
+    //     ////////////////////    DATA TRANSFER     ////////////////////     //
+
+    //!
+    //! \brief      Reads the next channel event
+    //! \details    Reads the next channel event of the merged tracks. Events
+    //!                 with the same time are returned in track order.
+    //! \param      event_p             Pointer to store the event
+    //! \return     bool_t              True on success / False at the end of
+    //!                                     the file or on failure
+    //!
+    bool_t getNextEvent(
+            SmfEvent *event_p
+    );
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+
+    //!
+    //! \brief      Checks if every track was read
+    //! \details    Checks if every track was read.
+    //! \return     bool_t              True at the end of the file / False
+    //!                                     otherwise
+    //!
+    bool_t inlined isFinished(
+            void
+    );
+
+    //!
+    //! \brief      Returns the file format
+    //! \details    Returns the file format (0 or 1).
+    //! \return     uint8_t             File format
+    //!
+    uint8_t inlined getFormat(
+            void
+    );
+
+    //!
+    //! \brief      Returns the number of tracks
+    //! \details    Returns the number of tracks.
+    //! \return     uint8_t             Number of tracks
+    //!
+    uint8_t inlined getTrackCount(
+            void
+    );
+
+    //!
+    //! \brief      Returns the last error
+    //! \details    Returns the last error.
+    //! \return     Error               Error status of the last operation
+    //!
+    Error getLastError(
+            void
+    );
+
+private:
+    //     //////////////////////     STORAGE     ///////////////////////     //
+    bool_t _readByte(
+            cuint8_t line_p,
+            uint32_t *offset_p,
+            uint8_t *value_p
+    );
+
+    bool_t _readBigEndian(
+            cuint8_t line_p,
+            uint32_t *offset_p,
+            cuint8_t size_p,
+            uint32_t *value_p
+    );
+
+    bool_t _readVariableLength(
+            cuint8_t line_p,
+            uint32_t *offset_p,
+            uint32_t *value_p
+    );
+
+    //     ///////////////////////     TIMING     ///////////////////////     //
+    void _advanceTime(
+            uint32_t ticks_p
+    );
+
+protected:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Properties --------------------------------------------------------------
+private:
+    //     //////////////////////     STORAGE     ///////////////////////     //
+    SmfReadFunction     _read;
+    void                *_handle;
+    uint8_t             _cache[SMF_MAX_TRACKS][SMF_CACHE_LINE_SIZE];
+    uint32_t            _cacheOffset[SMF_MAX_TRACKS];
+    uint16_t            _cacheLength[SMF_MAX_TRACKS];
+
+    //     ///////////////////////     TRACKS     ///////////////////////     //
+    Track               _track[SMF_MAX_TRACKS];
+    uint8_t             _trackCount;
+    uint8_t             _format;
+
+    //     ///////////////////////     TIMING     ///////////////////////     //
+    uint32_t            _currentTick;
+    uint32_t            _timeMs;
+    uint32_t            _timeRemainder;
+    uint32_t            _tempo;
+    uint16_t            _ticksPerQuarter;
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+    bool_t              _isOpen                         : 1;
+    bool_t              _isFinished                     : 1;
+    bool_t              _isTimecodeBased                : 1;
+    Error               _lastError;
+}; // class SmfParser
+
+// =============================================================================
+// SmfParser - Class inline function definitions
+// =============================================================================
+
+bool_t inlined SmfParser::isFinished(void)
+{
+    return this->_isFinished;
+}
+
+uint8_t inlined SmfParser::getFormat(void)
+{
+    return this->_format;
+}
+
+uint8_t inlined SmfParser::getTrackCount(void)
+{
+    return this->_trackCount;
+}
+
+// =============================================================================
+// External global variables
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Include guard (END)
+// =============================================================================
+
+#endif  // __SMF_PARSER_HPP
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
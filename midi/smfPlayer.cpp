@@ -0,0 +1,192 @@
+//!
+//! \file           smfPlayer.cpp
+//! \brief          Standard MIDI File player
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Standard MIDI File player
+//!
+
+// =============================================================================
+// System file dependencies
+// =============================================================================
+
+#include "smfPlayer.hpp"
+#if !defined(__SMF_PLAYER_HPP)
+#    error "Header file is corrupted!"
+#elif __SMF_PLAYER_HPP != 2304
+#    error "Version mismatch between source and header files!"
+#endif
+
+// =============================================================================
+// File exclusive - Constants
+// =============================================================================
+
+#define DEBUG_SMF_PLAYER                0x1FFF
+
+// =============================================================================
+// File exclusive - New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// File exclusive - Global variables
+// =============================================================================
+
+SmfPlayer smfPlayer;
+
+// =============================================================================
+// File exclusive - Macro-functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Class constructors
+// =============================================================================
+
+SmfPlayer::SmfPlayer(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("SmfPlayer::SmfPlayer(void)", DEBUG_SMF_PLAYER);
+
+    // Reset data members
+    this->_parser                       = nullptr;
+    this->_elapsedTime                  = 0;
+    this->_lastTick                     = 0;
+    this->_isPlaying                    = false;
+    this->_hasNextEvent                 = false;
+
+    // Returns successfully
+    this->_lastError                    = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_SMF_PLAYER);
+    return;
+}
+
+SmfPlayer::~SmfPlayer(void)
+{
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_SMF_PLAYER);
+    return;
+}
+
+// =============================================================================
+// Class public methods
+// =============================================================================
+
+//     ////////////////////     PLAYBACK     ////////////////////////     //
+bool_t SmfPlayer::play(SmfParser *parser_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("SmfPlayer::play(SmfParser *)", DEBUG_SMF_PLAYER);
+
+    // Checks for errors
+    if(!isPointerValid(parser_p)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_POINTER_NULL;
+        debugMessage(Error::ARGUMENT_POINTER_NULL, DEBUG_SMF_PLAYER);
+        return false;
+    }
+
+    // Stop current file
+    if(this->_isPlaying) {
+        this->stop();
+    }
+
+    // Update data members
+    this->_parser                       = parser_p;
+    this->_elapsedTime                  = 0;
+    this->_lastTick                     = (uint16_t)systemTick.getMilliseconds();
+    this->_hasNextEvent                 = false;
+    this->_isPlaying                    = true;
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_SMF_PLAYER);
+    return true;
+}
+
+void SmfPlayer::stop(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("SmfPlayer::stop(void)", DEBUG_SMF_PLAYER);
+
+    // Stop playback and switch off the sounding notes
+    this->_isPlaying                    = false;
+    this->_hasNextEvent                 = false;
+    voiceTracker.panic();
+
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_SMF_PLAYER);
+    return;
+}
+
+void SmfPlayer::process(void)
+{
+    // Local variables
+    uint16_t now;
+
+    // Checks if playing
+    if(!this->_isPlaying) {
+        return;
+    }
+
+    // Extend the 16-bit tick to the 32-bit event time scale
+    now = (uint16_t)systemTick.getMilliseconds();
+    this->_elapsedTime += (uint16_t)(now - this->_lastTick);
+    this->_lastTick = now;
+
+    // Send every due event
+    while(true) {
+        if(!this->_hasNextEvent) {
+            if(!this->_parser->getNextEvent(&this->_nextEvent)) {
+                // End of file or read failure
+                this->_lastError = this->_parser->getLastError();
+                this->_isPlaying = false;
+                return;
+            }
+            this->_hasNextEvent = true;
+        }
+        if(this->_nextEvent.time > this->_elapsedTime) {
+            return;
+        }
+        channelState.sendMessage(this->_nextEvent.data, this->_nextEvent.size);
+        this->_hasNextEvent = false;
+    }
+}
+
+//     /////////////////     CONTROL AND STATUS     /////////////////     //
+Error SmfPlayer::getLastError(void)
+{
+    // Returns last error
+    return this->_lastError;
+}
+
+// =============================================================================
+// Class private methods
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Class protected methods
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// General public functions definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
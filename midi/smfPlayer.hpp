@@ -0,0 +1,214 @@
+//!
+//! \file           smfPlayer.hpp
+//! \brief          Standard MIDI File player
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Streams the events of a SmfParser to the MIDI output at
+//!                     their time, using the system timebase millisecond
+//!                     tick. Only one event is read ahead, so the
+//!                     file is never loaded into memory.
+//!
+
+// =============================================================================
+// Include guard (START)
+// =============================================================================
+
+#ifndef __SMF_PLAYER_HPP
+#define __SMF_PLAYER_HPP                        2304
+
+// =============================================================================
+// Dependencies
+// =============================================================================
+
+//     /////////////////     GLOBAL DEFINITIONS FILE    /////////////////     //
+#include "../funsape/globalDefines.hpp"
+#if !defined(__GLOBAL_DEFINES_HPP)
+#   error "Global definitions file is corrupted!"
+#elif __GLOBAL_DEFINES_HPP != __SMF_PLAYER_HPP
+#   error "Version mismatch between file header and global definitions file!"
+#endif
+
+//     //////////////////     LIBRARY DEPENDENCIES     //////////////////     //
+#include "channelState.hpp"
+#if !defined(__CHANNEL_STATE_HPP)
+#   error "Header file (channelState.hpp) is corrupted!"
+#elif __CHANNEL_STATE_HPP != __SMF_PLAYER_HPP
+#   error "Version mismatch between header file and library dependency (channelState.hpp)!"
+#endif
+
+#include "../funsape/util/systemTick.hpp"
+#if !defined(__SYSTEM_TICK_HPP)
+#   error "Header file (systemTick.hpp) is corrupted!"
+#elif __SYSTEM_TICK_HPP != __SMF_PLAYER_HPP
+#   error "Version mismatch between header file and library dependency (systemTick.hpp)!"
+#endif
+
+#include "smfParser.hpp"
+#if !defined(__SMF_PARSER_HPP)
+#   error "Header file (smfParser.hpp) is corrupted!"
+#elif __SMF_PARSER_HPP != __SMF_PLAYER_HPP
+#   error "Version mismatch between header file and library dependency (smfParser.hpp)!"
+#endif
+
+// =============================================================================
+// Undefining previous definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Constant definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// SmfPlayer Class
+// =============================================================================
+
+//!
+//! \brief          SmfPlayer class
+//! \details        Plays an opened SmfParser. The system timebase must be
+//!                     running before use.
+//!
+class SmfPlayer
+{
+    // -------------------------------------------------------------------------
+    // New data types ----------------------------------------------------------
+public:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Constructors ------------------------------------------------------------
+public:
+    //!
+    //! \brief      SmfPlayer class constructor
+    //! \details    Creates a SmfPlayer object
+    //!
+    SmfPlayer(
+            void
+    );
+
+    //!
+    //! \brief      SmfPlayer class destructor
+    //! \details    Destroys a SmfPlayer object
+    //!
+    ~SmfPlayer(
+            void
+    );
+
+    // -------------------------------------------------------------------------
+    // Methods -----------------------------------------------------------------
+public:
+    //     ////////////////////     PLAYBACK     ////////////////////////     //
+
+    //!
+    //! \brief      Starts playing a file
+    //! \details    Starts playing a file. The parser must have been opened.
+    //! \param      parser_p            Pointer to the opened parser
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t play(
+            SmfParser *parser_p
+    );
+
+    //!
+    //! \brief      Stops the playback
+    //! \details    Stops the playback and switches off every sounding note.
+    //!
+    void stop(
+            void
+    );
+
+    //!
+    //! \brief      Sends every due event
+    //! \details    Reads the file and sends every event whose time has come.
+    //!                 Must be called periodically from the main loop.
+    //!
+    void process(
+            void
+    );
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+
+    //!
+    //! \brief      Checks if a file is playing
+    //! \details    Checks if a file is playing.
+    //! \return     bool_t              True if playing / False otherwise
+    //!
+    bool_t inlined isPlaying(
+            void
+    );
+
+    //!
+    //! \brief      Returns the last error
+    //! \details    Returns the last error. Parser errors found during the
+    //!                 playback are reported here.
+    //! \return     Error               Error status of the last operation
+    //!
+    Error getLastError(
+            void
+    );
+
+private:
+    // NONE
+
+protected:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Properties --------------------------------------------------------------
+private:
+    //     ////////////////////     PLAYBACK     ////////////////////////     //
+    SmfParser           *_parser;
+    SmfEvent            _nextEvent;
+    uint32_t            _elapsedTime;
+    uint16_t            _lastTick;
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+    bool_t              _isPlaying                      : 1;
+    bool_t              _hasNextEvent                   : 1;
+    Error               _lastError;
+}; // class SmfPlayer
+
+// =============================================================================
+// SmfPlayer - Class inline function definitions
+// =============================================================================
+
+bool_t inlined SmfPlayer::isPlaying(void)
+{
+    return this->_isPlaying;
+}
+
+// =============================================================================
+// External global variables
+// =============================================================================
+
+//!
+//! \brief          MIDI file player handler object
+//! \details        MIDI file player handler object
+//!
+extern SmfPlayer smfPlayer;
+
+// =============================================================================
+// Include guard (END)
+// =============================================================================
+
+#endif  // __SMF_PLAYER_HPP
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
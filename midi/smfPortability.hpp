@@ -0,0 +1,96 @@
+//!
+//! \file           smfPortability.hpp
+//! \brief          Definitions used by the Standard MIDI File parser
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        On the target, takes the definitions from the library.
+//!                     When SMF_HOST_BUILD is defined, as in a host build where
+//!                     the AVR headers are not available, provides the few
+//!                     types, error codes and macros used by the parser, so
+//!                     that it can be built and tested there.
+//!
+
+// =============================================================================
+// Include guard (START)
+// =============================================================================
+
+#ifndef __SMF_PORTABILITY_HPP
+#define __SMF_PORTABILITY_HPP                   2304
+
+// =============================================================================
+// Dependencies
+// =============================================================================
+
+#if !defined(SMF_HOST_BUILD)
+
+//     /////////////////     GLOBAL DEFINITIONS FILE    /////////////////     //
+#include "../funsape/globalDefines.hpp"
+#if !defined(__GLOBAL_DEFINES_HPP)
+#   error "Global definitions file is corrupted!"
+#elif __GLOBAL_DEFINES_HPP != __SMF_PORTABILITY_HPP
+#   error "Version mismatch between file header and global definitions file!"
+#endif
+
+//     //////////////////     LIBRARY DEPENDENCIES     //////////////////     //
+#include "../funsape/util/debug.hpp"
+#if !defined(__DEBUG_HPP)
+#   error "Header file (debug.hpp) is corrupted!"
+#elif __DEBUG_HPP != __SMF_PORTABILITY_HPP
+#   error "Version mismatch between header file and library dependency (debug.hpp)!"
+#endif
+
+#else
+
+//     ///////////////////     STANDARD C LIBRARY     ///////////////////     //
+#include <stdint.h>
+
+// =============================================================================
+// Constant definitions
+// =============================================================================
+
+#define inlined                         inline __attribute__((always_inline))
+
+#define debugMessage(errorCode, module)         {}
+#define debugMark(string, module)               {}
+
+#define isPointerValid(ptr)             (       \
+        ((void *)(ptr))                         \
+        ? (bool_t)true                          \
+        : (bool_t)false)
+#define isBitSet(reg, bit)                      (((reg) >> (bit)) & 1)
+#define isBitClr(reg, bit)                      (!isBitSet(reg,bit))
+
+// =============================================================================
+// New data types
+// =============================================================================
+
+typedef bool                            bool_t;
+typedef const uint8_t                   cuint8_t;
+typedef const uint16_t                  cuint16_t;
+typedef const uint32_t                  cuint32_t;
+
+//!
+//! \brief          Error codes used by the parser, with the library values
+//!
+enum class Error : cuint16_t {
+    NONE                                = 0x0000,
+    NOT_INITIALIZED                     = 0x0004,
+    FEATURE_NOT_SUPPORTED               = 0x0007,
+    FUNCTION_POINTER_NULL               = 0x0008,
+    ARGUMENT_POINTER_NULL               = 0x0011,
+    BUFFER_SIZE_TOO_SMALL               = 0x0026,
+    VALID_DATA_NOT_AVAILABLE            = 0xFFF7,
+};
+
+#endif
+
+// =============================================================================
+// Include guard (END)
+// =============================================================================
+
+#endif  // __SMF_PORTABILITY_HPP
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
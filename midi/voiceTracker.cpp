@@ -0,0 +1,334 @@
+//!
+//! \file           voiceTracker.cpp
+//! \brief          Active note and voice tracker
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Active note and voice tracker
+//!
+
+// =============================================================================
+// System file dependencies
+// =============================================================================
+
+#include "voiceTracker.hpp"
+#if !defined(__VOICE_TRACKER_HPP)
+#    error "Header file is corrupted!"
+#elif __VOICE_TRACKER_HPP != 2304
+#    error "Version mismatch between source and header files!"
+#endif
+
+// =============================================================================
+// File exclusive - Constants
+// =============================================================================
+
+#define DEBUG_VOICE_TRACKER             0x1FFF
+
+cuint8_t constControlAllSoundOff        = 120;      //!< All Sound Off controller number
+cuint8_t constControlAllNotesOff        = 123;      //!< All Notes Off controller number
+
+// =============================================================================
+// File exclusive - New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// File exclusive - Global variables
+// =============================================================================
+
+VoiceTracker voiceTracker;
+
+// =============================================================================
+// File exclusive - Macro-functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Class constructors
+// =============================================================================
+
+VoiceTracker::VoiceTracker(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("VoiceTracker::VoiceTracker(void)", DEBUG_VOICE_TRACKER);
+
+    // Reset data members
+    for(uint8_t i = 0; i < 16; i++) {
+        for(uint8_t j = 0; j < 16; j++) {
+            this->_activeNotes[i][j]    = 0;
+        }
+    }
+    this->_voiceCount                   = 0;
+    this->_polyphony                    = VOICE_TRACKER_VOICES;
+    this->_stolenCount                  = 0;
+
+    // Returns successfully
+    this->_lastError                    = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_VOICE_TRACKER);
+    return;
+}
+
+VoiceTracker::~VoiceTracker(void)
+{
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_VOICE_TRACKER);
+    return;
+}
+
+// =============================================================================
+// Class public methods
+// =============================================================================
+
+//     ///////////////////     CONFIGURATION     ////////////////////     //
+bool_t VoiceTracker::setPolyphony(cuint8_t polyphony_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("VoiceTracker::setPolyphony(cuint8_t)", DEBUG_VOICE_TRACKER);
+
+    // Checks for errors
+    if(polyphony_p > VOICE_TRACKER_VOICES) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_VALUE_INVALID;
+        debugMessage(Error::ARGUMENT_VALUE_INVALID, DEBUG_VOICE_TRACKER);
+        return false;
+    }
+
+    // Update data members
+    this->_polyphony = (polyphony_p == 0) ? VOICE_TRACKER_VOICES : polyphony_p;
+
+    // Steal the exceeding voices
+    while(this->_voiceCount > this->_polyphony) {
+        this->_releaseVoice(0);
+        if(this->_stolenCount != 0xFFFF) {
+            this->_stolenCount++;
+        }
+    }
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_VOICE_TRACKER);
+    return true;
+}
+
+//     ////////////////////    DATA TRANSFER     ////////////////////     //
+bool_t VoiceTracker::sendMessage(cuint8_t *message_p, cuint8_t size_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("VoiceTracker::sendMessage(cuint8_t *, cuint8_t)", DEBUG_VOICE_TRACKER);
+
+    // Local variables
+    uint8_t channel;
+
+    // Checks for errors
+    if(!isPointerValid(message_p)) {
+        // Returns error
+        this->_lastError = Error::ARGUMENT_POINTER_NULL;
+        debugMessage(Error::ARGUMENT_POINTER_NULL, DEBUG_VOICE_TRACKER);
+        return false;
+    }
+
+    // Track channel voice messages
+    channel = message_p[0] & 0x0F;
+    if(size_p == 3) {
+        switch(message_p[0] & 0xF0) {
+        case 0x90:
+            if(message_p[2] != 0) {
+                // Note On - retriggered notes become the newest voice
+                if(!this->_removeVoice(channel, message_p[1])) {
+                    if(this->_voiceCount >= this->_polyphony) {
+                        this->_releaseVoice(0);
+                        if(this->_stolenCount != 0xFFFF) {
+                            this->_stolenCount++;
+                        }
+                    }
+                }
+                this->_addVoice(channel, message_p[1]);
+                break;
+            }
+        // fall through - Note On with velocity zero is a Note Off
+        case 0x80:
+            if(!this->_removeVoice(channel, message_p[1])) {
+                // Note is not sounding (stolen or already released)
+                this->_lastError = Error::NONE;
+                debugMessage(Error::NONE, DEBUG_VOICE_TRACKER);
+                return true;
+            }
+            break;
+        case 0xB0:
+            if((message_p[1] == constControlAllSoundOff) || (message_p[1] == constControlAllNotesOff)) {
+                for(uint8_t i = this->_voiceCount; i > 0; i--) {
+                    if(this->_voiceChannel[i - 1] == channel) {
+                        this->_removeVoice(channel, this->_voicePitch[i - 1]);
+                    }
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    // Send message
+    if(!midiMerge.sendLocal(message_p, size_p)) {
+        // Returns error
+        this->_lastError = midiMerge.getLastError();
+        debugMessage(this->_lastError, DEBUG_VOICE_TRACKER);
+        return false;
+    }
+
+    // Returns successfully
+    this->_lastError = Error::NONE;
+    debugMessage(Error::NONE, DEBUG_VOICE_TRACKER);
+    return true;
+}
+
+void VoiceTracker::panic(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("VoiceTracker::panic(void)", DEBUG_VOICE_TRACKER);
+
+    // Release every voice, from the oldest to the newest
+    while(this->_voiceCount > 0) {
+        this->_releaseVoice(0);
+    }
+
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_VOICE_TRACKER);
+    return;
+}
+
+void VoiceTracker::releaseChannel(cuint8_t channel_p)
+{
+    // Mark passage for debugging purpose
+    debugMark("VoiceTracker::releaseChannel(cuint8_t)", DEBUG_VOICE_TRACKER);
+
+    // Release the voices of the channel, from the oldest to the newest
+    for(uint8_t i = 0; i < this->_voiceCount;) {
+        if(this->_voiceChannel[i] == (channel_p & 0x0F)) {
+            this->_releaseVoice(i);
+        } else {
+            i++;
+        }
+    }
+
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_VOICE_TRACKER);
+    return;
+}
+
+//     /////////////////     CONTROL AND STATUS     /////////////////     //
+void VoiceTracker::getActiveNotes(cuint8_t channel_p, uint8_t *bitmap_p)
+{
+    // Copy the channel bitmap
+    for(uint8_t i = 0; i < 16; i++) {
+        bitmap_p[i] = this->_activeNotes[channel_p & 0x0F][i];
+    }
+
+    return;
+}
+
+uint16_t VoiceTracker::getStolenCount(void)
+{
+    // Returns value
+    return this->_stolenCount;
+}
+
+void VoiceTracker::clearCounters(void)
+{
+    // Mark passage for debugging purpose
+    debugMark("VoiceTracker::clearCounters(void)", DEBUG_VOICE_TRACKER);
+
+    // Reset data members
+    this->_stolenCount                  = 0;
+
+    // Returns successfully
+    debugMessage(Error::NONE, DEBUG_VOICE_TRACKER);
+    return;
+}
+
+Error VoiceTracker::getLastError(void)
+{
+    // Returns last error
+    return this->_lastError;
+}
+
+// =============================================================================
+// Class private methods
+// =============================================================================
+
+//     ////////////////////    VOICE TABLE     //////////////////////     //
+void VoiceTracker::_addVoice(cuint8_t channel_p, cuint8_t pitch_p)
+{
+    // Append as the newest voice
+    this->_voiceChannel[this->_voiceCount] = channel_p;
+    this->_voicePitch[this->_voiceCount] = pitch_p;
+    this->_voiceCount++;
+    setBit(this->_activeNotes[channel_p][(pitch_p & 0x7F) >> 3], pitch_p & 0x07);
+
+    return;
+}
+
+bool_t VoiceTracker::_removeVoice(cuint8_t channel_p, cuint8_t pitch_p)
+{
+    // Local variables
+    uint8_t i;
+
+    // Checks if the note is sounding
+    if(!this->isSounding(channel_p, pitch_p)) {
+        return false;
+    }
+    clrBit(this->_activeNotes[channel_p][(pitch_p & 0x7F) >> 3], pitch_p & 0x07);
+
+    // Remove from the voice table, keeping the age order
+    for(i = 0; i < this->_voiceCount; i++) {
+        if((this->_voiceChannel[i] == channel_p) && (this->_voicePitch[i] == pitch_p)) {
+            break;
+        }
+    }
+    this->_voiceCount--;
+    for(; i < this->_voiceCount; i++) {
+        this->_voiceChannel[i] = this->_voiceChannel[i + 1];
+        this->_voicePitch[i] = this->_voicePitch[i + 1];
+    }
+
+    return true;
+}
+
+void VoiceTracker::_releaseVoice(cuint8_t index_p)
+{
+    // Local variables
+    uint8_t message[3];
+
+    // Switch the note off
+    message[0] = 0x90 | this->_voiceChannel[index_p];
+    message[1] = this->_voicePitch[index_p];
+    message[2] = 0;
+    this->_removeVoice(this->_voiceChannel[index_p], this->_voicePitch[index_p]);
+    midiMerge.sendLocal(message, 3);
+
+    return;
+}
+
+// =============================================================================
+// Class protected methods
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// General public functions definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
@@ -0,0 +1,295 @@
+//!
+//! \file           voiceTracker.hpp
+//! \brief          Active note and voice tracker
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Keeps track of the notes sounding on each MIDI channel,
+//!                     using a 128-bit bitmap per channel for constant-time
+//!                     queries and a voice table ordered from the oldest to
+//!                     the newest note. The voice table allows a panic that
+//!                     only switches off the notes actually sounding, and an
+//!                     optional polyphony cap that steals the oldest voice.
+//!
+//!                     Every local message must be sent through the tracker,
+//!                     which forwards it to the MIDI merge engine.
+//!
+
+// =============================================================================
+// Include guard (START)
+// =============================================================================
+
+#ifndef __VOICE_TRACKER_HPP
+#define __VOICE_TRACKER_HPP                     2304
+
+// =============================================================================
+// Dependencies
+// =============================================================================
+
+//     /////////////////     GLOBAL DEFINITIONS FILE    /////////////////     //
+#include "../funsape/globalDefines.hpp"
+#if !defined(__GLOBAL_DEFINES_HPP)
+#   error "Global definitions file is corrupted!"
+#elif __GLOBAL_DEFINES_HPP != __VOICE_TRACKER_HPP
+#   error "Version mismatch between file header and global definitions file!"
+#endif
+
+//     //////////////////     LIBRARY DEPENDENCIES     //////////////////     //
+#include "midiMerge.hpp"
+#if !defined(__MIDI_MERGE_HPP)
+#   error "Header file (midiMerge.hpp) is corrupted!"
+#elif __MIDI_MERGE_HPP != __VOICE_TRACKER_HPP
+#   error "Version mismatch between header file and library dependency (midiMerge.hpp)!"
+#endif
+
+// =============================================================================
+// Undefining previous definitions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Constant definitions
+// =============================================================================
+
+#ifndef VOICE_TRACKER_VOICES
+//!
+//! \brief          Size of the voice table (maximum number of sounding notes)
+//!
+#   define VOICE_TRACKER_VOICES         32
+#endif
+
+// =============================================================================
+// New data types
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// Interrupt callback functions
+// =============================================================================
+
+// NONE
+
+// =============================================================================
+// VoiceTracker Class
+// =============================================================================
+
+//!
+//! \brief          VoiceTracker class
+//! \details        Tracks Note On, Note Off, All Sound Off and All Notes Off
+//!                     messages. When the voice table is full, or the
+//!                     polyphony cap is reached, the oldest voice is switched
+//!                     off before the new note is sent. Note Off messages of
+//!                     notes that are not sounding are not sent.
+//!
+class VoiceTracker
+{
+    // -------------------------------------------------------------------------
+    // New data types ----------------------------------------------------------
+public:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Constructors ------------------------------------------------------------
+public:
+    //!
+    //! \brief      VoiceTracker class constructor
+    //! \details    Creates a VoiceTracker object
+    //!
+    VoiceTracker(
+            void
+    );
+
+    //!
+    //! \brief      VoiceTracker class destructor
+    //! \details    Destroys a VoiceTracker object
+    //!
+    ~VoiceTracker(
+            void
+    );
+
+    // -------------------------------------------------------------------------
+    // Methods -----------------------------------------------------------------
+public:
+    //     ///////////////////     CONFIGURATION     ////////////////////     //
+
+    //!
+    //! \brief      Sets the polyphony cap
+    //! \details    Sets the maximum number of notes sounding at the same
+    //!                 time. If more notes are sounding, the oldest ones are
+    //!                 switched off immediately.
+    //! \param      polyphony_p         Maximum number of voices (1 to
+    //!                                     VOICE_TRACKER_VOICES), or zero to
+    //!                                     use the whole voice table
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t setPolyphony(
+            cuint8_t polyphony_p
+    );
+
+    //     ////////////////////    DATA TRANSFER     ////////////////////     //
+
+    //!
+    //! \brief      Sends a locally generated message
+    //! \details    Updates the active notes and sends the message through
+    //!                 the MIDI merge engine, stealing a voice first if
+    //!                 needed.
+    //! \param      message_p           Pointer to the message bytes
+    //! \param      size_p              Number of bytes of the message (1 to 3)
+    //! \return     bool_t              True on success / False on failure
+    //!
+    bool_t sendMessage(
+            cuint8_t *message_p,
+            cuint8_t size_p
+    );
+
+    //!
+    //! \brief      Switches off every sounding note
+    //! \details    Sends one Note Off message for each note that is sounding,
+    //!                 from the oldest to the newest, on every channel.
+    //!
+    void panic(
+            void
+    );
+
+    //!
+    //! \brief      Switches off the sounding notes of a channel
+    //! \details    Sends one Note Off message for each note that is sounding
+    //!                 on the channel.
+    //! \param      channel_p           MIDI channel (0 to 15)
+    //!
+    void releaseChannel(
+            cuint8_t channel_p
+    );
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+
+    //!
+    //! \brief      Checks if a note is sounding
+    //! \details    Checks if a note is sounding.
+    //! \param      channel_p           MIDI channel (0 to 15)
+    //! \param      pitch_p             MIDI note number (0 to 127)
+    //! \return     bool_t              True if sounding / False otherwise
+    //!
+    bool_t inlined isSounding(
+            cuint8_t channel_p,
+            cuint8_t pitch_p
+    );
+
+    //!
+    //! \brief      Copies the sounding notes of a channel
+    //! \details    Copies the 16-byte bitmap of the sounding notes of a
+    //!                 channel: bit (pitch % 8) of byte (pitch / 8) is set
+    //!                 while the note sounds.
+    //! \param      channel_p           MIDI channel (0 to 15)
+    //! \param      bitmap_p            Pointer to a 16-byte vector
+    //!
+    void getActiveNotes(
+            cuint8_t channel_p,
+            uint8_t *bitmap_p
+    );
+
+    //!
+    //! \brief      Returns the number of sounding notes
+    //! \details    Returns the number of sounding notes.
+    //! \return     uint8_t             Number of voices in use
+    //!
+    uint8_t inlined getVoiceCount(
+            void
+    );
+
+    //!
+    //! \brief      Returns the number of stolen voices
+    //! \details    Returns the number of notes switched off to respect the
+    //!                 polyphony cap. The counter saturates at 0xFFFF.
+    //! \return     uint16_t            Stolen voices
+    //!
+    uint16_t getStolenCount(
+            void
+    );
+
+    //!
+    //! \brief      Clears the counters
+    //! \details    Clears the stolen voices counter.
+    //!
+    void clearCounters(
+            void
+    );
+
+    //!
+    //! \brief      Returns the last error
+    //! \details    Returns the last error.
+    //! \return     Error               Error status of the last operation
+    //!
+    Error getLastError(
+            void
+    );
+
+private:
+    //     ////////////////////    VOICE TABLE     //////////////////////     //
+    void _addVoice(
+            cuint8_t channel_p,
+            cuint8_t pitch_p
+    );
+
+    bool_t _removeVoice(
+            cuint8_t channel_p,
+            cuint8_t pitch_p
+    );
+
+    void _releaseVoice(
+            cuint8_t index_p
+    );
+
+protected:
+    // NONE
+
+    // -------------------------------------------------------------------------
+    // Properties --------------------------------------------------------------
+private:
+    //     ////////////////////    VOICE TABLE     //////////////////////     //
+    uint8_t             _activeNotes[16][16];
+    uint8_t             _voiceChannel[VOICE_TRACKER_VOICES];
+    uint8_t             _voicePitch[VOICE_TRACKER_VOICES];
+    uint8_t             _voiceCount;
+    uint8_t             _polyphony;
+
+    //     /////////////////     CONTROL AND STATUS     /////////////////     //
+    uint16_t            _stolenCount;
+    Error               _lastError;
+}; // class VoiceTracker
+
+// =============================================================================
+// VoiceTracker - Class inline function definitions
+// =============================================================================
+
+bool_t inlined VoiceTracker::isSounding(cuint8_t channel_p, cuint8_t pitch_p)
+{
+    return isBitSet(this->_activeNotes[channel_p & 0x0F][(pitch_p & 0x7F) >> 3], pitch_p & 0x07);
+}
+
+uint8_t inlined VoiceTracker::getVoiceCount(void)
+{
+    return this->_voiceCount;
+}
+
+// =============================================================================
+// External global variables
+// =============================================================================
+
+//!
+//! \brief          Voice tracker handler object
+//! \details        Voice tracker handler object
+//!
+extern VoiceTracker voiceTracker;
+
+// =============================================================================
+// Include guard (END)
+// =============================================================================
+
+#endif  // __VOICE_TRACKER_HPP
+
+// =============================================================================
+// END OF FILE
+// =============================================================================
@@ -0,0 +1,228 @@
+//!
+//! \file           smfParserTest.cpp
+//! \brief          Host test of the Standard MIDI File parser
+//! \date           2023-06-12
+//! \version        23.04
+//! \copyright      license
+//! \details        Writes a type 0 and a type 1 file, parses them through a
+//!                     file read function (as FatFs does on the target) and
+//!                     checks the merged event order, the times in ms and
+//!                     the amount of data read from storage. A file given on
+//!                     the command line, e.g. copied out of a FAT image with
+//!                     "mcopy -i image.img ::SONG.MID song.mid", is dumped.
+//!                     Built and run by "make -C test".
+//!
+
+#include "../midi/smfParser.hpp"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+typedef std::vector<uint8_t> Bytes;
+
+static uint32_t bytesRead = 0;
+static int failures = 0;
+
+#define check(condition) do {                                       \
+        if(!(condition)) {                                          \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            failures++;                                             \
+        }                                                           \
+    } while(0)
+
+static uint16_t fileRead(void *file_p, cuint32_t offset_p, uint8_t *buffer_p, cuint16_t size_p)
+{
+    if(fseek((FILE *)file_p, (long)offset_p, SEEK_SET) != 0) {
+        return 0;
+    }
+    size_t n = fread(buffer_p, 1, size_p, (FILE *)file_p);
+    bytesRead += (uint32_t)n;
+    return (uint16_t)n;
+}
+
+static void put32(Bytes &b, uint32_t v)
+{
+    for(int i = 3; i >= 0; i--) {
+        b.push_back((uint8_t)(v >> (8 * i)));
+    }
+}
+
+static void addChunk(Bytes &file, uint32_t id, const Bytes &data)
+{
+    put32(file, id);
+    put32(file, (uint32_t)data.size());
+    file.insert(file.end(), data.begin(), data.end());
+}
+
+static Bytes header(uint8_t format, uint8_t tracks, uint16_t division)
+{
+    Bytes file;
+    addChunk(file, 0x4D546864, Bytes {0, format, 0, tracks, (uint8_t)(division >> 8), (uint8_t)division});
+    return file;
+}
+
+static FILE *writeFile(const Bytes &file)
+{
+    FILE *f = tmpfile();
+    fwrite(file.data(), 1, file.size(), f);
+    return f;
+}
+
+typedef struct {
+    uint32_t time;
+    uint8_t data[3];
+    uint8_t size;
+} Expected;
+
+static void checkEvents(SmfParser &parser, const Expected *expected, size_t count)
+{
+    SmfEvent event;
+    size_t i = 0;
+
+    while(parser.getNextEvent(&event)) {
+        if(i < count) {
+            check(event.time == expected[i].time);
+            check(event.size == expected[i].size);
+            check(memcmp(event.data, expected[i].data, event.size) == 0);
+            if(event.time != expected[i].time) {
+                printf("  event %zu: time %u, expected %u\n", i, (unsigned)event.time, (unsigned)expected[i].time);
+            }
+        }
+        i++;
+    }
+    check(parser.getLastError() == Error::NONE);
+    check(parser.isFinished());
+    check(i == count);
+}
+
+static void testType0(void)
+{
+    // 96 ticks per quarter note, 120 BPM, then 240 BPM
+    Bytes file = header(0, 1, 96);
+    addChunk(file, 0x4D54726B, Bytes {
+        0x00, 0x90, 0x3C, 0x64,
+        0x60, 0x80, 0x3C, 0x00,
+        0x00, 0xFF, 0x51, 0x03, 0x03, 0xD0, 0x90,
+        0x00, 0x90, 0x3E, 0x64,
+        0x60, 0x3E, 0x00,                           // Running status
+        0x00, 0xFF, 0x2F, 0x00
+    });
+    const Expected expected[] = {
+        {0,   {0x90, 0x3C, 0x64}, 3},
+        {500, {0x80, 0x3C, 0x00}, 3},
+        {500, {0x90, 0x3E, 0x64}, 3},
+        {750, {0x90, 0x3E, 0x00}, 3},
+    };
+    FILE *f = writeFile(file);
+    SmfParser parser;
+
+    check(parser.open(fileRead, f));
+    check(parser.getFormat() == 0);
+    check(parser.getTrackCount() == 1);
+    checkEvents(parser, expected, sizeof(expected) / sizeof(expected[0]));
+    fclose(f);
+}
+
+static void testType1(void)
+{
+    // Conductor track and two note tracks, merged by time
+    Bytes file = header(1, 3, 96);
+    addChunk(file, 0x4D54726B, Bytes {
+        0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20,
+        0x00, 0xFF, 0x2F, 0x00
+    });
+    addChunk(file, 0x4D54726B, Bytes {
+        0x00, 0xC0, 0x05,
+        0x30, 0x90, 0x40, 0x64,
+        0x30, 0x80, 0x40, 0x00,
+        0x00, 0xFF, 0x2F, 0x00
+    });
+    addChunk(file, 0x4D54726B, Bytes {
+        0x18, 0x91, 0x43, 0x64,
+        0x48, 0x81, 0x43, 0x00,
+        0x00, 0xFF, 0x2F, 0x00
+    });
+    const Expected expected[] = {
+        {0,   {0xC0, 0x05}, 2},
+        {125, {0x91, 0x43, 0x64}, 3},
+        {250, {0x90, 0x40, 0x64}, 3},
+        {500, {0x80, 0x40, 0x00}, 3},               // Same time: track order
+        {500, {0x81, 0x43, 0x00}, 3},
+    };
+    FILE *f = writeFile(file);
+    SmfParser parser;
+
+    check(parser.open(fileRead, f));
+    check(parser.getFormat() == 1);
+    check(parser.getTrackCount() == 3);
+    checkEvents(parser, expected, sizeof(expected) / sizeof(expected[0]));
+    fclose(f);
+}
+
+static void testInterleavedTracksReadOnce(void)
+{
+    // Four long tracks with interleaved events; each track keeps its own
+    // cache line, so the file is read about once
+    cuint8_t tracks = 4;
+    Bytes file = header(1, tracks, 96);
+    for(uint8_t t = 0; t < tracks; t++) {
+        Bytes data;
+        for(uint8_t n = 0; n < 100; n++) {
+            data.insert(data.end(), {(uint8_t)((n == 0) ? t : tracks), (uint8_t)(0x90 | t), n, 0x40});
+        }
+        data.insert(data.end(), {0x00, 0xFF, 0x2F, 0x00});
+        addChunk(file, 0x4D54726B, data);
+    }
+    FILE *f = writeFile(file);
+    SmfParser parser;
+    SmfEvent event;
+    uint32_t lastTime = 0;
+    uint16_t count = 0;
+
+    bytesRead = 0;
+    check(parser.open(fileRead, f));
+    while(parser.getNextEvent(&event)) {
+        check(event.time >= lastTime);
+        check((event.data[0] & 0x0F) == (count % tracks));
+        lastTime = event.time;
+        count++;
+    }
+    check(count == 400);
+    check(bytesRead <= 2 * file.size());
+    printf("interleaved: %u bytes read for a %u bytes file\n", (unsigned)bytesRead, (unsigned)file.size());
+    fclose(f);
+}
+
+static int dumpFile(const char *path_p)
+{
+    FILE *f = fopen(path_p, "rb");
+    SmfParser parser;
+    SmfEvent event;
+
+    if(!f || !parser.open(fileRead, f)) {
+        printf("%s: cannot parse\n", path_p);
+        return 1;
+    }
+    printf("format %u, %u tracks\n", parser.getFormat(), parser.getTrackCount());
+    while(parser.getNextEvent(&event)) {
+        printf("%8u ms:", (unsigned)event.time);
+        for(uint8_t i = 0; i < event.size; i++) {
+            printf(" %02X", event.data[i]);
+        }
+        printf("\n");
+    }
+    fclose(f);
+    return parser.isFinished() ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    if(argc > 1) {
+        return dumpFile(argv[1]);
+    }
+    testType0();
+    testType1();
+    testInterleavedTracksReadOnce();
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}